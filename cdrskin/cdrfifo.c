@@ -14,6 +14,24 @@
    cc -g -o cdrfifo -DCdrfifo_standalonE cdrfifo.c
 */
 
+/* ts C61019
+   On Linux the readiness of the fds of all chained fifos is watched by a
+   single epoll(7) set rather than by select(2), which cannot handle fds
+   above FD_SETSIZE. If a fifo is empty while its destination is a pipe,
+   then the data get moved from source to destination by splice(2) without
+   passing through the userspace buffer.
+*/
+#ifdef __linux__
+#define Cdrfifo_use_epolL 1
+#define Cdrfifo_use_splicE 1
+#endif
+
+#ifdef Cdrfifo_use_splicE
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#endif /* Cdrfifo_use_splicE */
+
 #include <stdio.h>
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -24,6 +42,11 @@
 #include <errno.h>
 #include <sys/time.h>
 #include <sys/select.h>
+#include <poll.h>
+
+#ifdef Cdrfifo_use_epolL
+#include <sys/epoll.h>
+#endif
 
 #ifndef Cdrfifo_standalonE
 /* for burn_os_alloc_buffer() */
@@ -43,6 +66,17 @@
 /** Number of follow-up fd pairs */
 #define Cdrfifo_ffd_maX 100
 
+/** Number of epoll events to be inquired by one epoll_wait() */
+#define Cdrfifo_epoll_evmaX 64
+
+/** Maximum number of bytes to be moved by a single splice() */
+#define Cdrfifo_splice_chunK 65536
+
+/* ts A91115
+   This chunksize must be aligned to filesystem blocksize.
+ */
+#define Cdrfifo_o_direct_chunK 32768
+
 
 /* 1= enable , 0= disable status messages to stderr
    2= report each 
@@ -118,6 +152,39 @@ struct CdrfifO {
 
  /* rank in peer chain */
  int chain_idx;
+
+ /* readiness of source_fd and dest_fd as wanted by Cdrfifo_setup_try()
+    and as reported by the wait engine to Cdrfifo_transact() */
+ int want_in;
+ int want_out;
+ int can_in;
+ int can_out;
+
+#ifdef Cdrfifo_use_epolL
+ /* epoll set of the peer chain. Only used in the first chain member.
+    -1= not yet created , -2= epoll is not available, use select() */
+ int epoll_fd;
+
+ /* epoll set which holds the registrations of this fifo */
+ int ep_set_fd;
+ /* registered fds, 0= source , 1= dest */
+ int ep_fds[2];
+ /* registered events, 0= none , -1= fd cannot be polled (e.g. a regular
+    file) and is regarded as always ready, like select() does */
+ int ep_events[2];
+#endif /* Cdrfifo_use_epolL */
+
+#ifdef Cdrfifo_use_splicE
+ /* fd which was last checked for being a pipe, and the check result */
+ int splice_checked_fd;
+ int splice_dest_is_pipe;
+ /* splice() failed with the current fds. Copy through the buffer. */
+ int splice_failed;
+ /* Cdrfifo_setup_try() decided that splice() may be used */
+ int splice_now;
+ /* number of bytes which did not pass through the buffer */
+ double splice_counter;
+#endif /* Cdrfifo_use_splicE */
 };
 
 
@@ -184,9 +251,26 @@ int Cdrfifo_new(struct CdrfifO **ff, int source_fd, int dest_fd,
  o->o_direct_was_short= 0;
  o->next= o->prev= NULL;
  o->chain_idx= 0;
+ o->want_in= o->want_out= o->can_in= o->can_out= 0;
+
+#ifdef Cdrfifo_use_epolL
+ o->epoll_fd= -1;
+ o->ep_set_fd= -1;
+ o->ep_fds[0]= o->ep_fds[1]= -1;
+ o->ep_events[0]= o->ep_events[1]= 0;
+#endif
+
+#ifdef Cdrfifo_use_splicE
+ o->splice_checked_fd= -1;
+ o->splice_dest_is_pipe= 0;
+ o->splice_failed= 0;
+ o->splice_now= 0;
+ o->splice_counter= 0.0;
+#endif
 
 #ifdef Libburn_has_open_trac_srC
- o->buffer= burn_os_alloc_buffer((size_t) buffer_size, 0);
+ /* ts C61019 : No zero-fill, transparent huge pages if large enough */
+ o->buffer= burn_os_alloc_buffer((size_t) buffer_size, 1 | 2);
 #else
  o->buffer= TSOB_FELD(char,buffer_size);
 #endif /* ! Libburn_has_open_trac_srC */
@@ -200,13 +284,110 @@ failed:;
 }
 
 
+/* Remove fd from the epoll set of the fifo and forget its registration.
+   To be called before the fd gets closed or replaced.
+   @param flag bit0= forget all registrations of the fifo
+               bit1= do not remove from epoll set (it gets closed anyway)
+*/
+static int Cdrfifo_ep_forget(struct CdrfifO *o, int fd, int flag)
+{
+#ifdef Cdrfifo_use_epolL
+ struct epoll_event ev;
+ int i;
+
+ for(i= 0; i<2; i++) {
+   if(o->ep_fds[i]<0 || (o->ep_fds[i]!=fd && !(flag&1)))
+ continue;
+   if(o->ep_events[i]>0 && o->ep_set_fd>=0 && !(flag&2)) {
+     memset(&ev,0,sizeof(ev));
+     epoll_ctl(o->ep_set_fd,EPOLL_CTL_DEL,o->ep_fds[i],&ev);
+   }
+   o->ep_fds[i]= -1;
+   o->ep_events[i]= 0;
+ }
+#endif /* Cdrfifo_use_epolL */
+
+ return(1);
+}
+
+
+#ifdef Cdrfifo_use_epolL
+
+/* Bring the registration of source fd (idx 0) or dest fd (idx 1) in the
+   epoll set epfd up to date.
+   @param events EPOLLIN, EPOLLOUT, or 0 if the fd shall not be watched
+   @return 0= registered as desired
+           1= fd cannot be watched by epoll and shall be regarded as ready
+*/
+static int Cdrfifo_ep_register(struct CdrfifO *o, int epfd, int idx,
+                               int fd, int events, int flag)
+{
+ struct epoll_event ev;
+ int ret= 0, op;
+
+ if(o->ep_set_fd!=epfd) {
+   Cdrfifo_ep_forget(o,-1,1|2);
+   o->ep_set_fd= epfd;
+ }
+ if(fd<0)
+   events= 0;
+ if(o->ep_fds[idx]!=fd) {
+   Cdrfifo_ep_forget(o,o->ep_fds[idx],0);
+   o->ep_fds[idx]= fd;
+   o->ep_events[idx]= 0;
+ }
+ if(o->ep_events[idx]==-1)
+   return(events!=0);
+ if(o->ep_events[idx]==events)
+   return(0);
+
+ memset(&ev,0,sizeof(ev));
+ ev.events= events;
+ ev.data.fd= fd;
+ if(events==0) {
+   epoll_ctl(epfd,EPOLL_CTL_DEL,fd,&ev);
+ } else {
+   op= (o->ep_events[idx]==0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD);
+   ret= epoll_ctl(epfd,op,fd,&ev);
+   if(ret==-1 && (errno==EEXIST || errno==ENOENT)) {
+     op= (op==EPOLL_CTL_ADD ? EPOLL_CTL_MOD : EPOLL_CTL_ADD);
+     ret= epoll_ctl(epfd,op,fd,&ev);
+   }
+   if(ret==-1) {
+     if(errno==EPERM) {
+       /* Regular files and block devices are always ready */
+       o->ep_events[idx]= -1;
+     } else {
+       /* Let the i/o call find out what is wrong with fd */
+       o->ep_events[idx]= 0;
+     }
+     return(1);
+   }
+ }
+ o->ep_events[idx]= events;
+ return(0);
+}
+
+#endif /* Cdrfifo_use_epolL */
+
+
+/* Close the current destination fd */
+static int Cdrfifo_close_dest(struct CdrfifO *o, int flag)
+{
+ if(o->dest_fd==-1)
+   return(0);
+ Cdrfifo_ep_forget(o,o->dest_fd,0);
+ close(o->dest_fd);
+ return(1);
+}
+
+
 /** Close any output fds */
 int Cdrfifo_close(struct CdrfifO *o, int flag)
 {
  int i;
 
- if(o->dest_fd!=-1)
-   close(o->dest_fd);
+ Cdrfifo_close_dest(o,0);
  o->dest_fd= -1;
  for(i=0; i<o->follow_up_fd_counter; i++) {
    if(o->follow_up_fds[i][1]!=-1)
@@ -232,6 +413,22 @@ int Cdrfifo_destroy(struct CdrfifO **ff, int flag)
  o= *ff;
  if(o==NULL)
    return(0);
+
+#ifdef Cdrfifo_use_epolL
+ if(o->epoll_fd>=0) {
+   struct CdrfifO *peer;
+
+   /* The chain's epoll set vanishes. Chain members will register anew. */
+   for(peer= o; peer->prev!=NULL; peer= peer->prev);
+   for(; peer!=NULL; peer= peer->next)
+     if(peer->ep_set_fd==o->epoll_fd)
+       Cdrfifo_ep_forget(peer,-1,1|2);
+   close(o->epoll_fd);
+   o->epoll_fd= -1;
+ } else
+   Cdrfifo_ep_forget(o,-1,1);
+#endif /* Cdrfifo_use_epolL */
+
  if(o->next!=NULL)
    o->next->prev= o->prev;
  if(o->prev!=NULL)
@@ -301,6 +498,12 @@ int Cdrfifo_set_fd_in_limit(struct CdrfifO *o, double fd_in_limit, int idx,
 
 int Cdrfifo_set_fds(struct CdrfifO *o, int source_fd, int dest_fd, int flag)
 {
+ Cdrfifo_ep_forget(o,-1,1);
+
+#ifdef Cdrfifo_use_splicE
+ o->splice_failed= 0;
+#endif
+
  o->source_fd= source_fd;
  o->dest_fd= dest_fd;
  return(1);
@@ -498,11 +701,116 @@ int Cdrfifo_eop_adjust(struct CdrfifO *o,int *buffer_fill, int *eop_idx,
 }
 
 
-/* Perform pre-select activities of Cdrfifo_try_to_work() */
+#ifdef Cdrfifo_use_splicE
+
+/* Number of bytes which may be moved by the next splice() */
+static int Cdrfifo_splice_len(struct CdrfifO *o, int flag)
+{
+ double len;
+
+ len= Cdrfifo_splice_chunK;
+ if(o->fd_in_limit>=0.0)
+   if(len > o->fd_in_limit - o->fd_in_counter)
+     len= o->fd_in_limit - o->fd_in_counter;
+
+#ifdef Libburn_has_open_trac_srC
+ /* The source may be opened with O_DIRECT */
+ len-= ((int) len) % Cdrfifo_o_direct_chunK;
+#endif
+
+ return((int) len);
+}
+
+
+/* Decide whether the next data may bypass the buffer.
+   This is the case if the buffer is empty and the destination is a pipe.
+   Follow-up fds are not supported, because their boundaries are marked by
+   buffer positions.
+   @param flag bit1, bit2 as with Cdrfifo_try_to_work() prevent splicing
+   @return 1= splice() may be used , 0= copy through the buffer
+*/
+static int Cdrfifo_may_splice(struct CdrfifO *o, int flag)
+{
+ struct stat stbuf;
+
+ if(flag&(2|4))
+   return(0);
+ if(o->splice_failed || o->source_fd<0 || o->dest_fd<0 ||
+    o->follow_up_fd_counter>0)
+   return(0);
+ if(Cdrfifo_tell_buffer_space(o,0)<o->buffer_size)
+   return(0);
+ if(Cdrfifo_splice_len(o,0)<=0)
+   return(0);
+ if(o->splice_checked_fd!=o->dest_fd) {
+   o->splice_checked_fd= o->dest_fd;
+   o->splice_dest_is_pipe= 0;
+   if(fstat(o->dest_fd,&stbuf)!=-1)
+     o->splice_dest_is_pipe= !!S_ISFIFO(stbuf.st_mode);
+ }
+ return(o->splice_dest_is_pipe);
+}
+
+
+/* Move data from source fd to destination fd without buffering.
+   vmsplice() is not used on the buffer, because the pipe would hold
+   references to buffer pages which get refilled soon after.
+   @return <0 = error , 0 = nothing moved , 1 = did some work
+*/
+static int Cdrfifo_splice(struct CdrfifO *o, int flag)
+{
+ ssize_t ret;
+ int len;
+
+ len= Cdrfifo_splice_len(o,0);
+ if(len<=0)
+   return(0);
+ ret= splice(o->source_fd,NULL,o->dest_fd,NULL,(size_t) len,
+             SPLICE_F_MOVE|SPLICE_F_NONBLOCK);
+ if(ret==-1) {
+   if(errno==EAGAIN || errno==EINTR)
+     return(0);
+   if(errno==EPIPE) {
+     fprintf(stderr,"\ncdrfifo %d: on splice: errno=%d , \"%s\"\n",
+                    o->chain_idx,errno,strerror(errno));
+     Cdrfifo_close_dest(o,0);
+     o->dest_fd= -1;
+     return(-1);
+   }
+   /* E.g. EINVAL: the fds do not support splice(). Copy via the buffer. */
+   if(Cdrfifo_debuG || (flag&1))
+     fprintf(stderr,"\ncdrfifo %d: splice() fails: errno=%d , \"%s\"\n",
+                    o->chain_idx,errno,strerror(errno));
+   o->splice_failed= 1;
+   return(0);
+ }
+ if(ret==0) /* eof. The copy path will notice it too. */
+   return(0);
+
+#ifdef Libburn_has_open_trac_srC
+ o->o_direct_was_short= (ret<len);
+#endif
+
+ o->put_counter++;
+ o->get_counter++;
+ o->in_counter+= ret;
+ o->fd_in_counter+= ret;
+ o->out_counter+= ret;
+ o->splice_counter+= ret;
+ return(1);
+}
+
+#endif /* Cdrfifo_use_splicE */
+
+
+/* Perform pre-select activities of Cdrfifo_try_to_work().
+   The wanted readiness of the fds gets recorded in o->want_in and
+   o->want_out.
+*/
 static int Cdrfifo_setup_try(struct CdrfifO *o, struct timeval start_tv,
                              double start_out_counter, int *still_to_wait,
                              int *speed_limiter, int *ready_to_write,
-                             fd_set *rds, fd_set *wts, int *max_fd, int flag)
+                             int flag)
 /* flag:
  bit0= enable debug pacifier (same with Cdrfifo_debuG)
  bit1= do not write, just fill buffer
@@ -517,6 +825,12 @@ static int Cdrfifo_setup_try(struct CdrfifO *o, struct timeval start_tv,
  struct timezone tz;
  double diff_time,diff_counter,limit,min_wait_time;
 
+ o->want_in= o->want_out= 0;
+
+#ifdef Cdrfifo_use_splicE
+ o->splice_now= 0;
+#endif
+
 setup_try:;
  buffer_space= Cdrfifo_tell_buffer_space(o,0);
  fd_buffer_fill= buffer_fill= o->buffer_size - buffer_space;
@@ -533,7 +847,7 @@ setup_try:;
  if(fd_buffer_fill<=0 && (o->source_fd==-1 || eop_reached>=0) ) { 
    was_closed= 0;
    if(o->dest_fd!=-1 && !(flag&4))
-     close(o->dest_fd);
+     Cdrfifo_close_dest(o,0);
    if(o->dest_fd<0)
      was_closed= 1;
    else
@@ -557,6 +871,13 @@ setup_try:;
             "\ncdrfifo %d:  w=%d r=%d | b=%d s=%d | i=%.f o=%.f (done)\n",
             o->chain_idx,o->write_idx,o->read_idx,buffer_fill,buffer_space,
             o->in_counter,o->out_counter);
+
+#ifdef Cdrfifo_use_splicE
+     if((!was_closed) && ((flag&1)||Cdrfifo_debuG) && o->splice_counter>0)
+       fprintf(stderr,"cdrfifo %d:  %.f bytes moved by splice()\n",
+               o->chain_idx,o->splice_counter);
+#endif
+
      return(2);
    }
  } else if(eop_reached>=0)
@@ -601,11 +922,9 @@ setup_try:;
      }
  }
  if(o->source_fd>=0) {
-   if(buffer_space>0) {
-     FD_SET((o->source_fd),rds);
-     if(*max_fd<o->source_fd)
-       *max_fd= o->source_fd;
-   } else if(o->interval_counter>0)
+   if(buffer_space>0)
+     o->want_in= 1;
+   else if(o->interval_counter>0)
      o->full_counter++;
  }
  *ready_to_write= 0;
@@ -614,20 +933,25 @@ setup_try:;
      if((flag&(4|8))==(4|8)) {
        *still_to_wait= 0;
        *ready_to_write= 1;
-     } else {
-       FD_SET((o->dest_fd),wts);
-       if(*max_fd<o->dest_fd)
-         *max_fd= o->dest_fd;
-     }
+     } else
+       o->want_out= 1;
    } else if(o->interval_counter>0)
      o->empty_counter++;
  }
+
+#ifdef Cdrfifo_use_splicE
+ o->splice_now= (o->want_in && !*speed_limiter &&
+                 Cdrfifo_may_splice(o,flag));
+#endif
+
  return(1);
 }
 
 
-/* Perform post-select activities of Cdrfifo_try_to_work() */
-static int Cdrfifo_transact(struct CdrfifO *o, fd_set *rds, fd_set *wts,
+/* Perform post-select activities of Cdrfifo_try_to_work().
+   The readiness of the fds is given by o->can_in and o->can_out.
+*/
+static int Cdrfifo_transact(struct CdrfifO *o,
                             char *reply_buffer, int *reply_count, int flag)
 /* flag:
  bit0= enable debug pacifier (same with Cdrfifo_debuG)
@@ -642,7 +966,20 @@ return: <0 = error , 0 = idle , 1 = did some work
  int can_read,can_write= 0,ret,did_work= 0,idx,sod, eop_idx;
 
  buffer_space= Cdrfifo_tell_buffer_space(o,0);
- if(o->dest_fd>=0) if(FD_ISSET((o->dest_fd),wts)) {
+
+#ifdef Cdrfifo_use_splicE
+ /* Waiting for a writable pipe would spin while the source is idle.
+    So splice() tries without blocking and the data get buffered if the
+    pipe is full.
+ */
+ if(o->can_in && o->splice_now) {
+   ret= Cdrfifo_splice(o,flag);
+   if(ret!=0)
+     goto ex;
+ }
+#endif /* Cdrfifo_use_splicE */
+
+ if(o->dest_fd>=0 && o->can_out && buffer_space<o->buffer_size) {
    can_write= o->buffer_size - buffer_space;
    if(can_write>o->chunk_size)
      can_write= o->chunk_size;
@@ -667,7 +1004,7 @@ return: <0 = error , 0 = idle , 1 = did some work
                     errno==0?"-no error code available-":strerror(errno));
 
      if(!(flag&4))
-       close(o->dest_fd);
+       Cdrfifo_close_dest(o,0);
      o->dest_fd= -1;
      {ret= -1; goto ex;}
    }
@@ -680,16 +1017,11 @@ return: <0 = error , 0 = idle , 1 = did some work
    o->buffer_is_full= 0;
  }
 after_write:;
- if(o->source_fd>=0) if(FD_ISSET((o->source_fd),rds)) {
+ if(o->source_fd>=0 && o->can_in) {
    can_read= o->buffer_size - o->write_idx;
 
 #ifdef Libburn_has_open_trac_srC
 
-   /* ts A91115
-      This chunksize must be aligned to filesystem blocksize.
-    */
-#define Cdrfifo_o_direct_chunK 32768
-
    if(o->write_idx < o->read_idx && o->write_idx + can_read > o->read_idx)
      can_read= o->read_idx - o->write_idx;
    if(o->fd_in_limit>=0.0)
@@ -715,16 +1047,13 @@ after_write:;
    if(can_read < 0) {
      /* waiting for a full Cdrfifo_o_direct_chunK to fit */
      if(can_write <= 0 && o->dest_fd >= 0) {
-        fd_set rds,wts,exs;
-        struct timeval wt;
+        struct pollfd pfd;
 
-        FD_ZERO(&rds);
-        FD_ZERO(&wts);
-        FD_ZERO(&exs);
-        FD_SET((o->dest_fd),&wts);
-        wt.tv_sec=  0;
-        wt.tv_usec= 10000;
-        select(o->dest_fd + 1,&rds, &wts, &exs, &wt);
+        /* poll() is not restricted to fds below FD_SETSIZE */
+        pfd.fd= o->dest_fd;
+        pfd.events= POLLOUT;
+        pfd.revents= 0;
+        poll(&pfd, 1, 10);
 
      }
    } else
@@ -813,6 +1142,155 @@ ex:;
 }
 
 
+/* Wait by select() until the wanted fds of the fifos are ready.
+   @param flag bit1= only wait for fifo o, not for its successors
+   @return number of ready fds , 0 = timeout , -1 = error
+*/
+static int Cdrfifo_wait_select(struct CdrfifO *o, int wait_usec, int flag)
+{
+ struct timeval wt;
+ fd_set rds,wts,exs;
+ int ready,max_fd= -1;
+ struct CdrfifO *ff;
+
+ FD_ZERO(&rds);
+ FD_ZERO(&wts);
+ FD_ZERO(&exs);
+ for(ff= o; ff!=NULL; ff= ff->next) {
+   ff->can_in= ff->can_out= 0;
+   if(ff->want_in && ff->source_fd>=0) {
+     FD_SET((ff->source_fd),&rds);
+     if(max_fd<ff->source_fd)
+       max_fd= ff->source_fd;
+   }
+   if(ff->want_out && ff->dest_fd>=0) {
+     FD_SET((ff->dest_fd),&wts);
+     if(max_fd<ff->dest_fd)
+       max_fd= ff->dest_fd;
+   }
+   if(flag&2)
+ break;
+ }
+ if(wait_usec<=0 && max_fd<0)
+   return(0);
+ if(wait_usec<0)
+   wait_usec= 0;
+ wt.tv_sec=  wait_usec/1000000;
+ wt.tv_usec= wait_usec%1000000;
+ ready= select(max_fd+1,&rds,&wts,&exs,&wt);
+ if(ready<=0)
+   return(ready);
+ for(ff= o; ff!=NULL; ff= ff->next) {
+   if(ff->source_fd>=0)
+     ff->can_in= !!FD_ISSET((ff->source_fd),&rds);
+   if(ff->dest_fd>=0)
+     ff->can_out= !!FD_ISSET((ff->dest_fd),&wts);
+   if(flag&2)
+ break;
+ }
+ return(ready);
+}
+
+
+#ifdef Cdrfifo_use_epolL
+
+/* Wait by epoll_wait() until the wanted fds of the fifos are ready.
+   All fifos of the peer chain share the epoll set of the first member.
+   @param flag bit1= only wait for fifo o, not for its successors
+   @return number of ready fds , 0 = timeout , -1 = error ,
+           -2 = epoll is not available
+*/
+static int Cdrfifo_wait_epoll(struct CdrfifO *o, int wait_usec, int flag)
+{
+ struct epoll_event evs[Cdrfifo_epoll_evmaX];
+ struct CdrfifO *head,*ff;
+ int epfd,ret,i,fd,timeout,in_range= 0,always_ready= 0,wanted= 0;
+ int want_in,want_out;
+
+ for(head= o; head->prev!=NULL; head= head->prev);
+ if(head->epoll_fd==-1) {
+   head->epoll_fd= epoll_create(Cdrfifo_epoll_evmaX);
+   if(head->epoll_fd==-1) {
+     if(Cdrfifo_debuG)
+       fprintf(stderr,"\ncdrfifo %d: epoll_create() fails: errno=%d\n",
+                      head->chain_idx,errno);
+     head->epoll_fd= -2;
+   } else
+     fcntl(head->epoll_fd,F_SETFD,FD_CLOEXEC);
+ }
+ if(head->epoll_fd<0)
+   return(-2);
+ epfd= head->epoll_fd;
+
+ /* Fifos outside the range of this call shall not cause wakeups */
+ for(ff= head; ff!=NULL; ff= ff->next) {
+   if(ff==o)
+     in_range= 1;
+   ff->can_in= ff->can_out= 0;
+   want_in= in_range && ff->want_in;
+   want_out= in_range && ff->want_out;
+   if(Cdrfifo_ep_register(ff,epfd,0,ff->source_fd,want_in ? EPOLLIN : 0,0)) {
+     ff->can_in= 1;
+     always_ready++;
+   }
+   if(Cdrfifo_ep_register(ff,epfd,1,ff->dest_fd,want_out ? EPOLLOUT : 0,0)) {
+     ff->can_out= 1;
+     always_ready++;
+   }
+   if(want_in || want_out)
+     wanted= 1;
+   if(ff==o && (flag&2))
+     in_range= 0;
+ }
+ if(always_ready)
+   timeout= 0;
+ else if(wait_usec<=0) {
+   if(!wanted)
+     return(0);
+   timeout= 0;
+ } else
+   timeout= (wait_usec+999)/1000;
+ ret= epoll_wait(epfd,evs,Cdrfifo_epoll_evmaX,timeout);
+ if(ret<0) {
+   if(errno!=EINTR && !always_ready)
+     return(-1);
+   ret= 0;
+ }
+ for(i= 0; i<ret; i++) {
+   /* EPOLLHUP and EPOLLERR count as readiness. The i/o call will tell. */
+   fd= evs[i].data.fd;
+   for(ff= head; ff!=NULL; ff= ff->next) {
+     if(ff->ep_fds[0]==fd && ff->ep_events[0]>0)
+       ff->can_in= 1;
+     if(ff->ep_fds[1]==fd && ff->ep_events[1]>0)
+       ff->can_out= 1;
+   }
+ }
+ return(ret+always_ready);
+}
+
+#endif /* Cdrfifo_use_epolL */
+
+
+/* Wait until the wanted fds of the fifos are ready and record the readiness
+   in ->can_in and ->can_out of the fifos.
+   @param flag bit1= only wait for fifo o, not for its successors
+   @return number of ready fds , 0 = timeout , -1 = error
+*/
+static int Cdrfifo_wait(struct CdrfifO *o, int wait_usec, int flag)
+{
+#ifdef Cdrfifo_use_epolL
+ int ret;
+
+ ret= Cdrfifo_wait_epoll(o,wait_usec,flag&2);
+ if(ret!=-2)
+   return(ret);
+#endif
+
+ return(Cdrfifo_wait_select(o,wait_usec,flag&2));
+}
+
+
 /** Check for pending data at the fifo's source file descriptor and wether the
     fifo is ready to take them. Simultaneously check the buffer for existing
     data and the destination fd for readiness to accept some. If so, a small
@@ -840,10 +1318,9 @@ ex:;
 int Cdrfifo_try_to_work(struct CdrfifO *o, int wait_usec, 
                         char *reply_buffer, int *reply_count, int flag)
 {
- struct timeval wt,start_tv,current_tv;
+ struct timeval start_tv,current_tv;
  struct timezone tz;
- fd_set rds,wts,exs;
- int ready,ret,max_fd= -1,buffer_space,dummy,still_active= 0;
+ int ready,ret,buffer_space,dummy,still_active= 0;
  int did_work= 0,elapsed,still_to_wait,speed_limiter= 0,ready_to_write= 0;
  double start_out_counter;
  struct CdrfifO *ff;
@@ -861,14 +1338,11 @@ try_again:;
  break;
  if(ff==NULL)
    return(2);
- FD_ZERO(&rds);
- FD_ZERO(&wts);
- FD_ZERO(&exs);
 
  for(ff= o; ff!=NULL; ff= ff->next) {
    ret= Cdrfifo_setup_try(ff,start_tv,start_out_counter,
                           &still_to_wait,&speed_limiter,&ready_to_write,
-                          &rds,&wts,&max_fd,flag&15);
+                          flag&15);
    if(ret<=0)
      return(ret);
    else if(ret==2) {
@@ -881,22 +1355,18 @@ try_again:;
  if(!still_active)
    return(2);
 
- if(still_to_wait>0 || max_fd>=0) {
-   wt.tv_sec=  still_to_wait/1000000;
-   wt.tv_usec= still_to_wait%1000000;
-   ready= select(max_fd+1,&rds,&wts,&exs,&wt);
- } else
-   ready= 0;
+ ready= Cdrfifo_wait(o,still_to_wait,flag&2);
  if(ready<=0) {
    if(!ready_to_write)
      goto check_wether_done;
-   FD_ZERO(&rds);
+   for(ff= o; ff!=NULL; ff= ff->next)
+     ff->can_in= ff->can_out= 0;
  }
  if(ready_to_write)
-   FD_SET((o->dest_fd),&wts);
+   o->can_out= 1;
 
  for(ff= o; ff!=NULL; ff= ff->next) {
-   ret= Cdrfifo_transact(ff,&rds,&wts,reply_buffer,reply_count,flag&15);
+   ret= Cdrfifo_transact(ff,reply_buffer,reply_count,flag&15);
    if(ret<0)
      goto ex;
    if(ret>0)
@@ -908,6 +908,12 @@ struct CdrtracK {
 
 #ifdef Cdrskin_use_libburn_fifO
  struct burn_source *libburn_fifo;
+
+ /** The track source made by Cdrtrack_prefetch_libburn_fifo() before the
+     drive got grabbed. Normally a libburn fifo which is already filling.
+     Cdrtrack_add_to_session() takes it over.
+ */
+ struct burn_source *libburn_prefetched;
 #endif /* Cdrskin_use_libburn_fifO */
 
 };
@@ -977,6 +983,7 @@ int Cdrtrack_new(struct CdrtracK **track, struct CdrskiN *boss,
  o->libburn_track_is_own= 0;
 #ifdef Cdrskin_use_libburn_fifO
  o->libburn_fifo= NULL;
+ o->libburn_prefetched= NULL;
 #endif /* Cdrskin_use_libburn_fifO */
 
  if(flag & 1)
@@ -1021,6 +1028,11 @@ int Cdrtrack_destroy(struct CdrtracK **o, int flag)
  Cdrfifo_destroy(&(track->fifo),0);
 #endif
 
+#ifdef Cdrskin_use_libburn_fifO
+ if(track->libburn_prefetched != NULL)
+   burn_source_free(track->libburn_prefetched);
+#endif
+
  if(track->libburn_track != NULL && track->libburn_track_is_own)
    burn_track_free(track->libburn_track);
  if(track->iso_fs_descr!=NULL)
@@ -1531,9 +1543,9 @@ int Cdrtrack_fill_libburn_fifo(struct CdrtracK *track, int fifo_start_at,
                                int flag)
 {
  int ret, bs= 32 * 1024;
- int buffer_size, buffer_free;
- double data_image_size;
- char buf[64 * 1024], *buffer_text;
+ int buffer_size, buffer_free, fs_types;
+ off_t image_blocks;
+ char volume_id[33], *buffer_text;
 
  if(fifo_start_at == 0)
    return(2);
@@ -1563,22 +1575,20 @@ int Cdrtrack_fill_libburn_fifo(struct CdrtracK *track, int fifo_start_at,
    }
  }
 
- /* Try to obtain ISO 9660 Volume Descriptors and size from fifo.
-    Not an error if there is no ISO 9660. */
+ /* Obtain ISO 9660 Volume Descriptors and size as sniffed by the fifo
+    while the data passed. Not an error if there is no ISO 9660. */
  if(track->iso_fs_descr != NULL)
    free(track->iso_fs_descr);
- track->iso_fs_descr = NULL;
- if(buffer_size - buffer_free >= 64 * 1024) {
-   ret= burn_fifo_peek_data(track->libburn_fifo, buf, 64 * 1024, 0);
-   if(ret == 1) {
-     track->iso_fs_descr = calloc(1, bs);
-     if(track->iso_fs_descr == NULL)
-       return(-1);
-     memcpy(track->iso_fs_descr, buf + bs, bs);
-     ret= Scan_for_iso_size((unsigned char *) buf + bs, &data_image_size, 0);
-     if(ret > 0)
-       track->data_image_size= data_image_size;
-   }
+ track->iso_fs_descr = calloc(1, bs);
+ if(track->iso_fs_descr == NULL)
+   return(-1);
+ ret= burn_fifo_inquire_iso(track->libburn_fifo, &image_blocks, volume_id,
+                            track->iso_fs_descr, &fs_types, 1);
+ if(ret == 1 && image_blocks > 0) {
+   track->data_image_size= ((double) image_blocks) * 2048.0;
+ } else {
+   free(track->iso_fs_descr);
+   track->iso_fs_descr = NULL;
  }
  return(1);
 }
@@ -1695,6 +1705,86 @@ int Cdrtrack_set_indice(struct CdrtracK *track, int flag)
  return(1);
 }     
 
+#ifdef Cdrskin_use_libburn_fifO
+
+/** Put a libburn fifo on top of the given data source if the fifo is enabled
+    and start it filling. The fill level is awaited later by
+    Cdrtrack_fill_libburn_fifo().
+    @param src  The data source. Gets replaced by the fifo on success.
+    @param flag bit0= debugging verbosity
+    @return <=0 error, 1 fifo installed, 2 no fifo wanted
+*/
+int Cdrtrack_new_libburn_fifo(struct CdrtracK *track,
+                              struct burn_source **src, int flag)
+{
+ int fifo_enabled, fifo_size, fifo_start_at, chunksize, chunks;
+ struct burn_source *fifo;
+ int Cdrskin_get_fifo_par(struct CdrskiN *skin, int *fifo_enabled,
+                          int *fifo_size, int *fifo_start_at, int flag);
+
+ Cdrskin_get_fifo_par(track->boss, &fifo_enabled, &fifo_size, &fifo_start_at,
+                      0);
+
+ if(track->track_type == BURN_AUDIO)
+   chunksize= 2352;
+ else if (track->cdxa_conversion == 1)
+   chunksize= 2056;
+ else
+   chunksize= 2048;
+ chunks= fifo_size / chunksize;
+ if(chunks <= 1 || !fifo_enabled)
+   return(2);
+ fifo= burn_fifo_source_new(*src, chunksize, chunks,
+                            (chunksize * chunks >= 128 * 1024));
+ if((flag & 1) || fifo == NULL)
+   fprintf(stderr, "cdrskin_DEBUG: %s libburn fifo of %d bytes\n",
+           fifo != NULL ? "installed" : "failed to install",
+           chunksize * chunks);
+ if(fifo == NULL)
+   return(0);
+ track->libburn_fifo= fifo;
+ burn_fifo_prefetch(fifo, 0, 0.0, 0);
+
+ /* The fifo holds its own reference to the input source */
+ burn_source_free(*src);
+ *src= fifo;
+ return(1);
+}
+
+
+/** Open the track source and start its libburn fifo, so that the fifo can
+    fill while the drive gets grabbed, inspected and prepared.
+    The fifo is taken over later by Cdrtrack_add_to_session().
+    @param flag bit0= debugging verbosity
+                bit2= permission to use O_DIRECT (if enabled at compile time)
+    @return <=0 error, 1 fifo started, 2 no fifo wanted
+*/
+int Cdrtrack_prefetch_libburn_fifo(struct CdrtracK *track, int flag)
+{
+ int ret, source_fd;
+ struct burn_source *src;
+
+ if(track->libburn_prefetched != NULL || track->fifo != NULL)
+   return(2);
+ if(track->source_fd == -1) {
+   ret= Cdrtrack_open_source_path(track, &source_fd, flag & (4 | 1));
+   if(ret <= 0)
+     return(ret);
+ }
+ src= burn_fd_source_new(track->source_fd, -1, (off_t) track->fixed_size);
+ if(src == NULL)
+   return(-1);
+ ret= Cdrtrack_new_libburn_fifo(track, &src, flag & 1);
+
+ /* Without fifo this is the plain fd source. Freeing it would close
+    track->source_fd. */
+ track->libburn_prefetched= src;
+ return(ret == 1 ? 1 : 2);
+}
+
+#endif /* Cdrskin_use_libburn_fifO */
+
+
 /** Create a corresponding libburn track object and add it to the libburn
     session. This may change the trackno index set by Cdrtrack_new().
 */
@@ -1714,10 +1804,6 @@ int Cdrtrack_add_to_session(struct CdrtracK *track, int trackno,
  double fixed_size;
  int source_fd;
 
-#ifdef Cdrskin_use_libburn_fifO
- struct burn_source *fd_src= NULL;
-#endif
-
  track->trackno= trackno;
  tr= burn_track_create();
  if(tr == NULL)
@@ -1770,42 +1856,25 @@ int Cdrtrack_add_to_session(struct CdrtracK *track, int trackno,
                  track->fixed_size+track->padding));
    fixed_size+= track->padding;
  }
- src= burn_fd_source_new(track->source_fd,-1,(off_t) fixed_size);
 
 #ifdef Cdrskin_use_libburn_fifO
 
- if(src != NULL && track->fifo == NULL) {
-   int fifo_enabled, fifo_size, fifo_start_at, chunksize, chunks;
-   int Cdrskin_get_fifo_par(struct CdrskiN *skin, int *fifo_enabled,
-                            int *fifo_size, int *fifo_start_at, int flag);
+ if(track->libburn_prefetched != NULL) {
+   /* Take over the source which was made before the drive got grabbed */
+   src= track->libburn_prefetched;
+   track->libburn_prefetched= NULL;
+   src->set_size(src, (off_t) fixed_size);
+ } else {
+   src= burn_fd_source_new(track->source_fd,-1,(off_t) fixed_size);
+   if(src != NULL && track->fifo == NULL)
+     Cdrtrack_new_libburn_fifo(track, &src, flag & 1);
+ }
 
-   Cdrskin_get_fifo_par(track->boss, &fifo_enabled, &fifo_size, &fifo_start_at,
-                        0);
+#else /* Cdrskin_use_libburn_fifO */
 
-   if(track->track_type == BURN_AUDIO)
-     chunksize= 2352;
-   else if (track->cdxa_conversion == 1)
-     chunksize= 2056;
-   else
-     chunksize= 2048;
-   chunks= fifo_size / chunksize;
-   if(chunks > 1 && fifo_enabled) {
-     fd_src= src;
-     src= burn_fifo_source_new(fd_src, chunksize, chunks,
-                               (chunksize * chunks >= 128 * 1024));
-     if((flag & 1) || src == NULL)
-       fprintf(stderr, "cdrskin_DEBUG: %s libburn fifo of %d bytes\n",
-               src != NULL ? "installed" : "failed to install",
-               chunksize * chunks);
-     track->libburn_fifo= src;
-     if(src == NULL) {
-       src= fd_src;
-       fd_src= NULL;
-     }
-   }
- }
+ src= burn_fd_source_new(track->source_fd,-1,(off_t) fixed_size);
 
-#endif /* Cdrskin_use_libburn_fifO */
+#endif /* ! Cdrskin_use_libburn_fifO */
 
  if(src==NULL) {
    fprintf(stderr,
@@ -1823,12 +1892,6 @@ int Cdrtrack_add_to_session(struct CdrtracK *track, int trackno,
  burn_session_add_track(session,tr,BURN_POS_END);
  ret= 1;
 ex:
-
-#ifdef Cdrskin_use_libburn_fifO
- if(fd_src!=NULL)
-   burn_source_free(fd_src);
-#endif
-
  if(src!=NULL)
    burn_source_free(src);
  return(ret);
@@ -2929,6 +2992,11 @@ set_dev:;
            "                    pre-gap and how many sectors it shall have\n");
      printf(
           " --single_track     accept only last argument as source_address\n");
+     printf(" speed_autotune=\"on\"|\"off\"|number\n");
+     printf(
+         "                    adapt DVD and BD write speed to the input rate.\n");
+     printf(
+         "                    A number sets the minimum speed like speed=.\n");
      printf(" stream_recording=\"on\"|\"off\"|number\n");
      printf(
          "                    \"on\" requests to prefer speed over write\n");
@@ -3388,6 +3456,8 @@ struct CdrskiN {
  int dummy_mode;
  int force_is_set;
  int stream_recording_is_set; /* see burn_write_opts_set_stream_recording() */
+ double autotune_x_speed;     /* see burn_write_opts_set_speed_autotune():
+                                 -1= off, 0= on, >0 = minimum speed */
  int dvd_obs;                 /* DVD write chunk size: 0, 32k or 64k */
  int obs_pad;                 /* Whether to force obs end padding */
  int stdio_sync;              /* stdio fsync interval: -1, 0, >=32 */
@@ -3629,6 +3699,11 @@ struct CdrskiN {
  int grow_overwriteable_iso;
  /* New image head buffer for --grow_overwriteable_iso */
  char overwriteable_iso_head[32*2048]; /* block  0 to 31 of target */
+ /* Result of Cdrskin_grow_overwriteable_iso() before burn_disc_write():
+    -1= not handed over to libburn, head has to be written after the burn
+     0= failed , 1= handed over to libburn
+ */
+ int iso_head_handed_over;
 
 };
 
@@ -3661,6 +3736,7 @@ int Cdrskin_new(struct CdrskiN **skin, struct CdrpreskiN *preskin, int flag)
  o->dummy_mode= 0;
  o->force_is_set= 0;
  o->stream_recording_is_set= 0;
+ o->autotune_x_speed= -1.0;
  o->dvd_obs= 0;
  o->obs_pad= 0;
  o->stdio_sync= 0;
@@ -3776,6 +3852,7 @@ int Cdrskin_new(struct CdrskiN **skin, struct CdrpreskiN *preskin, int flag)
  o->media_is_overwriteable= 0;
  o->grow_overwriteable_iso= 0;
  memset(o->overwriteable_iso_head,0,sizeof(o->overwriteable_iso_head));
+ o->iso_head_handed_over= -1;
 
 #ifndef Cdrskin_extra_leaN
  ret= Cdradrtrn_new(&(o->adr_trn),0);
@@ -3924,8 +4001,16 @@ int Cdrskin_attach_fifo(struct CdrskiN *skin, int flag)
 
  /* Refuse here and thus use libburn fifo only with single track, non-CD */
  if(profile_number != 0x09 && profile_number != 0x0a &&
-    skin->track_counter == 1)
+    skin->track_counter == 1) {
+   /* Let the libburn fifo fill while the drive gets grabbed for burning */
+   if(!skin->tell_media_space) {
+     ret= Cdrtrack_prefetch_libburn_fifo(skin->tracklist[0],
+                            (skin->verbosity >= Cdrskin_verbose_debuG) | 4);
+     if(ret <= 0)
+       return(ret);
+   }
    return(1);
+ }
 
 #endif /* Cdrskin_use_libburn_fifO */
 
@@ -4530,24 +4615,25 @@ adr_translation:;
 
 
 /** Read and buffer the start of an existing ISO-9660 image from
-    overwriteable target media.
+    overwriteable target media. libburn keeps a copy of it, so that repeated
+    calls do not read again.
 */
 int Cdrskin_overwriteable_iso_size(struct CdrskiN *skin, int *size, int flag)
 {
  int ret;
- off_t data_count= 0;
+ off_t image_blocks= 0;
  double size_in_bytes;
  char *buf;
 
  buf= skin->overwriteable_iso_head;
  if(!skin->media_is_overwriteable)
    {ret= 0; goto ex;}
- /* Read first 64 kB */
- ret= burn_read_data(skin->grabbed_drive,(off_t) 0,buf,32*2048,&data_count,0);
+ /* Obtain first 64 kB */
+ ret= burn_disc_read_iso_head(skin->grabbed_drive, buf, &image_blocks, 0);
  if(ret<=0)
    {ret= 0; goto ex;}
- ret= Scan_for_iso_size((unsigned char *) (buf+16*2048), &size_in_bytes,0);
- if(ret<=0) {
+ size_in_bytes= ((double) image_blocks) * 2048.0;
+ if(ret!=1) {
    if(skin->verbosity>=Cdrskin_verbose_debuG)
   ClN(fprintf(stderr,"cdrskin_debug: No detectable ISO-9660 size on media\n"));
    {ret= 0; goto ex;}
@@ -7130,7 +7216,16 @@ ex:;
 }
 
 
-int Cdrskin_grow_overwriteable_iso(struct CdrskiN *skin, int flag)
+/** Compose the new ISO-9660 head on media from the descriptors of the track
+    and the old head on media.
+    @param o     If not NULL: submit the new head to the write options, so
+                 that libburn writes it at the end of the burn run.
+                 Else: write the new head to media now.
+    @return      <=0 error, 1= success, 2= o was submitted but the track
+                 descriptors are not known yet
+*/
+int Cdrskin_grow_overwriteable_iso(struct CdrskiN *skin,
+                                   struct burn_write_opts *o, int flag)
 {
  int ret, i, went_well= 1;
  char *track_descr, *md;
@@ -7138,6 +7233,8 @@ int Cdrskin_grow_overwriteable_iso(struct CdrskiN *skin, int flag)
  double track_size, media_size;
 
  ret= Cdrtrack_get_iso_fs_descr(skin->tracklist[0],&track_descr,&track_size,0);
+ if(ret<=0 && o!=NULL)
+   return(2);
  if(ret<=0) {
    fprintf(stderr,"cdrskin: SORRY : Saw no ISO-9660 filesystem in track 0\n");
    return(ret);
@@ -7187,6 +7284,18 @@ int Cdrskin_grow_overwriteable_iso(struct CdrskiN *skin, int flag)
    ClN(fprintf(stderr,"cdrskin_debug: copied %d secondary ISO descriptors\n",
                i-1));
 
+ if(o!=NULL) {
+   /* libburn writes block 16 to 31 before it syncs the end of the track */
+   if(skin->verbosity>=Cdrskin_verbose_debuG)
+     ClN(fprintf(stderr,
+        "cdrskin_debug: submitting blocks 16 to 31 to the burn run\n"));
+   ret= burn_write_opts_set_iso_head(o, skin->overwriteable_iso_head+16*2048,
+                                     0);
+   if(ret<=0)
+     return(ret);
+   return(went_well);
+ }
+
  /* write block 16 to 31 to media */
  if(skin->verbosity>=Cdrskin_verbose_debuG)
    ClN(fprintf(stderr,"cdrskin_debug: writing to media: blocks 16 to 31\n"));
@@ -7564,6 +7673,10 @@ burn_failed:;
 
  burn_write_opts_set_force(o, !!skin->force_is_set);
  burn_write_opts_set_stream_recording(o, skin->stream_recording_is_set);
+ if(skin->autotune_x_speed >= 0.0)
+   burn_write_opts_set_speed_autotune(o,
+                    (int) (skin->autotune_x_speed * Cdrskin_libburn_speed_factoR),
+                    0.0, 1);
 
 #ifdef Cdrskin_dvd_obs_default_64K
  if(skin->dvd_obs == 0)
@@ -7687,6 +7800,13 @@ fifo_filling_failed:;
  }
  if(burn_is_aborting(0))
    {ret= 0; goto ex;}
+ skin->iso_head_handed_over= -1;
+ if(skin->media_is_overwriteable && skin->grow_overwriteable_iso==2) {
+   /* growisofs final stunt, done by libburn along with the last flush */
+   ret= Cdrskin_grow_overwriteable_iso(skin, o, 0);
+   if(ret!=2)
+     skin->iso_head_handed_over= (ret>0);
+ }
  skin->drive_is_busy= 1;
  burn_disc_write(o, disc);
  if(skin->preskin->abort_handler==-1)
@@ -7792,10 +7912,12 @@ fifo_filling_failed:;
    Cdrskin_abort(skin, 0); /* Never comes back */
 
  wrote_well = burn_drive_wrote_well(drive);
- if(skin->media_is_overwriteable && skin->grow_overwriteable_iso>0 &&
-    wrote_well) {
+ if(skin->iso_head_handed_over==0) {
+   wrote_well= 0;
+ } else if(skin->media_is_overwriteable && skin->grow_overwriteable_iso>0 &&
+           skin->iso_head_handed_over<0 && wrote_well) {
    /* growisofs final stunt : update volume descriptors at start of media */
-   ret= Cdrskin_grow_overwriteable_iso(skin,0);
+   ret= Cdrskin_grow_overwriteable_iso(skin, NULL, 0);
    if(ret<=0)
      wrote_well= 0;
  }
@@ -9141,6 +9263,26 @@ set_speed:;
      if(skin->verbosity>=Cdrskin_verbose_cmD)
        ClN(printf("cdrskin: speed : %f\n",skin->x_speed));
 
+   } else if(strncmp(argv[i], "-speed_autotune=", 16)==0) {
+     value_pt= argv[i] + 16;
+     goto set_speed_autotune;
+   } else if(strncmp(argv[i], "speed_autotune=", 15)==0) {
+     value_pt= argv[i] + 15;
+set_speed_autotune:;
+     if(strcmp(value_pt, "on")==0)
+       skin->autotune_x_speed= 0.0;
+     else if(strcmp(value_pt, "off")==0)
+       skin->autotune_x_speed= -1.0;
+     else if(value_pt[0] >= '0' && value_pt[0] <= '9') {
+       sscanf(value_pt, "%lf", &(skin->autotune_x_speed));
+       if(skin->autotune_x_speed < 0.0)
+         skin->autotune_x_speed= 0.0;
+     } else {
+       fprintf(stderr,
+    "cdrskin: SORRY : speed_autotune= must be \"on\", \"off\", or a speed\n");
+       return(0);
+     }
+
    } else if(strncmp(argv[i], "-stdio_sync=", 12)==0) {
      value_pt= argv[i] + 12;
      goto stdio_sync;
@@ -17,12 +17,6 @@
 */
 #define Libburn_create_detached_threadS 1
 
-/* Alternative : Threads are created joinable.
-   Threads get detached in remove_worker() and thus should dispose themselves.
-
-#define Libburn_detach_done_workeR 1
-*/
-
 #ifdef HAVE_CONFIG_H
 #include "../config.h"
 #endif
@@ -36,6 +30,7 @@
 #include "async.h"
 #include "init.h"
 #include "back_hacks.h"
+#include "event.h"
 
 #include <pthread.h>
 #include <sys/types.h>
@@ -44,6 +39,8 @@
 #include <stdio.h>
 #include <string.h>
 #include <signal.h>
+#include <errno.h>
+#include <time.h>
 
 /*
 #include <a ssert.h>
@@ -58,9 +55,6 @@ extern struct libdax_msgs *libdax_messenger;
 #define Burnworker_type_writE   3
 #define Burnworker_type_fifO    4
 
-#define SCAN_GOING() (workers != NULL && \
-			workers->w_type == Burnworker_type_scaN)
-
 typedef void *(*WorkerFunc) (void *);
 
 struct scan_opts
@@ -69,6 +63,9 @@ struct scan_opts
 	unsigned int *n_drives;
 
 	int done;
+
+	/* ts C61019 : bit0= forget all known drives and scan from scratch */
+	int flag;
 };
 
 struct erase_opts
@@ -107,6 +104,8 @@ union w_list_data
 	struct fifo_opts fifo;
 };
 
+struct burn_drive_worker;
+
 struct w_list
 {
 	/* ts A80714 */
@@ -118,9 +117,67 @@ struct w_list
 	struct w_list *next;
 
 	union w_list_data u;
+
+	/* ts C61019 */
+	WorkerFunc func;
+	struct burn_drive_worker *owner; /* NULL if not a drive job */
+};
+
+
+/* ts C61019 : Each drive gets a persistent worker thread which executes
+   its operations. The jobs are queued in a ring which gets written only by
+   the thread that starts operations and advanced only by the worker
+   thread. So queuing and finishing of jobs need no lock. The mutex and the
+   condition only serve for sleeping and waking of the idle worker.
+   The API allows only one operation per drive at a time. So the ring needs
+   room for one job.
+*/
+#define Libburn_worker_queuE 2
+
+struct burn_drive_worker {
+	pthread_mutex_t wait_lock;
+	pthread_cond_t wakeup;
+
+	struct w_list queue[Libburn_worker_queuE];
+	volatile int queue_write; /* changed by the starting thread */
+	volatile int queue_done;  /* changed by the worker thread */
+
+	/* The worker shall end and dispose this object */
+	volatile int stop;
 };
 
-static struct w_list *workers = NULL;
+#ifdef __GNUC__
+#define Libburn_worker_barrieR __sync_synchronize()
+#else
+#define Libburn_worker_barrieR
+#endif
+
+
+/* ts C61019 : The fifo shovellers run on a shared pool of threads.
+   A thread which finds no work for this number of seconds ends itself.
+*/
+#define Libburn_fifo_pool_lingeR 10
+
+/* ts C61019 : Seconds to wait for the end of an aborted fifo shoveller.
+   A shoveller which is stuck in the read call of its input may never end.
+*/
+#define Libburn_fifo_end_waiT 3
+
+static struct burn_fifo_pool {
+	pthread_mutex_t lock;
+	pthread_cond_t wakeup;
+	pthread_cond_t ended;   /* signalled when a shoveller ends */
+	struct w_list *first;   /* waiting jobs */
+	struct w_list *last;
+	int waiting;            /* number of waiting jobs */
+	int idle;               /* number of threads waiting for jobs */
+	int threads;
+} fifo_pool = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER,
+               PTHREAD_COND_INITIALIZER, NULL, NULL, 0, 0, 0};
+
+
+/* ts C61019 : The scanner is the only worker without drive or fifo */
+static struct w_list *scan_worker = NULL;
 
 static void *fifo_worker_func(struct w_list *w);
 
@@ -161,44 +218,12 @@ int burn_async_manage_lock(int mode)
 }
 
 
-static struct w_list *find_worker(struct burn_drive *d)
+static int create_thread(pthread_t *thread, WorkerFunc f, void *arg)
 {
-	struct w_list *a;
-
-	for (a = workers; a; a = a->next)
-		if (a->drive == d)
-			return a;
-	return NULL;
-}
-
-static void add_worker(int w_type, struct burn_drive *d,
-			WorkerFunc f, union w_list_data *data)
-{
-	struct w_list *a;
-	struct w_list *tmp;
 	pthread_attr_t *attr_pt = NULL;
 
 #ifdef Libburn_create_detached_threadS
 	pthread_attr_t attr;
-#endif
-
-	a = calloc(1, sizeof(struct w_list));
-	a->w_type = w_type;
-	a->drive = d;
-
-	a->u = *data;
-
-	burn_async_manage_lock(BURN_ASYNC_LOCK_INIT);
-
-	/* insert at front of the list */
-	a->next = workers;
-	tmp = workers;
-	workers = a;
-
-	if (d != NULL)
-		d->busy = BURN_DRIVE_SPAWNING;
-
-#ifdef Libburn_create_detached_threadS
 
 	/* ts A71019 :
 	   Trying to start the threads detached to get rid of the zombies
@@ -210,67 +235,215 @@ static void add_worker(int w_type, struct burn_drive *d,
 
 #endif /* Libburn_create_detached_threadS */
 
-	/* Worker specific locks are to be released early by the worker */
-	if (f == (WorkerFunc) fifo_worker_func)
-		burn_async_manage_lock(BURN_ASYNC_LOCK_OBTAIN);
+	if (pthread_create(thread, attr_pt, f, arg))
+		return 0;
+	return 1;
+}
+
 
-	if (pthread_create(&a->thread, attr_pt, f, a)) {
-		free(a);
-		workers = tmp;
-		return;
+/* ts C61019 : Whether the drive has a queued or running job */
+static int drive_has_job(struct burn_drive *d)
+{
+	struct burn_drive_worker *w = d->worker;
+
+	if (w == NULL)
+		return 0;
+	return (w->queue_write != w->queue_done);
+}
+
+
+/* ts C61019 */
+static void *drive_worker_func(struct burn_drive_worker *w)
+{
+	struct w_list job;
+	int pos;
+	sigset_t sigset;
+
+	/* Protect the idle worker from external signals. The jobs protect
+	   themselves too.
+	*/
+	sigfillset(&sigset);
+	sigdelset(&sigset, SIGSEGV);
+	sigdelset(&sigset, SIGILL);
+	pthread_sigmask(SIG_SETMASK, &sigset, NULL);
+
+	while (1) {
+		pthread_mutex_lock(&w->wait_lock);
+		while (w->queue_done == w->queue_write && !w->stop)
+			pthread_cond_wait(&w->wakeup, &w->wait_lock);
+		pthread_mutex_unlock(&w->wait_lock);
+		if (w->stop)
+	break;
+		Libburn_worker_barrieR;
+		pos = w->queue_done;
+		memcpy(&job, &(w->queue[pos]), sizeof(struct w_list));
+		job.thread = pthread_self();
+		(*job.func)(&job);
+
+		/* In case that the job did not call remove_worker() */
+		if (w->queue_done == pos)
+			w->queue_done = (pos + 1) % Libburn_worker_queuE;
+
+		/* Possibly performs a burn_drive_free() which was deferred
+		   while the job ran. This sets w->stop.
+		*/
+		burn_drive_unref(job.drive);
 	}
+	/* Release the drives of jobs which will not be performed */
+	for (pos = w->queue_done; pos != w->queue_write;
+	     pos = (pos + 1) % Libburn_worker_queuE)
+		burn_drive_unref(w->queue[pos].drive);
+	pthread_cond_destroy(&w->wakeup);
+	pthread_mutex_destroy(&w->wait_lock);
+	free((char *) w);
+	return NULL;
 }
 
 
-static void remove_worker(pthread_t th)
+/* ts C61019 */
+static struct burn_drive_worker *drive_worker_get(struct burn_drive *d)
 {
-	struct w_list *a, *l = NULL;
+	struct burn_drive_worker *w;
+	pthread_t thread;
+
+	if (d->worker != NULL)
+		return d->worker;
+	w = calloc(1, sizeof(struct burn_drive_worker));
+	if (w == NULL)
+		return NULL;
+	w->queue_write = w->queue_done = 0;
+	w->stop = 0;
+	pthread_mutex_init(&w->wait_lock, NULL);
+	pthread_cond_init(&w->wakeup, NULL);
+	if (!create_thread(&thread, (WorkerFunc) drive_worker_func, w)) {
+		pthread_cond_destroy(&w->wakeup);
+		pthread_mutex_destroy(&w->wait_lock);
+		free((char *) w);
+		return NULL;
+	}
+	d->worker = w;
+	return w;
+}
 
-	for (a = workers; a; l = a, a = a->next)
-		if (a->thread == th) {
-			if (l)
-				l->next = a->next;
-			else
-				workers = a->next;
 
-#ifdef Libburn_detach_done_workeR
-			/* ts A71019 : burry dead puppy before forgetting it */
-			/* Alternative : threads get detached and thus should
-					dispose themselves.
-			*/
-			pthread_detach(th);
-/*
-			int ret;
-			char msg[80];
-
-			ret = pthread_detach(th);
-			sprintf(msg,
-			 "remove_workers(): pid= %lu  pthread_detach(%lu)= %d",
-			 (unsigned long) getpid(), (unsigned long) th, ret);
-			libdax_msgs_submit(libdax_messenger, -1, 0x00020158,
-				LIBDAX_MSGS_SEV_DEBUG, LIBDAX_MSGS_PRIO_LOW,
-				msg, 0, 0);
+/* ts C61019 */
+int burn_drive_worker_destroy(struct burn_drive *d, int flag)
+{
+	struct burn_drive_worker *w = d->worker;
+
+	if (w == NULL)
+		return 0;
+	d->worker = NULL;
+	/* The worker thread disposes w when it ends. A running job gets
+	   finished before.
+	*/
+	pthread_mutex_lock(&w->wait_lock);
+	w->stop = 1;
+	pthread_cond_signal(&w->wakeup);
+	pthread_mutex_unlock(&w->wait_lock);
+	return 1;
+}
+
+
+/* Queue a job for the worker of the drive, or start the scanner if d is
+   NULL.
+   @return 1= job is queued or started, <=0 failure
 */
-			
-#endif /* Libburn_detach_done_workeR */
+static int add_worker(int w_type, struct burn_drive *d,
+			WorkerFunc f, union w_list_data *data)
+{
+	struct w_list *a;
+	struct burn_drive_worker *w;
+	int pos, next;
+
+	burn_async_manage_lock(BURN_ASYNC_LOCK_INIT);
 
+	if (d == NULL) {
+		a = calloc(1, sizeof(struct w_list));
+		if (a == NULL)
+			goto no_thread;
+		a->w_type = w_type;
+		a->func = f;
+		a->u = *data;
+		scan_worker = a;
+		if (!create_thread(&a->thread, f, a)) {
+			scan_worker = NULL;
 			free(a);
-			break;
+			goto no_thread;
 		}
+		return 1;
+	}
 
-	/* ts A61006 */
-	/* a ssert(a != NULL);/ * wasn't found.. this should not be possible */
-	if (a == NULL)
-		libdax_msgs_submit(libdax_messenger, -1, 0x00020101,
-			LIBDAX_MSGS_SEV_WARNING, LIBDAX_MSGS_PRIO_HIGH,
-			"remove_worker() cannot find given worker item", 0, 0);
+	/* ts C61019 */
+	if (d->hotplug_detached) {
+		libdax_msgs_submit(libdax_messenger, d->global_index,
+			0x000201ba,
+			LIBDAX_MSGS_SEV_SORRY, LIBDAX_MSGS_PRIO_HIGH,
+			"Drive was detached from the system", 0, 0);
+		return 0;
+	}
+
+	w = drive_worker_get(d);
+	if (w == NULL)
+		goto no_thread;
+	pos = w->queue_write;
+	next = (pos + 1) % Libburn_worker_queuE;
+	if (next == w->queue_done) {
+		libdax_msgs_submit(libdax_messenger, d->global_index,
+			0x00020102,
+			LIBDAX_MSGS_SEV_SORRY, LIBDAX_MSGS_PRIO_HIGH,
+			"A drive operation is still going on", 0, 0);
+		return 0;
+	}
+	a = &(w->queue[pos]);
+	memset(a, 0, sizeof(struct w_list));
+	a->w_type = w_type;
+	a->drive = d;
+	a->func = f;
+	a->owner = w;
+	a->u = *data;
+
+	d->busy = BURN_DRIVE_SPAWNING;
+
+	/* ts C61019 : The drive object shall not be freed before the job
+	               has ended.
+	*/
+	burn_drive_ref(d);
+	Libburn_worker_barrieR;
+	w->queue_write = next;
+	pthread_mutex_lock(&w->wait_lock);
+	pthread_cond_signal(&w->wakeup);
+	pthread_mutex_unlock(&w->wait_lock);
+	return 1;
+
+no_thread:;
+	libdax_msgs_submit(libdax_messenger, d == NULL ? -1 : d->global_index,
+		0x000201b6,
+		LIBDAX_MSGS_SEV_FATAL, LIBDAX_MSGS_PRIO_HIGH,
+		"Cannot start worker thread", 0, 0);
+	return -1;
+}
+
+
+/* Declare the job done, so that a new operation may be started on the
+   drive
+*/
+static void remove_worker(struct w_list *a)
+{
+	struct burn_drive_worker *w = a->owner;
+
+	if (w == NULL)
+		return;
+	Libburn_worker_barrieR;
+	w->queue_done = (w->queue_done + 1) % Libburn_worker_queuE;
 }
 
 static void *scan_worker_func(struct w_list *w)
 {
 	int ret;
 
-	ret = burn_drive_scan_sync(w->u.scan.drives, w->u.scan.n_drives, 1);
+	ret = burn_drive_scan_sync(w->u.scan.drives, w->u.scan.n_drives,
+				   w->u.scan.flag & 1);
 	if (ret <= 0)
 		w->u.scan.done = -1;
 	else
@@ -309,52 +482,34 @@ int burn_drive_scan(struct burn_drive_info *drives[], unsigned int *n_drives)
 		return -1;
 	}
 
-	/* cannot be anything working! */
+	if (scan_worker == NULL) {
+		/* start it */
 
-	/* ts A61006 */
-	/* a ssert(!(workers && workers->drive)); */
-	if (workers != NULL && workers->drive != NULL) {
-drive_is_active:;
-		libdax_msgs_submit(libdax_messenger, -1, 0x00020102,
-			LIBDAX_MSGS_SEV_SORRY, LIBDAX_MSGS_PRIO_HIGH,
-			"A drive operation is still going on (want to scan)",
-			0, 0);
 		*drives = NULL;
 		*n_drives = 0;
-		return -1;
-	}
 
-	if (workers == NULL) {
-		/* start it */
+		o.scan.drives = drives;
+		o.scan.n_drives = n_drives;
+		o.scan.done = 0;
 
 		/* ts A61007 : test moved up from burn_drive_scan_sync()
 				was burn_wait_all() */
 		/* ts A70907 : now demanding freed drives, not only released */
-		if (!burn_drives_are_clear(1))
-			goto drive_is_active;
-		*drives = NULL;
-		*n_drives = 0;
+		/* ts C61019 : Known drives may be busy. Then only look for
+		               drives which are not known yet.
+		*/
+		o.scan.flag = burn_drives_are_clear(1);
 
-		o.scan.drives = drives;
-		o.scan.n_drives = n_drives;
-		o.scan.done = 0;
-		add_worker(Burnworker_type_scaN, NULL,
+		ret = add_worker(Burnworker_type_scaN, NULL,
 				 (WorkerFunc) scan_worker_func, &o);
-	} else if (workers->u.scan.done) {
-		/* its done */
-		ret = workers->u.scan.done;
-		remove_worker(workers->thread);
-
-		/* ts A61006 */
-		/* a ssert(workers == NULL); */
-		if (workers != NULL) {
-			libdax_msgs_submit(libdax_messenger, -1, 0x00020101,
-				LIBDAX_MSGS_SEV_WARNING, LIBDAX_MSGS_PRIO_HIGH,
-			     "After scan a drive operation is still going on",
-				0, 0);
+		if (ret <= 0)
 			return -1;
-		}
-
+		ret = 0;
+	} else if (scan_worker->u.scan.done) {
+		/* its done */
+		ret = scan_worker->u.scan.done;
+		free((char *) scan_worker);
+		scan_worker = NULL;
 	} else {
 		/* still going */
 	}
@@ -377,7 +532,7 @@ static void *erase_worker_func(struct w_list *w)
 #endif /* Libburn_protect_erase_threaD */
 
 	burn_disc_erase_sync(w->u.erase.drive, w->u.erase.fast);
-	remove_worker(pthread_self());
+	remove_worker(w);
 
 #ifdef Libburn_protect_erase_threaD
 	/* (just in case it would not end with all signals blocked) */
@@ -393,7 +548,6 @@ void burn_disc_erase(struct burn_drive *drive, int fast)
 
 	/* ts A61006 */
 	/* a ssert(drive); */
-	/* a ssert(!SCAN_GOING()); */
 	/* a ssert(!find_worker(drive)); */
 
 	if(drive == NULL) {
@@ -403,7 +557,7 @@ void burn_disc_erase(struct burn_drive *drive, int fast)
 			"NULL pointer caught in burn_disc_erase", 0, 0);
 		return;
 	}
-	if ((SCAN_GOING()) || find_worker(drive) != NULL) {
+	if (drive_has_job(drive)) {
 		libdax_msgs_submit(libdax_messenger, drive->global_index,
 			0x00020102,
 			LIBDAX_MSGS_SEV_SORRY, LIBDAX_MSGS_PRIO_HIGH,
@@ -476,7 +630,7 @@ static void *format_worker_func(struct w_list *w)
 
 	burn_disc_format_sync(w->u.format.drive, w->u.format.size,
 				w->u.format.flag);
-	remove_worker(pthread_self());
+	remove_worker(w);
 
 #ifdef Libburn_protect_format_threaD
 	/* (just in case it would not end with all signals blocked) */
@@ -496,7 +650,7 @@ void burn_disc_format(struct burn_drive *drive, off_t size, int flag)
 
 	reset_progress(drive, 1, 1, 1, 0x10000, 0);
 
-	if ((SCAN_GOING()) || find_worker(drive) != NULL) {
+	if (drive_has_job(drive)) {
 		libdax_msgs_submit(libdax_messenger, drive->global_index,
 			0x00020102,
 			LIBDAX_MSGS_SEV_SORRY, LIBDAX_MSGS_PRIO_HIGH,
@@ -619,9 +773,12 @@ static void *write_disc_worker_func(struct w_list *w)
 			LIBDAX_MSGS_SEV_DEBUG, LIBDAX_MSGS_PRIO_HIGH,
 			msg, 0, 0);
 
-	remove_worker(pthread_self());
+	remove_worker(w);
 	d->busy = BURN_DRIVE_IDLE;
 
+	/* ts C61019 */
+	burn_drive_events_check(d, 1);
+
 #ifdef Libburn_protect_write_threaD
 	/* (just in case it would not end with all signals blocked) */
 	pthread_sigmask(SIG_SETMASK, &oldset, NULL);
@@ -640,9 +797,8 @@ void burn_disc_write(struct burn_write_opts *opts, struct burn_disc *disc)
 	d = opts->drive;
 
 	/* ts A61006 */
-	/* a ssert(!SCAN_GOING()); */
 	/* a ssert(!find_worker(opts->drive)); */
-	if ((SCAN_GOING()) || find_worker(opts->drive) != NULL) {
+	if (drive_has_job(opts->drive)) {
 		libdax_msgs_submit(libdax_messenger, d->global_index,
 			0x00020102,
 			LIBDAX_MSGS_SEV_SORRY, LIBDAX_MSGS_PRIO_HIGH,
@@ -732,8 +888,11 @@ void burn_disc_write(struct burn_write_opts *opts, struct burn_disc *disc)
 
 	opts->refcount++;
 
-	add_worker(Burnworker_type_writE, d,
-			(WorkerFunc) write_disc_worker_func, &o);
+	if (add_worker(Burnworker_type_writE, d,
+			(WorkerFunc) write_disc_worker_func, &o) <= 0) {
+		opts->refcount--;
+		d->cancel = 1;
+	}
 
 ex:;
 	BURN_FREE_MEM(reasons);
@@ -756,7 +915,6 @@ static void *fifo_worker_func(struct w_list *w)
 #endif /* Libburn_protect_fifo_threaD */
 
 	burn_fifo_source_shoveller(w->u.fifo.source, w->u.fifo.flag);
-	remove_worker(pthread_self());
 
 #ifdef Libburn_protect_fifo_threaD
 	/* (just in case it would not end with all signals blocked) */
@@ -767,16 +925,114 @@ static void *fifo_worker_func(struct w_list *w)
 }
 
 
+/* ts C61019 */
+static void *fifo_pool_func(void *arg)
+{
+	struct w_list *job;
+	struct timespec deadline;
+	sigset_t sigset;
+	int ret;
+
+	/* Protect the idle thread from external signals */
+	sigfillset(&sigset);
+	sigdelset(&sigset, SIGSEGV);
+	sigdelset(&sigset, SIGILL);
+	pthread_sigmask(SIG_SETMASK, &sigset, NULL);
+
+	pthread_mutex_lock(&fifo_pool.lock);
+	while (1) {
+		if (fifo_pool.first == NULL) {
+			deadline.tv_sec = time(NULL) +
+					  Libburn_fifo_pool_lingeR;
+			deadline.tv_nsec = 0;
+			fifo_pool.idle++;
+			ret = 0;
+			while (fifo_pool.first == NULL && ret != ETIMEDOUT)
+				ret = pthread_cond_timedwait(&fifo_pool.wakeup,
+							&fifo_pool.lock,
+							&deadline);
+			fifo_pool.idle--;
+			if (fifo_pool.first == NULL)
+	break;
+		}
+		job = fifo_pool.first;
+		fifo_pool.first = job->next;
+		if (fifo_pool.first == NULL)
+			fifo_pool.last = NULL;
+		fifo_pool.waiting--;
+		pthread_mutex_unlock(&fifo_pool.lock);
+
+		job->thread = pthread_self();
+		fifo_worker_func(job);
+		free((char *) job);
+
+		pthread_mutex_lock(&fifo_pool.lock);
+	}
+	fifo_pool.threads--;
+	pthread_mutex_unlock(&fifo_pool.lock);
+	return NULL;
+}
+
+
+/* ts C61019 : Hand a fifo job to an idle thread of the pool or to a new
+   thread.
+*/
+static int fifo_pool_add(union w_list_data *data)
+{
+	struct w_list *a;
+	pthread_t thread;
+
+	a = calloc(1, sizeof(struct w_list));
+	if (a == NULL)
+		return -1;
+	a->w_type = Burnworker_type_fifO;
+	a->func = (WorkerFunc) fifo_worker_func;
+	a->u = *data;
+
+	/* This lock is to be released by burn_fifo_source_shoveller() after
+	   it recorded its thread in the fifo object
+	*/
+	burn_async_manage_lock(BURN_ASYNC_LOCK_INIT);
+	burn_async_manage_lock(BURN_ASYNC_LOCK_OBTAIN);
+
+	pthread_mutex_lock(&fifo_pool.lock);
+	if (fifo_pool.idle <= fifo_pool.waiting) {
+		if (!create_thread(&thread, (WorkerFunc) fifo_pool_func,
+				   NULL)) {
+			pthread_mutex_unlock(&fifo_pool.lock);
+			burn_async_manage_lock(BURN_ASYNC_LOCK_RELEASE);
+			free((char *) a);
+			return 0;
+		}
+		fifo_pool.threads++;
+	}
+	if (fifo_pool.last == NULL)
+		fifo_pool.first = a;
+	else
+		fifo_pool.last->next = a;
+	fifo_pool.last = a;
+	fifo_pool.waiting++;
+	pthread_cond_signal(&fifo_pool.wakeup);
+	pthread_mutex_unlock(&fifo_pool.lock);
+	return 1;
+}
+
+
 int burn_fifo_start(struct burn_source *source, int flag)
 {
 	union w_list_data o;
 	struct burn_source_fifo *fs = source->data;
+	int ret;
 
 	fs->is_started = -1;
 
 	/* create and set up ring buffer */;
-	fs->buf = burn_os_alloc_buffer(
-			((size_t) fs->chunksize) * (size_t) fs->chunks, 0);
+	/* ts C61019 : The buffer gets not zeroed here. So its pages get
+	   mapped by the fifo thread when it writes data into them.
+	*/
+	fs->buf = burn_os_alloc_buffer_v2(
+			((size_t) fs->chunksize) * (size_t) fs->chunks,
+			fs->buf_alloc_flag, &(fs->buf_obtained));
 	if (fs->buf == NULL) {
 		/* >>> could not start ring buffer */;
 		return -1;
@@ -784,8 +1040,9 @@ int burn_fifo_start(struct burn_source *source, int flag)
 
 	o.fifo.source = source;
 	o.fifo.flag = flag;
-	add_worker(Burnworker_type_fifO, NULL,
-			(WorkerFunc) fifo_worker_func, &o);
+	ret = fifo_pool_add(&o);
+	if (ret <= 0)
+		return -1;
 	fs->is_started = 1;
 
 	return 1;
@@ -794,37 +1051,67 @@ int burn_fifo_start(struct burn_source *source, int flag)
 
 int burn_fifo_abort(struct burn_source_fifo *fs, int flag)
 {
-	int ret;
-	pthread_t pt;
-
 	burn_async_manage_lock(BURN_ASYNC_LOCK_OBTAIN);
 
 	if (fs->thread_is_valid <= 0 || fs->thread_handle == NULL) {
 		burn_async_manage_lock(BURN_ASYNC_LOCK_RELEASE);
 		return 2;
 	}
-	pt = *((pthread_t *) fs->thread_handle);
 
 	burn_async_manage_lock(BURN_ASYNC_LOCK_RELEASE);
 
+	/* ts C61019 : The shoveller notices fs->do_abort only between its
+	   reads. The caller has to wait until fs->thread_is_valid becomes 0.
+	   See burn_fifo_wait_end().
+	*/
 	fs->do_abort = 1;
-	ret = pthread_join(pt, NULL);
+	return 1;
+}
+
+
+/* ts C61019 */
+int burn_async_start_helper(void *(*func)(void *), void *handle, int flag)
+{
+	pthread_t thread;
 
-	return (ret == 0);
+	if (!create_thread(&thread, (WorkerFunc) func, handle))
+		return 0;
+	return 1;
 }
 
 
-#ifdef Libburn_has_burn_async_join_alL
+/* ts C61019 */
+int burn_fifo_ended(struct burn_source_fifo *fs, int flag)
+{
+	burn_async_manage_lock(BURN_ASYNC_LOCK_OBTAIN);
+	pthread_mutex_lock(&fifo_pool.lock);
+	fs->thread_handle = NULL;
+	fs->thread_is_valid = 0;
+	pthread_cond_broadcast(&fifo_pool.ended);
+	pthread_mutex_unlock(&fifo_pool.lock);
+	burn_async_manage_lock(BURN_ASYNC_LOCK_RELEASE);
+	return 1;
+}
 
-/* ts A71019 : never used */
-void burn_async_join_all(void)
+
+/* ts C61019 */
+/* @return 1 = shoveller has ended , 0 = it is still alive after
+               Libburn_fifo_end_waiT seconds
+*/
+int burn_fifo_wait_end(struct burn_source_fifo *fs, int flag)
 {
-	void *ret;
+	struct timespec deadline;
+	int ret = 0;
 
-	while (workers)
-		pthread_join(workers->thread, &ret);
+	deadline.tv_sec = time(NULL) + Libburn_fifo_end_waiT;
+	deadline.tv_nsec = 0;
+	pthread_mutex_lock(&fifo_pool.lock);
+	while (fs->thread_is_valid > 0 && ret != ETIMEDOUT)
+		ret = pthread_cond_timedwait(&fifo_pool.ended, &fifo_pool.lock,
+					     &deadline);
+	ret = (fs->thread_is_valid <= 0);
+	pthread_mutex_unlock(&fifo_pool.lock);
+	return ret;
 }
 
-#endif /* Libburn_has_burn_async_join_alL */
-
 
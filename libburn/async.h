@@ -8,8 +8,10 @@
 #ifndef BURN__ASYNC_H
 #define BURN__ASYNC_H
 
-void burn_async_join_all(void);
 struct burn_write_opts;
+struct burn_drive;
+struct burn_source;
+struct burn_source_fifo;
 
 /* ts A70930 */
 /* To be called when the first read() call comes to a fifo */
@@ -19,10 +21,28 @@ int burn_fifo_start(struct burn_source *source, int flag);
 /* To abort a running fifo thread before the fifo object gets deleted */
 int burn_fifo_abort(struct burn_source_fifo *fs, int flag);
 
+/* ts C61019 */
+/* To be called by the shoveller of a fifo when it ends */
+int burn_fifo_ended(struct burn_source_fifo *fs, int flag);
+
+/* ts C61019 */
+/* To wait until the shoveller of a fifo has called burn_fifo_ended().
+   Gives up after a few seconds and then returns 0.
+*/
+int burn_fifo_wait_end(struct burn_source_fifo *fs, int flag);
+
 /* ts B70126 */
 #define BURN_ASYNC_LOCK_RELEASE 0
 #define BURN_ASYNC_LOCK_OBTAIN  1
 #define BURN_ASYNC_LOCK_INIT    2
 int burn_async_manage_lock(int mode);
 
+/* ts C61019 */
+/* To run a helper function of a burn_source in a detached thread */
+int burn_async_start_helper(void *(*func)(void *), void *handle, int flag);
+
+/* ts C61019 */
+/* To end the worker thread of a drive when the drive object gets disposed */
+int burn_drive_worker_destroy(struct burn_drive *d, int flag);
+
 #endif /* BURN__ASYNC_H */
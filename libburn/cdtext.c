@@ -22,6 +22,7 @@
 #include "structure.h"
 #include "options.h"
 #include "util.h"
+#include "crc.h"
 
 #include "libdax_msgs.h"
 extern struct libdax_msgs *libdax_messenger;
@@ -76,6 +77,8 @@ int burn_create_new_pack(int pack_type, int track_no, int double_byte,
 }
 
 
+#ifdef Libburn_no_crc_C
+
 /* Plain implementation of polynomial division on a Galois field, where
    addition and subtraction both are binary exor. Euclidian algorithm.
    Divisor is x^16 + x^12 + x^5 + 1 = 0x11021.
@@ -94,6 +97,23 @@ static int crc_11021(unsigned char *data, int count, int flag)
 	return acc;
 }
 
+#endif /* Libburn_no_crc_C */
+
+
+/* ts C61019 : The checksum of a pack as it is to be stored in its bytes 16
+               and 17. MMC-3 Annex J : The polynomial is X16 + X12 + X5 + 1.
+               All bits shall be inverted.
+               crc_ccitt() of crc.c computes this by a table of residues.
+*/
+static int burn_cdtext_pack_crc(unsigned char *pack)
+{
+#ifdef Libburn_no_crc_C
+	return crc_11021(pack, 16, 0) ^ 0xffff;
+#else
+	return crc_ccitt(pack, 16);
+#endif
+}
+
 
 /* @param flag bit0= repair mismatching checksums
                bit1= repair checksums if all pack CRCs are 0
@@ -114,9 +134,9 @@ int burn_cdtext_crc_mismatches(unsigned char *packs, int num_packs, int flag)
 			repair = 1;
 	}
 	for (i = 0; i < num_packs * 18; i += 18) {
-		residue = crc_11021(packs + i, 16, 0);
-		crc[0] = ((residue >> 8) & 0xff) ^ 0xff;
-		crc[1] = ((residue     ) & 0xff) ^ 0xff;
+		residue = burn_cdtext_pack_crc(packs + i);
+		crc[0] = (residue >> 8) & 0xff;
+		crc[1] =  residue       & 0xff;
 		if(crc[0] != packs[i + 16] || crc[1] != packs[i + 17]) {
 			if (repair) {
 				if (packs[i + 16] || packs[i + 17])
@@ -144,7 +164,7 @@ static int burn_finalize_text_pack(struct burn_pack_cursor *crs, int flag)
 	/* MMC-3 Annex J : CRC Field consists of 2 bytes.
 	   The polynomial is X16 + X12 + X5 + 1. All bits shall be inverted.
 	*/
-	residue = crc_11021(crs->packs + idx, 16, 0) ^ 0xffff;
+	residue = burn_cdtext_pack_crc(crs->packs + idx);
 
 	crs->packs[idx + 16] = (residue >> 8) & 0xff;
 	crs->packs[idx + 17] = residue & 0xff;
@@ -421,7 +441,7 @@ int burn_cdtext_from_session(struct burn_session *s,
 		} else
 	continue;
 		/* Re-compute checksum */
-		residue = crc_11021(crs.packs + idx, 16, 0) ^ 0xffff;
+		residue = burn_cdtext_pack_crc(crs.packs + idx);
 		crs.packs[idx + 16] = (residue >> 8) & 0xff;
 		crs.packs[idx + 17] = residue & 0xff;
 	}
@@ -41,7 +41,8 @@
     to check errors in the Pack. The polynomial is x^16 + x^12 + x^5 + 1.
     All bits shall be inverted."
    
-   libburn/cdtext.c uses a simple bit shifting function : crc_11021()
+   libburn/cdtext.c used a simple bit shifting function : crc_11021()
+   ts C61019: It now uses crc_ccitt() unless Libburn_no_crc_C is defined.
 
 
    ts B20211:
@@ -60,13 +60,62 @@
 
 /* B60730 : for Libburn_do_no_immed_defaulT */
 #include "os.h"
+#include "event.h"
+#include "async.h"
 
 #include "libdax_msgs.h"
 extern struct libdax_msgs *libdax_messenger;
 
-static struct burn_drive drive_array[255];
+/* ts C61019 : Registry of the drive objects.
+   Each drive object is allocated separately and does not move while other
+   drives get added or removed. The array of pointers grows on demand.
+   A replaced array stays allocated until burn_drive_registry_free(),
+   because other threads may iterate over the drives without locking.
+   Objects beyond drivetop are spares from freed drives.
+*/
+struct burn_drive_slots {
+	struct burn_drive_slots *retired; /* the smaller predecessor */
+	int size;
+	struct burn_drive *drive[1];      /* actually .size elements */
+};
+
+/* Initial number of slots. The number gets doubled when all are used. */
+#define Libburn_drive_slotS 16
+
+#ifdef __GNUC__
+#define Libburn_drive_barrieR __sync_synchronize()
+#else
+#define Libburn_drive_barrieR
+#endif
+
+static struct burn_drive_slots *drive_slots = NULL;
+static struct burn_drive **drive_array = NULL;
 static int drivetop = -1;
 
+/* Protects registering, unregistering and the counting of users */
+static pthread_mutex_t drive_registry_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* ts C61019 : Protects the whitelist while it gets changed or used by the
+               enumeration of drives
+*/
+static pthread_mutex_t enumeration_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* ts C61019 : Retry time for drives which were announced by a hotplug
+               event but could not be scanned yet
+*/
+static double hotplug_retry_until = 0.0;
+
+#define Libburn_hotplug_retrY 10.0
+
+/* ts C61019 : The addresses of these drives get scanned by the retries */
+#define Libburn_hotplug_pendinG 16
+static char *hotplug_pending[Libburn_hotplug_pendinG];
+static int hotplug_pending_count = 0;
+
+static int burn_drive_scan_adr_list(char **adrs, int count,
+				    struct burn_drive_info *drive_infos[],
+				    unsigned int *n_drives, int flag);
+
 /* ts A80410 : in init.c */
 extern int burn_support_untested_profiles;
 
@@ -83,6 +132,7 @@ int burn_setup_drive(struct burn_drive *d, char *fname)
 	d->idata = NULL;
 	d->mdata = NULL;
 	d->toc_entry = NULL;
+	d->toc_pending = 0;
 	d->released = 1;
 	d->stdio_fd = -1;
 	d->status = BURN_DISC_UNREADY;
@@ -103,6 +153,17 @@ int burn_setup_drive(struct burn_drive *d, char *fname)
 	d->drive_serial_number_len = -1;
 	d->media_serial_number = NULL;
 	d->media_serial_number_len = -1;
+	d->events = NULL; /* ts C61019 */
+	d->worker = NULL;
+	d->users = 0;
+	d->free_pending = 0;
+	d->hotplug_detached = 0;
+	d->status_inquiries = 0;
+	d->bg_op_start = d->bg_op_poll = d->bg_op_end = d->bg_op_next = 0.0;
+	d->big_alloc_len = 0;
+	d->iso_head_cache = NULL;
+	d->iso_head_valid = 0;
+	d->abs_msf.valid = d->rel_msf.valid = 0;
 	return 1;
 }
 
@@ -128,9 +189,14 @@ void burn_drive_free_subs(struct burn_drive *d)
 		close (d->stdio_fd);
 	d->stdio_fd = -1;
 	burn_feature_descr_free(&(d->features), 0);
+	burn_drive_events_destroy(d, 0);
+	burn_drive_worker_destroy(d, 0);
 	BURN_FREE_MEM(d->drive_serial_number);
 	BURN_FREE_MEM(d->media_serial_number);
         d->drive_serial_number = d->media_serial_number = NULL;
+	BURN_FREE_MEM(d->iso_head_cache);
+	d->iso_head_cache = NULL;
+	d->iso_head_valid = 0;
 	d->drive_serial_number_len = d->media_serial_number_len = 0;
 	sg_dispose_drive(d, 0);
 }
@@ -142,6 +208,15 @@ void burn_drive_free(struct burn_drive *d)
 {
 	if (d->global_index == -1)
 		return;
+	/* ts C61019 : a worker job still uses the drive */
+	pthread_mutex_lock(&drive_registry_lock);
+	if (d->users > 0) {
+		d->free_pending = 1;
+		pthread_mutex_unlock(&drive_registry_lock);
+		return;
+	}
+	d->free_pending = 0;
+	pthread_mutex_unlock(&drive_registry_lock);
 	/* ts A60822 : close open fds before forgetting them */
 	if (d->drive_role == 1)
 		if (burn_drive_is_open(d)) {
@@ -152,14 +227,143 @@ void burn_drive_free(struct burn_drive *d)
 	d->global_index = -1;
 }
 
+/* ts C61019 : Lower drivetop past the disposed drives at the end of the
+   array. Drives which still wait for the end of a worker job keep their
+   slot. To be called with drive_registry_lock obtained.
+*/
+static void burn_drive_lower_top(void)
+{
+	while (drivetop >= 0 &&
+	       drive_array[drivetop]->global_index == -1 &&
+	       drive_array[drivetop]->users == 0)
+		drivetop--;
+}
+
+
 void burn_drive_free_all(void)
 {
 	int i;
 
 	for (i = 0; i < drivetop + 1; i++)
-		burn_drive_free(&(drive_array[i]));
+		burn_drive_free(drive_array[i]);
+	pthread_mutex_lock(&drive_registry_lock);
+	burn_drive_lower_top();
+	pthread_mutex_unlock(&drive_registry_lock);
+}
+
+
+/* ts C61019 : Dispose the drive objects and the registry.
+   Drive objects which are still in use by a worker job get leaked.
+*/
+int burn_drive_registry_free(int flag)
+{
+	struct burn_drive_slots *slots, *next;
+	int i, leaked = 0;
+
+	burn_drive_free_all();
+	pthread_mutex_lock(&drive_registry_lock);
+	if (drive_slots != NULL) {
+		for (i = 0; i < drive_slots->size; i++) {
+			if (drive_slots->drive[i] == NULL)
+		continue;
+			if (drive_slots->drive[i]->users > 0) {
+				leaked++;
+		continue;
+			}
+			free((char *) drive_slots->drive[i]);
+		}
+	}
+	for (slots = drive_slots; slots != NULL; slots = next) {
+		next = slots->retired;
+		free((char *) slots);
+	}
+	drive_slots = NULL;
+	drive_array = NULL;
 	drivetop = -1;
-	memset(drive_array, 0, sizeof(drive_array));
+	pthread_mutex_unlock(&drive_registry_lock);
+	if (leaked)
+		libdax_msgs_submit(libdax_messenger, -1, 0x000201b7,
+			LIBDAX_MSGS_SEV_WARNING, LIBDAX_MSGS_PRIO_HIGH,
+			"Leaving drive object undisposed because it is still in use by a worker thread",
+			0, 0);
+	return 1;
+}
+
+
+/* ts C61019 : Count a worker job which uses the drive */
+int burn_drive_ref(struct burn_drive *d)
+{
+	pthread_mutex_lock(&drive_registry_lock);
+	d->users++;
+	pthread_mutex_unlock(&drive_registry_lock);
+	return 1;
+}
+
+
+/* ts C61019 : End of a worker job. Perform a deferred burn_drive_free().
+*/
+int burn_drive_unref(struct burn_drive *d)
+{
+	int do_free;
+
+	pthread_mutex_lock(&drive_registry_lock);
+	if (d->users > 0)
+		d->users--;
+	do_free = (d->users == 0 && d->free_pending);
+	pthread_mutex_unlock(&drive_registry_lock);
+	if (do_free) {
+		burn_drive_free(d);
+		pthread_mutex_lock(&drive_registry_lock);
+		burn_drive_lower_top();
+		pthread_mutex_unlock(&drive_registry_lock);
+	}
+	return 1;
+}
+
+
+/* ts C61019 : Provide a slot for a new drive, eventually by enlarging the
+   array of slots. To be called with drive_registry_lock obtained.
+   @return index of the slot, <0 failure
+*/
+static int burn_drive_registry_slot(int flag)
+{
+	struct burn_drive_slots *slots;
+	int i, size;
+
+	/* Look for an unused slot or a freed drive object */
+	size = drive_slots == NULL ? 0 : drive_slots->size;
+	for (i = 0; i < size; i++) {
+		if (drive_array[i] == NULL) {
+			drive_array[i] = calloc(1, sizeof(struct burn_drive));
+			if (drive_array[i] == NULL)
+				return -1;
+			return i;
+		}
+		if (drive_array[i]->global_index == -1 &&
+		    drive_array[i]->users == 0 && !drive_array[i]->free_pending)
+			return i;
+	}
+
+	size = size == 0 ? Libburn_drive_slotS : 2 * size;
+	slots = calloc(1, sizeof(struct burn_drive_slots) +
+			  (size - 1) * sizeof(struct burn_drive *));
+	if (slots == NULL)
+		return -1;
+	slots->size = size;
+	slots->retired = drive_slots;
+	if (drive_slots != NULL)
+		memcpy(slots->drive, drive_slots->drive,
+		       drive_slots->size * sizeof(struct burn_drive *));
+	slots->drive[i] = calloc(1, sizeof(struct burn_drive));
+	if (slots->drive[i] == NULL) {
+		free((char *) slots);
+		return -1;
+	}
+	/* Readers shall see the complete array */
+	Libburn_drive_barrieR;
+	drive_slots = slots;
+	drive_array = slots->drive;
+	return i;
 }
 
 
@@ -237,7 +441,7 @@ int burn_drive_is_occupied(struct burn_drive *d)
 /*
 void drive_read_lead_in(int dnum)
 {
-	mmc_read_lead_in(&drive_array[dnum], get_4k());
+	mmc_read_lead_in(drive_array[dnum], get_4k());
 }
 */
 unsigned int burn_drive_count(void)
@@ -259,14 +463,18 @@ int burn_drive_is_listed(char *path, struct burn_drive **found, int flag)
 	if (ret <= 0)
 		strcpy(off_adr, path);
 	for (i = 0; i <= drivetop; i++) {
-		if (drive_array[i].global_index < 0)
+		if (drive_array[i]->global_index < 0)
 	continue;
-		ret = burn_drive_d_get_adr(&(drive_array[i]), drive_adr);
+		/* ts C61019 : a vanished drive does not block its address */
+		if (drive_array[i]->hotplug_detached ||
+		    drive_array[i]->free_pending)
+	continue;
+		ret = burn_drive_d_get_adr(drive_array[i], drive_adr);
 		if (ret <= 0)
 	continue;
 		if(strcmp(off_adr, drive_adr) == 0) {
 			if (found != NULL)
-				*found= &(drive_array[i]);
+				*found= drive_array[i];
 			{ret= 1; goto ex;}
 		}
 	}
@@ -476,6 +684,14 @@ int burn_drive_grab(struct burn_drive *d, int le)
 	int ret, sose, signal_action_mem = -1;
 
 	sose = d->silent_on_scsi_error;
+	/* ts C61019 */
+	if (d->hotplug_detached) {
+		libdax_msgs_submit(libdax_messenger, d->global_index,
+				0x000201ba, LIBDAX_MSGS_SEV_SORRY,
+				LIBDAX_MSGS_PRIO_HIGH,
+				"Drive was detached from the system", 0, 0);
+		return 0;
+	}
 	if (!d->released) {
                 libdax_msgs_submit(libdax_messenger, d->global_index,
                                 0x00020189, LIBDAX_MSGS_SEV_FATAL,
@@ -483,6 +699,7 @@ int burn_drive_grab(struct burn_drive *d, int le)
 				"Drive is already grabbed by libburn", 0, 0);
 		return 0;
 	}
+	d->iso_head_valid = 0; /* ts C61019 : medium might have changed */
 	if(d->drive_role != 1) {
 		ret = burn_drive_grab_stdio(d, 0);
 		return ret;
@@ -534,14 +751,9 @@ ex:;
 }
 
 
-/* ts A71015 */
-#define Libburn_ticket_62_re_register_is_possiblE 1
-
 struct burn_drive *burn_drive_register(struct burn_drive *d)
 {
-#ifdef Libburn_ticket_62_re_register_is_possiblE
 	int i;
-#endif
 
 	d->block_types[0] = 0;
 	d->block_types[1] = 0;
@@ -558,48 +770,57 @@ struct burn_drive *burn_drive_register(struct burn_drive *d)
 	memset(&(d->thread_tid), 0, sizeof(d->thread_tid));
 	d->toc_entries = 0;
 	d->toc_entry = NULL;
+	d->toc_pending = 0;
 	d->disc = NULL;
 	d->erasable = 0;
 	d->write_opts = NULL;
 
-#ifdef Libburn_ticket_62_re_register_is_possiblE
-	/* ts A60904 : ticket 62, contribution by elmom */
-	/* Not yet accepted because no use case seen yet */
-        /* ts A71015 : xorriso dialog imposes a use case now */
+	d->users = 0;
+	d->free_pending = 0;
+	d->hotplug_detached = 0;
 
-	/* This is supposed to find an already freed drive struct among
-	   all the the ones that have been used before */
-	for (i = 0; i < drivetop + 1; i++)
-		if (drive_array[i].global_index == -1)
-			break;
+	/* ts A60904 : ticket 62, contribution by elmom */
+	/* ts A71015 : xorriso dialog imposes a use case now */
+	/* ts C61019 : The registry reuses freed drive objects and grows if
+	               none is available.
+	*/
+	pthread_mutex_lock(&drive_registry_lock);
+	i = burn_drive_registry_slot(0);
+	if (i < 0) {
+		pthread_mutex_unlock(&drive_registry_lock);
+		libdax_msgs_submit(libdax_messenger, -1, 0x00000003,
+			LIBDAX_MSGS_SEV_FATAL, LIBDAX_MSGS_PRIO_HIGH,
+			"Out of virtual memory", 0, 0);
+		return NULL;
+	}
 	d->global_index = i;
-	memcpy(&drive_array[i], d, sizeof(struct burn_drive));
-	pthread_mutex_init(&drive_array[i].access_lock, NULL);
+	memcpy(drive_array[i], d, sizeof(struct burn_drive));
+	pthread_mutex_init(&(drive_array[i]->access_lock), NULL);
+	Libburn_drive_barrieR;
 	if (drivetop < i)
 		drivetop = i;
-	return &(drive_array[i]);
-
-#else /* Libburn_ticket_62_re_register_is_possiblE */
-	/* old A60904 : */
-	/* Still active by default */
-
-	d->global_index = drivetop + 1;
-	memcpy(&drive_array[drivetop + 1], d, sizeof(struct burn_drive));
-	pthread_mutex_init(&drive_array[drivetop + 1].access_lock, NULL);
-	return &drive_array[++drivetop];
-
-#endif /* ! Libburn_ticket_62_re_register_is_possiblE */
-
+	pthread_mutex_unlock(&drive_registry_lock);
+	return drive_array[i];
 }
 
 
-/* unregister most recently registered drive */
+/* ts C61019 : Unregister any drive, not only the most recently registered
+   one. Its object gets reused by the next registration.
+*/
 int burn_drive_unregister(struct burn_drive *d)
 {
-	if(d->global_index != drivetop)
+	int idx;
+
+	idx = d->global_index;
+	if (idx < 0)
 		return 0;
 	burn_drive_free(d);
-	drivetop--;
+	if (d->global_index != -1)
+		return 2; /* disposal is deferred until the worker job ends */
+	pthread_mutex_lock(&drive_registry_lock);
+	if (idx == drivetop)
+		burn_drive_lower_top();
+	pthread_mutex_unlock(&drive_registry_lock);
 	return 1;
 }
 
@@ -617,6 +838,8 @@ struct burn_drive *burn_drive_finish_enum(struct burn_drive *d)
 	d->drive_role = 1; /* MMC drive */
 
 	t = burn_drive_register(d);
+	if (t == NULL)
+		goto ex;
 
 	/* ts A60821 */
 	mmc_function_spy(NULL, "enumerate_common : -------- doing grab");
@@ -666,6 +889,7 @@ int burn_drive_mark_unready(struct burn_drive *d, int flag)
 		free(d->toc_entry);
 	d->toc_entry = NULL;
 	d->toc_entries = 0;
+	d->toc_pending = 0;
 	if (d->write_opts != NULL) {
 		burn_write_opts_free(d->write_opts);
 		d->write_opts = NULL;
@@ -723,6 +947,7 @@ int burn_drive_release_fl(struct burn_drive *d, int flag)
 	}
 
 	d->needs_sync_cache = 0; /* just to be sure */
+	d->iso_head_valid = 0; /* ts C61019 */
 
 	if (d->drive_serial_number != NULL)
 		BURN_FREE_MEM(d->drive_serial_number);
@@ -810,9 +1035,9 @@ int burn_drives_are_clear(int flag)
 
 	for (i = burn_drive_count() - 1; i >= 0; --i) {
 		/* ts A60904 : ticket 62, contribution by elmom */
-		if (drive_array[i].global_index == -1)
+		if (drive_array[i]->global_index == -1)
 	continue;
-		if (drive_array[i].released && !(flag & 1))
+		if (drive_array[i]->released && !(flag & 1))
 	continue;
 		return 0;
 	}
@@ -845,10 +1070,98 @@ void burn_wait_all(void)
 #endif
 
 
+/* ts C61019 : Limits of the interval between two inquiries of the progress
+               of blanking or formatting. Short operations shall be noticed
+               soon after they ended. Long ones shall not be polled too often.
+*/
+#define Libburn_bg_poll_miN 0.01
+#define Libburn_bg_poll_maX 1.0
+
+/* ts C61019 : The interval is this fraction of the time elapsed since the
+               operation began, or of the predicted remaining time if that
+               is shorter.
+*/
+#define Libburn_bg_poll_elapseD 0.05
+#define Libburn_bg_poll_remaininG 0.25
+
+
+/* ts C61019
+   @param progress  The most recent progress of 1 to 0xffff, or <= 0 if none
+*/
+static double burn_drive_bg_poll_interval(struct burn_drive *d,
+                                          int progress, int flag)
+{
+	double elapsed, interval, remaining;
+
+	elapsed = d->bg_op_poll - d->bg_op_start;
+	interval = elapsed * Libburn_bg_poll_elapseD;
+	if (progress > 0 && progress < 0x10000 && elapsed > 0.0) {
+		remaining = elapsed * (0x10000 - progress) / progress;
+		if (remaining * Libburn_bg_poll_remaininG < interval)
+			interval = remaining * Libburn_bg_poll_remaininG;
+	}
+	if (interval < Libburn_bg_poll_miN)
+		interval = Libburn_bg_poll_miN;
+	if (interval > Libburn_bg_poll_maX)
+		interval = Libburn_bg_poll_maX;
+	return interval;
+}
+
+
+/* ts C61019 : Wait until the drive has finished blanking or formatting.
+   The caller has to set d->bg_op_start before issuing the SCSI command.
+   burn_drive_cancel() ends the waiting, but not the operation of the drive.
+   @param stages     Divisor for the progress reported by the drive
+   @param was_error  Gets set to 1 if the drive reported an error
+   @return 1 = drive is ready , 0 = waiting was cancelled
+*/
+static int burn_drive_wait_bg_op(struct burn_drive *d, int stages,
+                                 int *was_error, int flag)
+{
+	int ret, progress = -1, was_cancelled;
+
+	/* A failed SCSI command may have set d->cancel already */
+	was_cancelled = d->cancel;
+	d->bg_op_poll = d->bg_op_start;
+	d->bg_op_end = 0.0;
+	while (1) {
+		d->bg_op_next = burn_drive_bg_poll_interval(d, progress, 0);
+		usleep((unsigned long) (d->bg_op_next * 1.0e6));
+
+		ret = d->get_erase_progress(d);
+		d->bg_op_poll = burn_get_time(0);
+		if (ret == -2)
+	break;
+		if (ret == -3)
+			*was_error = 1;
+
+		/* Progress gets counted only after the drive reported some */
+		if (ret > 0 || (ret == 0 && progress > 0)) {
+			progress = ret;
+			d->progress.sector = progress / stages;
+			burn_drive_events_check(d, 0);
+		}
+
+		if (d->cancel && !was_cancelled) {
+			libdax_msgs_submit(libdax_messenger, d->global_index,
+				0x000201b4,
+				LIBDAX_MSGS_SEV_NOTE, LIBDAX_MSGS_PRIO_HIGH,
+				"Stopped waiting for blanking or formatting. The drive may still be busy.",
+				0, 0);
+			return 0;
+		}
+	}
+	d->bg_op_end = d->bg_op_poll;
+	d->bg_op_next = 0.0;
+	return 1;
+}
+
+
 void burn_disc_erase_sync(struct burn_drive *d, int fast)
 {
 	int ret, was_error = 0;
 
+	d->iso_head_valid = 0; /* ts C61019 */
 	if (d->drive_role == 5) { /* Random access write-only drive */
 		ret = truncate(d->devname, (off_t) 0);
 		if (ret == -1) {
@@ -864,6 +1177,7 @@ void burn_disc_erase_sync(struct burn_drive *d, int fast)
 		d->status = BURN_DISC_BLANK;
 		d->busy = BURN_DRIVE_IDLE;
 		d->progress.sector = 0x10000;
+		burn_drive_events_check(d, 1); /* ts C61019 */
 		return;
 	}
 
@@ -883,8 +1197,10 @@ void burn_disc_erase_sync(struct burn_drive *d, int fast)
 	d->progress.sector = 0;
 #endif /* Libburn_reset_progress_asynC */
 
+	d->bg_op_start = burn_get_time(0); /* ts C61019 */
 	d->erase(d, fast);
 	d->busy = BURN_DRIVE_ERASING;
+	burn_drive_events_check(d, 2); /* ts C61019 */
 
 #ifdef Libburn_old_progress_looP
 
@@ -897,36 +1213,8 @@ void burn_disc_erase_sync(struct burn_drive *d, int fast)
 
 #else /* Libburn_old_progress_looP */
 
-	while (1) {
-
-		/* >>> ??? ts B60730 : abort if user interrupts ?
-		if (d->cancel)
-	break;
-		*/
-
-		ret = d->get_erase_progress(d);
-		if (ret == -2 || ret > 0)
-	break;
-		if (ret == -3)
-			was_error = 1;
-		sleep(1);
-	}
-	while (1) {
-
-		/* >>> ??? ts B60730 : abort if user interrupts ?
-		if (d->cancel)
-	break;
-		*/
-
-		ret = d->get_erase_progress(d);
-		if(ret == -2)
-	break;
-		if (ret == -3)
-			was_error = 1;
-		if (ret >= 0)
-			d->progress.sector = ret;
-		sleep(1);
-        }
+	/* ts C61019 : adaptive polling instead of sleep(1), cancellable */
+	burn_drive_wait_bg_op(d, 1, &was_error, 0);
 
 #endif /* ! Libburn_old_progress_looP */
 
@@ -939,21 +1227,37 @@ void burn_disc_erase_sync(struct burn_drive *d, int fast)
 	d->busy = BURN_DRIVE_IDLE;
 	if (was_error)
 		d->cancel = 1;
+	burn_drive_events_check(d, 1); /* ts C61019 */
 }
 
+/* ts C61019 : Chunk sizes for filling formatted media with zeros.
+   They match the write chunk sizes Libburn_dvd_obS and Libburn_bd_re_obS
+   in write.c, which are known to work with normal writing.
+*/
+#define Libburn_zero_fill_dvd_secS 16
+#define Libburn_zero_fill_bd_secS  32
+
+/* ts C61019 : Seconds between progress updates while filling with zeros */
+#define Libburn_zero_fill_progresS 0.5
+
 /*
    @param flag: bit0 = fill formatted size with zeros
                 bit1, bit2 , bit4, bit5, bit7 - bit15 are for d->format_unit()
 */
 void burn_disc_format_sync(struct burn_drive *d, off_t size, int flag)
 {
-	int ret, buf_secs, err, i, stages = 1, pbase, pfill, pseudo_sector;
+	int ret, buf_secs, err, i, stages = 1, pbase, pfill;
 	int was_error = 0;
+#ifdef Libburn_old_progress_looP
+	int pseudo_sector;
+#endif
 	off_t num_bufs;
+	double start_time, last_time, now;
 	char msg[80];
 	struct buffer *buf = NULL, *buf_mem = d->buffer;
 
 	BURN_ALLOC_MEM(buf, struct buffer, 1);
+	d->iso_head_valid = 0; /* ts C61019 */
 
 #ifdef Libburn_reset_progress_asynC
 	/* <<< This is now done in async.c */
@@ -972,7 +1276,9 @@ void burn_disc_format_sync(struct burn_drive *d, off_t size, int flag)
 	stages = 1 + ((flag & 1) && size > 1024 * 1024);
 	d->cancel = 0;
 	d->busy = BURN_DRIVE_FORMATTING;
+	burn_drive_events_check(d, 2); /* ts C61019 */
 
+	d->bg_op_start = burn_get_time(0); /* ts C61019 */
 	ret = d->format_unit(d, size, flag & 0xfff6); /* forward bits */
 	if (ret <= 0)
 		d->cancel = 1;
@@ -989,24 +1295,10 @@ void burn_disc_format_sync(struct burn_drive *d, off_t size, int flag)
 
 #else /* Libburn_old_progress_looP */
 
-	while (1) {
-		ret = d->get_erase_progress(d);
-		if (ret == -2 || ret > 0)
-	break;
-		if (ret == -3)
-			was_error = 1;
-		sleep(1);
-	}
-	while (1) {
-		pseudo_sector = d->get_erase_progress(d);
-		if(pseudo_sector == -2)
-	break;
-		if (pseudo_sector == -3)
-			was_error = 1;
-		if (pseudo_sector >= 0)
-			d->progress.sector = pseudo_sector / stages;
-		sleep(1);
-        }
+	/* ts C61019 : adaptive polling instead of sleep(1), cancellable */
+	ret = burn_drive_wait_bg_op(d, stages, &was_error, 0);
+	if (ret <= 0)
+		goto ex;
 
 #endif /* ! Libburn_old_progress_looP */
 
@@ -1022,12 +1314,23 @@ void burn_disc_format_sync(struct burn_drive *d, off_t size, int flag)
 		/* write size in zeros */;
 		pbase = 0x8000 + 0x7fff * (stages == 1);
 		pfill = 0xffff - pbase;
-		buf_secs = 16; /* Must not be more than 16 */
+
+		/* ts C61019 : BD media take the same large chunks as with
+		               normal writing. DVD stay with 32 kB.
+		*/
+		buf_secs = Libburn_zero_fill_dvd_secS;
+		if (d->current_profile >= 0x40 && d->current_profile <= 0x43)
+			buf_secs = Libburn_zero_fill_bd_secS;
+		if (buf_secs * 2048 > BUFFER_SIZE)
+			buf_secs = BUFFER_SIZE / 2048;
 		num_bufs = size / buf_secs / 2048;
 		if (num_bufs > 0x7fffffff) {
 			d->cancel = 1;
 			goto ex;
 		}
+		/* A tail shorter than one chunk stays as it is. BD formats
+		   come in whole clusters of 32 sectors, so there it is empty.
+		*/
 
 		/* <<< */
 		sprintf(msg,
@@ -1043,6 +1346,7 @@ void burn_disc_format_sync(struct burn_drive *d, off_t size, int flag)
 		d->buffer->bytes = buf_secs * 2048;
 		d->buffer->sectors = buf_secs;
 		d->busy = BURN_DRIVE_WRITING;
+		start_time = last_time = burn_get_time(0);
 		for (i = 0; i < num_bufs; i++) {
 			d->nwa = i * buf_secs;
 			err = d->write(d, d->nwa, d->buffer);
@@ -1050,8 +1354,29 @@ void burn_disc_format_sync(struct burn_drive *d, off_t size, int flag)
 				d->cancel = 1;
 		break;
 			}
+
+			/* ts C61019 : Progress is of interest only a few
+			               times per second
+			*/
+			now = burn_get_time(0);
+			if (now - last_time < Libburn_zero_fill_progresS)
+		continue;
+			last_time = now;
 			d->progress.sector = pbase
 				+ pfill * ((double) i / (double) num_bufs);
+			burn_drive_events_check(d, 0); /* ts C61019 */
+		}
+		if (!d->cancel) {
+			now = burn_get_time(0);
+			sprintf(msg,
+			   "Zero filling took %.1f s , %.1f MB/s",
+			   now - start_time, now - start_time < 0.001 ? 0.0 :
+			   ((double) num_bufs * buf_secs) *
+			   2048.0 / 1.0e6 / (now - start_time));
+			libdax_msgs_submit(libdax_messenger, d->global_index,
+				0x00000002,
+				LIBDAX_MSGS_SEV_DEBUG, LIBDAX_MSGS_PRIO_ZERO,
+				msg, 0, 0);
 		}
 		d->sync_cache(d);
 		if (d->current_profile == 0x13 || d->current_profile == 0x1a) {
@@ -1068,6 +1393,7 @@ ex:;
 	d->buffer = buf_mem;
 	if (was_error)
 		d->cancel = 1;
+	burn_drive_events_check(d, 1); /* ts C61019 */
 	BURN_FREE_MEM(buf);
 }
 
@@ -1165,6 +1491,10 @@ enum burn_drive_status burn_drive_get_status(struct burn_drive *d,
 	if (p != NULL) {
 		memcpy(p, &(d->progress), sizeof(struct burn_progress));
 		/* TODO: add mutex */
+
+		/* ts C61019 : Tell write loops that the buffer fill is
+		               of interest */
+		d->status_inquiries++;
 	}
 	return d->busy;
 }
@@ -1344,7 +1674,9 @@ int burn_drive_probe_cd_write_modes(struct burn_drive_info *dinfo)
 
 
 /* ts A70907 : added parameter flag */
-/* @param flag bit0= reset global drive list */
+/* @param flag bit0= reset global drive list
+               bit1= the caller holds enumeration_lock
+*/
 int burn_drive_scan_sync(struct burn_drive_info *drives[],
 			 unsigned int *n_drives, int flag)
 {
@@ -1369,7 +1701,13 @@ int burn_drive_scan_sync(struct burn_drive_info *drives[],
 	   static int scanned = 0, found = 0;
 	   Variable "found" was only set but never read.
 	*/
-	unsigned char scanned[32];
+	/* ts C61019 : one byte per registered drive rather than a bitmap of
+	               255 drives. Drives which get registered by the
+	               enumeration have indices beyond known_top or reuse
+	               slots which were unused.
+	*/
+	unsigned char *scanned = NULL;
+	int known_top = -1;
 	unsigned count = 0;
 	int i, ret;
 
@@ -1389,20 +1727,31 @@ int burn_drive_scan_sync(struct burn_drive_info *drives[],
 	*n_drives = 0;
 
 	/* ts A70907 : wether to scan from scratch or to extend */
-	for (i = 0; i < (int) sizeof(scanned); i++)
-		scanned[i] = 0;
 	if (flag & 1) {
 		burn_drive_free_all();
-	} else {
-		for (i = 0; i <= drivetop; i++) 
-			if (drive_array[i].global_index >= 0)
-				scanned[i / 8] |=  (1 << (i % 8));
+	} else if (drivetop >= 0) {
+		known_top = drivetop;
+		scanned = calloc(known_top + 1, 1);
+		if (scanned == NULL) {
+	       		libdax_msgs_submit(libdax_messenger, -1, 0x00000003,
+	               			LIBDAX_MSGS_SEV_FATAL,
+					LIBDAX_MSGS_PRIO_HIGH,
+					"Out of virtual memory", 0, 0);
+			return -1;
+		}
+		for (i = 0; i <= known_top; i++) 
+			if (drive_array[i]->global_index >= 0)
+				scanned[i] = 1;
 	}
 
 	/* refresh the lib's drives */
 
 	/* ts A61115 : formerly sg_enumerate(); ata_enumerate(); */
+	if (!(flag & 2))
+		pthread_mutex_lock(&enumeration_lock);
 	scsi_enumerate_drives();
+	if (!(flag & 2))
+		pthread_mutex_unlock(&enumeration_lock);
 
 	count = burn_drive_count();
 	if (count) {
@@ -1415,6 +1764,8 @@ int burn_drive_scan_sync(struct burn_drive_info *drives[],
 	               			LIBDAX_MSGS_SEV_FATAL,
 					LIBDAX_MSGS_PRIO_HIGH,
 					"Out of virtual memory", 0, 0);
+			if (scanned != NULL)
+				free((char *) scanned);
 			return -1;
 		} else
 			for (i = 0; i <= (int) count; i++) /* invalidate */
@@ -1423,31 +1774,180 @@ int burn_drive_scan_sync(struct burn_drive_info *drives[],
 		*drives = NULL;
 
 	for (i = 0; i < (int) count; ++i) {
-		if (scanned[i / 8] & (1 << (i % 8)))
+		if (i <= known_top && scanned[i])
 	continue;		/* device already scanned by previous run */
-		if (drive_array[i].global_index < 0)
+		if (drive_array[i]->global_index < 0)
 	continue;		/* invalid device */
+		if (drive_array[i]->hotplug_detached)
+	continue;		/* device has vanished */
 
 		/* ts A90602 : This old loop is not plausible. See A70907.
-		  while (!drive_getcaps(&drive_array[i],
+		  while (!drive_getcaps(drive_array[i],
 		         &(*drives)[*n_drives])) {
 			sleep(1);
 		  }
 		*/
 		/* ts A90602 : A single call shall do (rather than a loop) */
-		ret = drive_getcaps(&drive_array[i], &(*drives)[*n_drives]);
+		ret = drive_getcaps(drive_array[i], &(*drives)[*n_drives]);
 		if (ret > 0)
 			(*n_drives)++;
-		scanned[i / 8] |= 1 << (i % 8);
 	}
 	if (*drives != NULL && *n_drives == 0) {
 		free ((char *) *drives);
 		*drives = NULL;
 	}
+	if (scanned != NULL)
+		free((char *) scanned);
 
 	return(1);
 }
 
+
+/* ts C61019 : Manage the list of addresses which await their drive.
+   @param flag bit0= remove adr rather than adding it
+               bit1= remove all addresses
+   @return 1= list was changed, 0= not
+*/
+static int burn_drive_hotplug_pending(char *adr, int flag)
+{
+	int i;
+
+	if (flag & 2) {
+		for (i = 0; i < hotplug_pending_count; i++)
+			free(hotplug_pending[i]);
+		hotplug_pending_count = 0;
+		return 1;
+	}
+	for (i = 0; i < hotplug_pending_count; i++)
+		if (strcmp(hotplug_pending[i], adr) == 0)
+	break;
+	if (flag & 1) {
+		if (i >= hotplug_pending_count)
+			return 0;
+		free(hotplug_pending[i]);
+		hotplug_pending_count--;
+		for (; i < hotplug_pending_count; i++)
+			hotplug_pending[i] = hotplug_pending[i + 1];
+		return 1;
+	}
+	if (i < hotplug_pending_count ||
+	    hotplug_pending_count >= Libburn_hotplug_pendinG)
+		return 0;
+	hotplug_pending[i] = strdup(adr);
+	if (hotplug_pending[i] == NULL)
+		return 0;
+	hotplug_pending_count++;
+	return 1;
+}
+
+
+/* ts C61019 API */
+int burn_drive_hotplug_listen(int on, int flag)
+{
+	int ret, fd = -1;
+
+	if (!on) {
+		sg_hotplug_close(0);
+		hotplug_retry_until = 0.0;
+		burn_drive_hotplug_pending(NULL, 2);
+		return 0;
+	}
+	ret = sg_hotplug_open(&fd, 0);
+	if (ret == 0)
+		return -1;
+	if (ret < 0 || fd < 0)
+		return -2;
+	return fd;
+}
+
+
+/* ts C61019 API */
+int burn_drive_hotplug_check(struct burn_drive_info *drive_infos[],
+                             unsigned int *n_drives, int flag)
+{
+	int ret, action, attached = 0, events = 0, i, count;
+	char *adr = NULL, *msg = NULL, *adrs[Libburn_hotplug_pendinG];
+	struct burn_drive *d;
+	struct stat stbuf;
+	double now;
+
+	*drive_infos = NULL;
+	*n_drives = 0;
+	BURN_ALLOC_MEM(adr, char, BURN_DRIVE_ADR_LEN);
+	BURN_ALLOC_MEM(msg, char, BURN_DRIVE_ADR_LEN + 80);
+
+	while (1) {
+		ret = sg_hotplug_read(&action, adr, BURN_DRIVE_ADR_LEN, 0);
+		if (ret < 0)
+			goto ex;
+		if (ret == 0)
+	break;
+		events = 1;
+		if (action == 1) {
+			/* The whitelist of the application applies */
+			if (burn_drive_is_banned(adr) ||
+			    burn_drive_is_listed(adr, NULL, 0) > 0)
+	continue;
+			if (burn_drive_hotplug_pending(adr, 0) > 0)
+				attached = 1;
+	continue;
+		}
+		burn_drive_hotplug_pending(adr, 1);
+		if (burn_drive_is_listed(adr, &d, 0) <= 0)
+	continue;
+		d->hotplug_detached = 1;
+		sprintf(msg, "Drive was detached from the system: %s", adr);
+		libdax_msgs_submit(libdax_messenger, d->global_index,
+			0x000201b8,
+			LIBDAX_MSGS_SEV_NOTE, LIBDAX_MSGS_PRIO_HIGH,
+			msg, 0, 0);
+	}
+
+	now = burn_get_time(0);
+	if (attached)
+		hotplug_retry_until = now + Libburn_hotplug_retrY;
+	else if (hotplug_retry_until > 0.0 && now > hotplug_retry_until)
+		burn_drive_hotplug_pending(NULL, 2);
+	if (hotplug_pending_count <= 0) {
+		hotplug_retry_until = 0.0;
+		{ret = events; goto ex;}
+	}
+
+	/* The kernel announces the device before it is ready for use.
+	   So a drive which is not found yet gets searched again by the
+	   next calls until Libburn_hotplug_retrY seconds have passed.
+	   Only the announced addresses get scanned, and only after their
+	   device file appeared.
+	*/
+	count = 0;
+	for (i = 0; i < hotplug_pending_count; i++)
+		if (stat(hotplug_pending[i], &stbuf) != -1)
+			adrs[count++] = hotplug_pending[i];
+	if (count == 0)
+		{ret = 2; goto ex;}
+	ret = burn_drive_scan_adr_list(adrs, count, drive_infos, n_drives, 0);
+	if (ret <= 0)
+		goto ex;
+	for (i = hotplug_pending_count - 1; i >= 0; i--)
+		if (burn_drive_is_listed(hotplug_pending[i], NULL, 0) > 0)
+			burn_drive_hotplug_pending(hotplug_pending[i], 1);
+	if (hotplug_pending_count > 0)
+		{ret = 2; goto ex;}
+	hotplug_retry_until = 0.0;
+	ret = 1;
+ex:;
+	BURN_FREE_MEM(adr);
+	BURN_FREE_MEM(msg);
+	return ret;
+}
+
+
+/* ts C61019 API */
+int burn_drive_is_detached(struct burn_drive *d)
+{
+	return !!d->hotplug_detached;
+}
+
 /* ts A61001 : internal call */
 int burn_drive_forget(struct burn_drive *d, int force)
 {
@@ -1542,6 +2042,10 @@ void burn_drive_info_free(struct burn_drive_info drive_infos[])
 
 struct burn_disc *burn_drive_get_disc(struct burn_drive *d)
 {
+	/* ts C61019 : DVD and BD get their TOC built on first demand */
+	if (d->toc_pending)
+		mmc_complete_toc(d, 0);
+
 	/* ts A61022: SIGSEGV on calling this function with blank media */
 	if(d->disc == NULL)
 		return NULL;
@@ -1553,9 +2057,14 @@ struct burn_disc *burn_drive_get_disc(struct burn_drive *d)
 void burn_drive_set_speed(struct burn_drive *d, int r, int w)
 {
 	d->nominal_write_speed = w;
+	d->user_write_speed = w; /* ts C61019 */
 	if(d->drive_role != 1)
 		return;
 	d->set_speed(d, r, w);
+	/* ts C61019 : Keep the speed which the drive resolved from w,
+	               before autotuning changes nominal_write_speed
+	*/
+	d->user_write_speed = d->nominal_write_speed;
 }
 
 
@@ -1615,17 +2124,20 @@ void burn_sectors_to_msf(int sectors, int *m, int *s, int *f)
 
 int burn_drive_get_read_speed(struct burn_drive *d)
 {
+	mmc_get_pending_performance(d, 0); /* ts C61019 */
 	return d->mdata->max_read_speed;
 }
 
 int burn_drive_get_write_speed(struct burn_drive *d)
 {
+	mmc_get_pending_performance(d, 0); /* ts C61019 */
 	return d->mdata->max_write_speed;
 }
 
 /* ts A61021 : New API function */
 int burn_drive_get_min_write_speed(struct burn_drive *d)
 {
+	mmc_get_pending_performance(d, 0); /* ts C61019 */
 	return d->mdata->min_write_speed;
 }
 
@@ -1634,11 +2146,8 @@ int burn_drive_get_min_write_speed(struct burn_drive *d)
 static char *enumeration_whitelist[BURN_DRIVE_WHITELIST_LEN];
 static int enumeration_whitelist_top = -1;
 
-/** Add a device to the list of permissible drives. As soon as some entry is in
-    the whitelist all non-listed drives are banned from enumeration.
-    @return 1 success, <=0 failure
-*/
-int burn_drive_add_whitelist(char *device_address)
+/* ts C61019 : To be called with enumeration_lock held */
+static int burn_drive_whitelist_add(char *device_address)
 {
 	char *new_item;
 	if(enumeration_whitelist_top+1 >= BURN_DRIVE_WHITELIST_LEN)
@@ -1652,8 +2161,8 @@ int burn_drive_add_whitelist(char *device_address)
 	return 1;
 }
 
-/** Remove all drives from whitelist. This enables all possible drives. */
-void burn_drive_clear_whitelist(void)
+/* ts C61019 : To be called with enumeration_lock held */
+static void burn_drive_whitelist_clear(void)
 {
 	int i;
 	for (i = 0; i <= enumeration_whitelist_top; i++)
@@ -1661,6 +2170,28 @@ void burn_drive_clear_whitelist(void)
 	enumeration_whitelist_top = -1;
 }
 
+/** Add a device to the list of permissible drives. As soon as some entry is in
+    the whitelist all non-listed drives are banned from enumeration.
+    @return 1 success, <=0 failure
+*/
+int burn_drive_add_whitelist(char *device_address)
+{
+	int ret;
+
+	pthread_mutex_lock(&enumeration_lock);
+	ret = burn_drive_whitelist_add(device_address);
+	pthread_mutex_unlock(&enumeration_lock);
+	return ret;
+}
+
+/** Remove all drives from whitelist. This enables all possible drives. */
+void burn_drive_clear_whitelist(void)
+{
+	pthread_mutex_lock(&enumeration_lock);
+	burn_drive_whitelist_clear();
+	pthread_mutex_unlock(&enumeration_lock);
+}
+
 int burn_drive_is_banned(char *device_address)
 {
 	int i;
@@ -1687,6 +2218,41 @@ char *burn_drive_whitelist_item(int idx, int flag)
 }
 
 
+/* ts C61019 : Scan only the given addresses like burn_drive_scan_sync()
+   with drives left known. The whitelist of the application gets restored
+   afterwards. enumeration_lock keeps other scans from seeing the
+   temporary whitelist.
+*/
+static int burn_drive_scan_adr_list(char **adrs, int count,
+				    struct burn_drive_info *drive_infos[],
+				    unsigned int *n_drives, int flag)
+{
+	char *saved[BURN_DRIVE_WHITELIST_LEN];
+	int saved_top, i, ret;
+
+	*drive_infos = NULL;
+	*n_drives = 0;
+	pthread_mutex_lock(&enumeration_lock);
+	saved_top = enumeration_whitelist_top;
+	for (i = 0; i <= saved_top; i++)
+		saved[i] = enumeration_whitelist[i];
+	enumeration_whitelist_top = -1;
+	for (i = 0; i < count; i++) {
+		ret = burn_drive_whitelist_add(adrs[i]);
+		if (ret <= 0)
+			{ret = -1; goto ex;}
+	}
+	ret = burn_drive_scan_sync(drive_infos, n_drives, 2);
+ex:;
+	burn_drive_whitelist_clear();
+	for (i = 0; i <= saved_top; i++)
+		enumeration_whitelist[i] = saved[i];
+	enumeration_whitelist_top = saved_top;
+	pthread_mutex_unlock(&enumeration_lock);
+	return ret;
+}
+
+
 static int burn_role_by_access(char *fname, int flag)
 {
 /* We normally need _LARGEFILE64_SOURCE defined by the build system.
@@ -1879,8 +2445,10 @@ int burn_drive_scan_and_grab(struct burn_drive_info *drive_infos[], char* adr,
 
 	/* check wether drive address is already registered */
 	for (i = 0; i <= drivetop; i++)
-		if (drive_array[i].global_index >= 0)
-			if (strcmp(drive_array[i].devname, adr) == 0)
+		if (drive_array[i]->global_index >= 0 &&
+		    !drive_array[i]->hotplug_detached &&
+		    !drive_array[i]->free_pending)
+			if (strcmp(drive_array[i]->devname, adr) == 0)
 	break;
 	if (i <= drivetop) {
 		libdax_msgs_submit(libdax_messenger, i,
@@ -1896,15 +2464,19 @@ int burn_drive_scan_and_grab(struct burn_drive_info *drive_infos[], char* adr,
 		return ret;
 	}
 
-	burn_drive_clear_whitelist();
-	burn_drive_add_whitelist(adr);
+	/* ts C61019 : No other scan may see or change the whitelist before
+	               this scan is done */
+	pthread_mutex_lock(&enumeration_lock);
+	burn_drive_whitelist_clear();
+	burn_drive_whitelist_add(adr);
 /*
 	fprintf(stderr,"libburn: experimental: burn_drive_scan_and_grab(%s)\n",
 		adr);
 */
 
 	/* ts A70907 : now calling synchronously rather than looping */
-	ret = burn_drive_scan_sync(drive_infos, &n_drives, 0);
+	ret = burn_drive_scan_sync(drive_infos, &n_drives, 2);
+	pthread_mutex_unlock(&enumeration_lock);
 	if (ret < 0)
 		return -1;
 
@@ -2121,19 +2693,19 @@ int burn_drive_obtain_scsi_adr(char *path,
 
 	/* open drives cannot be inquired by sg_obtain_scsi_adr() */
 	for (i = 0; i < drivetop + 1; i++) {
-		if (drive_array[i].global_index < 0)
+		if (drive_array[i]->global_index < 0)
 	continue;
-		ret = burn_drive_d_get_adr(&(drive_array[i]),adr);
+		ret = burn_drive_d_get_adr(drive_array[i],adr);
 		if (ret < 0)
 			{ret = 1; goto ex;}
 		if (ret == 0)
 	continue;
 		if (strcmp(adr, path) == 0) {
-			*host_no = drive_array[i].host;
-			*channel_no = drive_array[i].channel;
-			*target_no = drive_array[i].id;
-			*lun_no = drive_array[i].lun;
-			*bus_no = drive_array[i].bus_no;
+			*host_no = drive_array[i]->host;
+			*channel_no = drive_array[i]->channel;
+			*target_no = drive_array[i]->id;
+			*lun_no = drive_array[i]->lun;
+			*bus_no = drive_array[i]->bus_no;
 			if (*host_no < 0 || *channel_no < 0 ||
 			    *target_no < 0 || *lun_no < 0)
 				{ret = 0; goto ex;}
@@ -2417,11 +2989,11 @@ int burn_abort_5(int patience,
 		still_not_done = 0;
 
 		for(i = 0; i < drivetop + 1; i++) {
-			occup = burn_drive_is_occupied(&(drive_array[i]));
+			occup = burn_drive_is_occupied(drive_array[i]);
 			if(occup == -2)
 		continue;
 
-			if(drive_array[i].drive_role != 1) {
+			if(drive_array[i]->drive_role != 1) {
 
 #ifdef NIX
 
@@ -2429,8 +3001,8 @@ int burn_abort_5(int patience,
 				   <<< this causes a race condition with drive
 				       usage and drive disposal.
 			  	*/
-				drive_array[i].busy = BURN_DRIVE_IDLE;
-				burn_drive_forget(&(drive_array[i]), 1);
+				drive_array[i]->busy = BURN_DRIVE_IDLE;
+				burn_drive_forget(drive_array[i], 1);
 		continue;
 
 #else /* NIX */
@@ -2443,7 +3015,7 @@ int burn_abort_5(int patience,
 			  	*/
 				if (current_time - start_time >
 				    stdio_patience) {
-					drive_array[i].global_index = -1;
+					drive_array[i]->global_index = -1;
 		continue;
 				}
 
@@ -2452,15 +3024,15 @@ int burn_abort_5(int patience,
 			}
 
 			if(occup < 10) {
-				if (!drive_array[i].cancel)
-					burn_drive_cancel(&(drive_array[i]));
-				if (drive_array[i].drive_role != 1)
+				if (!drive_array[i]->cancel)
+					burn_drive_cancel(drive_array[i]);
+				if (drive_array[i]->drive_role != 1)
 		 			/* occup == -1 comes early */
 					usleep(1000000);
-				burn_drive_forget(&(drive_array[i]), 1);
+				burn_drive_forget(drive_array[i], 1);
 			} else if(occup <= 100) {
-				if (!drive_array[i].cancel)
-					burn_drive_cancel(&(drive_array[i]));
+				if (!drive_array[i]->cancel)
+					burn_drive_cancel(drive_array[i]);
 				still_not_done++;
 			} else if(occup <= 1000) {
 				still_not_done++;
@@ -2727,6 +3299,23 @@ int burn_drive_wrote_well(struct burn_drive *d)
 }
 
 
+/* ts C61019 API */
+int burn_drive_get_bg_op_times(struct burn_drive *d, double *start_time,
+                               double *poll_time, double *end_time,
+                               double *next_poll, int flag)
+{
+	*start_time = d->bg_op_start;
+	*poll_time = d->bg_op_poll;
+	*end_time = d->bg_op_end;
+	*next_poll = d->bg_op_next;
+	if (d->bg_op_start <= 0.0)
+		return 0;
+	if (d->bg_op_end > 0.0)
+		return 1;
+	return 2;
+}
+
+
 /* ts A61226 */
 int burn_speed_descriptor_new(struct burn_speed_descriptor **s,
 			struct burn_speed_descriptor *prev,
@@ -2817,6 +3406,7 @@ int burn_drive_get_speedlist(struct burn_drive *d,
 	struct burn_speed_descriptor *sd, *csd = NULL;
 
 	(*speed_list) = NULL;
+	mmc_get_pending_performance(d, 0); /* ts C61019 */
 	for (sd = d->mdata->speed_descriptors; sd != NULL; sd = sd->next) {
 		ret = burn_speed_descriptor_new(&csd, NULL, csd, 0);
 		if (ret <= 0)
@@ -2840,6 +3430,7 @@ int burn_drive_get_best_speed(struct burn_drive *d, int speed_goal,
 	if (speed_goal < 0)
 		best_speed = 2000000000;
 	*best_descr = NULL;
+	mmc_get_pending_performance(d, 0); /* ts C61019 */
 	for (sd = d->mdata->speed_descriptors; sd != NULL; sd = sd->next) {
 		if (flag & 1)
 			speed = sd->read_speed;
@@ -3332,14 +3923,14 @@ int burn_drive_find_by_thread_pid(struct burn_drive **d, pid_t pid,
 	for (i = 0; i < drivetop + 1; i++) {
 
 /*
-		if (drive_array[i].thread_pid_valid)
-			fprintf(stderr, "libburn_EXPERIMENTAL : drive %d , thread_pid %d\n", i, drive_array[i].thread_pid);
+		if (drive_array[i]->thread_pid_valid)
+			fprintf(stderr, "libburn_EXPERIMENTAL : drive %d , thread_pid %d\n", i, drive_array[i]->thread_pid);
 */
 
-		if (drive_array[i].thread_pid_valid &&
-		    drive_array[i].thread_pid == pid &&
-		    pthread_equal(drive_array[i].thread_tid, tid)) {
-			*d = &(drive_array[i]);
+		if (drive_array[i]->thread_pid_valid &&
+		    drive_array[i]->thread_pid == pid &&
+		    pthread_equal(drive_array[i]->thread_tid, tid)) {
+			*d = drive_array[i];
 			return 1;
 		}
 	}
@@ -61,6 +61,17 @@ void burn_write_empty_subcode(int fd);
 void burn_drive_free(struct burn_drive *d);
 void burn_drive_free_all(void);
 
+/* ts C61019 */
+/* Dispose all drive objects and the registry. For burn_finish(). */
+int burn_drive_registry_free(int flag);
+
+/* ts C61019 */
+/* Count resp. uncount a worker job which uses the drive object.
+   burn_drive_free() gets deferred until the last job has ended.
+*/
+int burn_drive_ref(struct burn_drive *d);
+int burn_drive_unref(struct burn_drive *d);
+
 /* @param flag bit0= reset global drive list */
 int burn_drive_scan_sync(struct burn_drive_info *drives[],
 			 unsigned int *n_drives, int flag);
@@ -0,0 +1,259 @@
+/* -*- indent-tabs-mode: t; tab-width: 8; c-basic-offset: 8; -*- */
+
+/* Copyright (c) 2026 Thomas Schmitt <scdbackup@gmx.net>
+   Provided under GPL version 2 or later.
+*/
+
+/* ts C61019 : Event delivery for drives. See burn_drive_set_event_handler().
+*/
+
+#ifdef HAVE_CONFIG_H
+#include "../config.h"
+#endif
+
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/types.h>
+
+#include "libburn.h"
+#include "transport.h"
+#include "file.h"
+#include "util.h"
+#include "init.h"
+#include "event.h"
+
+#include "libdax_msgs.h"
+extern struct libdax_msgs *libdax_messenger;
+
+
+#ifdef __GNUC__
+#define Libburn_event_barrieR __sync_synchronize()
+#else
+#define Libburn_event_barrieR
+#endif
+
+
+int burn_drive_events_destroy(struct burn_drive *d, int flag)
+{
+	struct burn_drive_events *e = d->events;
+
+	if (e == NULL)
+		return 0;
+	d->events = NULL;
+	if (e->pipe_fds[0] != -1)
+		close(e->pipe_fds[0]);
+	if (e->pipe_fds[1] != -1)
+		close(e->pipe_fds[1]);
+	free((char *) e);
+	return 1;
+}
+
+
+/* API */
+int burn_drive_set_event_handler(struct burn_drive *d,
+                int (*handler)(void *handle, struct burn_drive_event *event),
+                void *handle, int sector_step, int flag)
+{
+	struct burn_drive_events *e;
+	int ret;
+
+	if (d->busy != BURN_DRIVE_IDLE) {
+		libdax_msgs_submit(libdax_messenger, d->global_index,
+			0x00020102,
+			LIBDAX_MSGS_SEV_SORRY, LIBDAX_MSGS_PRIO_HIGH,
+			"A drive operation is still going on (want to set event handler)",
+			0, 0);
+		return 0;
+	}
+	if (handler == NULL && !(flag & 1)) {
+		burn_drive_events_destroy(d, 0);
+		return 1;
+	}
+	e = d->events;
+	if (e == NULL) {
+		e = calloc(1, sizeof(struct burn_drive_events));
+		if (e == NULL) {
+			libdax_msgs_submit(libdax_messenger, d->global_index,
+				0x00000003,
+				LIBDAX_MSGS_SEV_FATAL, LIBDAX_MSGS_PRIO_HIGH,
+				"Out of virtual memory", 0, 0);
+			return -1;
+		}
+		e->pipe_fds[0] = e->pipe_fds[1] = -1;
+		e->queue_write = e->queue_read = 0;
+		e->lost = 0;
+		e->fifo = NULL;
+	}
+	e->last_status = d->busy;
+	e->last_sector = -1;
+	e->last_track = -1;
+	e->cancel_reported = 0;
+	e->handler = handler;
+	e->handle = handle;
+	e->sector_step = sector_step > 0 ? sector_step :
+	                                   Libburn_drive_event_steP;
+	e->use_queue = !!(flag & 1);
+	if (e->use_queue && e->pipe_fds[0] == -1) {
+		ret = pipe(e->pipe_fds);
+		if (ret == -1) {
+			libdax_msgs_submit(libdax_messenger, d->global_index,
+				0x000201ad,
+				LIBDAX_MSGS_SEV_FAILURE, LIBDAX_MSGS_PRIO_HIGH,
+				"Cannot create pipe for drive events",
+				errno, 0);
+			e->pipe_fds[0] = e->pipe_fds[1] = -1;
+			if (d->events == NULL)
+				free((char *) e);
+			return -1;
+		}
+		/* The worker thread shall never block on a full pipe */
+		fcntl(e->pipe_fds[1], F_SETFL,
+		      fcntl(e->pipe_fds[1], F_GETFL) | O_NONBLOCK);
+		fcntl(e->pipe_fds[0], F_SETFL,
+		      fcntl(e->pipe_fds[0], F_GETFL) | O_NONBLOCK);
+	}
+	d->events = e;
+	return 1;
+}
+
+
+/* API */
+int burn_drive_get_event_fd(struct burn_drive *d, int flag)
+{
+	if (d->events == NULL || !d->events->use_queue)
+		return -1;
+	return d->events->pipe_fds[0];
+}
+
+
+/* API */
+int burn_drive_get_event(struct burn_drive *d,
+                         struct burn_drive_event *event, int flag)
+{
+	struct burn_drive_events *e = d->events;
+	int rpos;
+	char dummy[64];
+
+	if (e == NULL || !e->use_queue)
+		return -1;
+	rpos = e->queue_read;
+	if (rpos == e->queue_write) {
+		/* Consume the notifications. Events which arrive after the
+		   emptiness check will write a new byte.
+		*/
+		while (read(e->pipe_fds[0], dummy, sizeof(dummy)) > 0);
+		if (rpos == e->queue_write)
+			return 0;
+	}
+	Libburn_event_barrieR;
+	memcpy(event, &(e->queue[rpos]), sizeof(struct burn_drive_event));
+	Libburn_event_barrieR;
+	e->queue_read = (rpos + 1) % Libburn_drive_event_queuE;
+	return 1;
+}
+
+
+int burn_drive_events_set_source(struct burn_drive *d,
+                                 struct burn_source *src, int flag)
+{
+	if (d->events == NULL)
+		return 0;
+	if (src != NULL)
+		src = burn_source_get_fifo(src, 0);
+	d->events->fifo = src;
+	return 1;
+}
+
+
+static int burn_drive_events_put(struct burn_drive *d, int type, int flag)
+{
+	struct burn_drive_events *e = d->events;
+	struct burn_drive_event ev;
+	int ret, wpos, next, used, size = -1, free_bytes = -1;
+	char *status_text;
+
+	memset(&ev, 0, sizeof(ev));
+	ev.type = type;
+	ev.status = d->busy;
+	ev.timestamp = burn_get_time(0);
+	ev.track = d->progress.track;
+	ev.start_sector = d->progress.start_sector;
+	ev.sectors = d->progress.sectors;
+	ev.sector = d->progress.sector;
+	ev.buffered_bytes = d->progress.buffered_bytes;
+	ev.buffer_capacity = d->progress.buffer_capacity;
+	ev.buffer_available = d->progress.buffer_available;
+	if (e->fifo != NULL) {
+		ret = burn_fifo_inquire_status(e->fifo, &size, &free_bytes,
+		                               &status_text);
+		if (ret < 0)
+			size = free_bytes = -1;
+	}
+	ev.fifo_size = size;
+	ev.fifo_free = free_bytes;
+	ev.success = !d->cancel;
+
+	if (e->handler != NULL) {
+		ev.lost = 0;
+		(*e->handler)(e->handle, &ev);
+	}
+	if (!e->use_queue)
+		return 1;
+
+	wpos = e->queue_write;
+	next = (wpos + 1) % Libburn_drive_event_queuE;
+	used = wpos - e->queue_read;
+	if (used < 0)
+		used += Libburn_drive_event_queuE;
+	/* Progress gets outdated anyway. Keep room for the other types. */
+	if (next == e->queue_read || (type == BURN_EVENT_PROGRESS &&
+	    used >= Libburn_drive_event_queuE - Libburn_drive_event_reservE)) {
+		e->lost++;
+		return 0;
+	}
+	ev.lost = e->lost;
+	e->lost = 0;
+	memcpy(&(e->queue[wpos]), &ev, sizeof(struct burn_drive_event));
+	Libburn_event_barrieR;
+	e->queue_write = next;
+	/* A full pipe is readable anyway. So the outcome does not matter. */
+	ret = write(e->pipe_fds[1], "e", 1);
+	return 1;
+}
+
+
+int burn_drive_events_check(struct burn_drive *d, int flag)
+{
+	struct burn_drive_events *e = d->events;
+
+	if (e == NULL)
+		return 0;
+	if (d->busy != e->last_status) {
+		e->last_status = d->busy;
+		burn_drive_events_put(d, BURN_EVENT_STATE, 0);
+	}
+	if (d->cancel && !e->cancel_reported) {
+		e->cancel_reported = 1;
+		burn_drive_events_put(d, BURN_EVENT_ERROR, 0);
+	}
+	if ((flag & 2) || e->last_sector < 0 ||
+	    d->progress.track != e->last_track ||
+	    d->progress.sector - e->last_sector >= e->sector_step ||
+	    d->progress.sector < e->last_sector) {
+		e->last_sector = d->progress.sector;
+		e->last_track = d->progress.track;
+		burn_drive_events_put(d, BURN_EVENT_PROGRESS, 0);
+	}
+	if (flag & 1) {
+		burn_drive_events_put(d, BURN_EVENT_END, 0);
+		e->fifo = NULL;
+		e->last_sector = -1;
+		e->last_track = -1;
+		e->cancel_reported = 0;
+	}
+	return 1;
+}
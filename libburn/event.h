@@ -0,0 +1,71 @@
+/* -*- indent-tabs-mode: t; tab-width: 8; c-basic-offset: 8; -*- */
+
+/* Copyright (c) 2026 Thomas Schmitt <scdbackup@gmx.net>
+   Provided under GPL version 2 or later.
+*/
+
+/* ts C61019 : Delivery of drive events to a callback function or to a
+               queue which can be watched by poll(2) via a pipe.
+*/
+
+#ifndef BURN__EVENT_H
+#define BURN__EVENT_H
+
+struct burn_drive;
+struct burn_source;
+
+
+/* Number of events which can wait in the queue of a drive */
+#define Libburn_drive_event_queuE 64
+
+/* Number of queue slots which BURN_EVENT_PROGRESS may not occupy */
+#define Libburn_drive_event_reservE 8
+
+/* Default distance of BURN_EVENT_PROGRESS in sectors */
+#define Libburn_drive_event_steP 512
+
+
+struct burn_drive_events {
+
+	int (*handler)(void *handle, struct burn_drive_event *event);
+	void *handle;
+	int sector_step;
+
+	/* Queue for burn_drive_get_event(). The write index is only changed
+	   by the thread which works on the drive, the read index only by the
+	   application thread.
+	*/
+	int use_queue;
+	struct burn_drive_event queue[Libburn_drive_event_queuE];
+	volatile int queue_write;
+	volatile int queue_read;
+	int lost;
+
+	/* Readable end and writable end of the notification pipe */
+	int pipe_fds[2];
+
+	/* Last reported state */
+	enum burn_drive_status last_status;
+	int last_sector;
+	int last_track;
+	int cancel_reported;
+
+	/* The fifo which feeds the current track, or NULL */
+	struct burn_source *fifo;
+};
+
+
+/* Free the event facility of the drive */
+int burn_drive_events_destroy(struct burn_drive *d, int flag);
+
+/* Inform the event facility about the source of the current track */
+int burn_drive_events_set_source(struct burn_drive *d,
+                                 struct burn_source *src, int flag);
+
+/* Emit events about changes since the last call.
+   @param flag bit0= the operation has ended. Emit BURN_EVENT_END.
+               bit1= emit BURN_EVENT_PROGRESS regardless of sector_step
+*/
+int burn_drive_events_check(struct burn_drive *d, int flag);
+
+#endif /* BURN__EVENT_H */
@@ -10,6 +10,13 @@
 #include "../config.h"
 #endif
 
+/* ts C61019 : O_DIRECT for the fifo spill file */
+#ifdef __linux__
+# ifndef _GNU_SOURCE
+#  define _GNU_SOURCE
+# endif
+#endif
+
 
 #include <stdlib.h>
 #include <sys/types.h>
@@ -21,18 +28,36 @@
 #include <fcntl.h>
 #include <time.h>
 #include <pthread.h>
+#include <sched.h>
 
 /* ts B41126 : O_BINARY is needed for Cygwin but undefined elsewhere */
 #ifndef O_BINARY
 #define O_BINARY 0
 #endif
 
+/* ts C61019 : Without O_DIRECT the spill file goes through the page cache */
+#ifndef O_DIRECT
+#define O_DIRECT 0
+#endif
+
+/* ts C61019 : Alignment of slots in the fifo spill file */
+#define Libburn_spill_aligN 4096
+
+/* ts C61019 : Size of the batches which get written to the spill file,
+               and the minimum number of slots which shall fit into the file
+               before smaller batches get used.
+*/
+#define Libburn_spill_batcH (1024 * 1024)
+#define Libburn_spill_min_slotS 8
+
 #include "source.h"
 #include "libburn.h"
 #include "file.h"
 #include "async.h"
 #include "init.h"
 #include "util.h"
+#include "transport.h"
+#include "libdax_audioxtr.h"
 
 #include "libdax_msgs.h"
 extern struct libdax_msgs *libdax_messenger;
@@ -225,11 +250,429 @@ static int fifo_sleep(int flag)
 }
 
 
+/* ts C61019 */
+static int fifo_fill_bytes(struct burn_source_fifo *fs, int flag)
+{
+	int bufsize, diff;
+
+	bufsize = fs->chunksize * fs->chunks;
+	diff = fs->buf_writepos - fs->buf_readpos;
+	if (diff < 0)
+		diff += bufsize;
+	return diff;
+}
+
+
+/* ts C61019 */
+/* Let the first read of the consumer wait for the fill level which was
+   demanded by burn_fifo_prefetch()
+*/
+static int fifo_wait_gate(struct burn_source_fifo *fs, int flag)
+{
+	while (fifo_fill_bytes(fs, 0) < fs->gate_fill) {
+		if (fs->end_of_input || fs->input_error || fs->do_abort ||
+		    fs->end_of_consumption)
+	break;
+		if (fs->gate_budget > 0.0 &&
+		    burn_get_time(0) - fs->prefetch_start >= fs->gate_budget)
+	break;
+		fifo_sleep(0);
+	}
+	fs->gate_open = 1;
+	return 1;
+}
+
+
+/* ts C61019 : Flow measurement for the producer of the fifo input.
+   Samples get taken by the shoveller thread not more often than
+   Libburn_pressure_samplE seconds and get smoothed with a time constant
+   of Libburn_pressure_smootH seconds. The suggested input rate shall
+   reach Libburn_pressure_targeT fill within Libburn_pressure_horizoN
+   seconds.
+*/
+#define Libburn_pressure_samplE 0.25
+#define Libburn_pressure_smootH 2.0
+#define Libburn_pressure_targeT 0.75
+#define Libburn_pressure_horizoN 4.0
+
+#ifdef __GNUC__
+#define Libburn_pressure_barrieR __sync_synchronize()
+#else
+#define Libburn_pressure_barrieR
+#endif
+
+/* @param flag bit0= call the eventual handler if its interval has passed
+*/
+static int fifo_pressure_check(struct burn_source_fifo *fs, int flag)
+{
+	struct burn_fifo_pressure *p = &(fs->pressure);
+	struct burn_fifo_pressure copy;
+	double now, dt, w, base;
+	off_t fill, size;
+
+	now = burn_get_time(0);
+	fill = fifo_fill_bytes(fs, 0);
+	size = ((off_t) fs->chunksize) * (off_t) fs->chunks;
+	if (fs->spill != NULL) {
+		fill += fs->spill->in_counter - fs->spill->out_counter;
+		size += ((off_t) fs->spill->slots) *
+			(off_t) fs->spill->slot_size;
+	}
+	if (fs->pressure_time <= 0.0) {
+		fs->pressure_time = now;
+		fs->pressure_in = fs->in_counter;
+		fs->pressure_out = fs->out_counter;
+		fs->pressure_fill = fill;
+		return 0;
+	}
+	dt = now - fs->pressure_time;
+	if (dt >= Libburn_pressure_samplE) {
+		fs->pressure_seq++;
+		Libburn_pressure_barrieR;
+		w = dt / Libburn_pressure_smootH;
+		if (w > 1.0 || p->timestamp <= 0.0)
+			w = 1.0;
+		p->consumer_rate += w * ((fs->out_counter - fs->pressure_out)
+					 / dt - p->consumer_rate);
+		p->producer_rate += w * ((fs->in_counter - fs->pressure_in)
+					 / dt - p->producer_rate);
+		p->fill_trend += w * (((double) (fill - fs->pressure_fill)) /
+				      dt - p->fill_trend);
+		p->size = size;
+		p->fill = fill;
+		p->drive_rate = 0.0;
+		if (fs->drive != NULL)
+			if (fs->drive->user_write_speed > 0)
+				p->drive_rate = 1000.0 *
+				       (double) fs->drive->user_write_speed;
+		if (p->consumer_rate > 0.0)
+			p->seconds_left = ((double) fill) / p->consumer_rate;
+		else
+			p->seconds_left = -1.0;
+		if (fs->out_counter <= 0) {
+			p->suggested_rate = -1.0;
+		} else {
+			base = p->consumer_rate;
+			if (base <= 0.0)
+				base = p->drive_rate;
+			p->suggested_rate = base +
+				(Libburn_pressure_targeT * (double) size -
+				 (double) fill) / Libburn_pressure_horizoN;
+			if (p->suggested_rate < 0.0)
+				p->suggested_rate = 0.0;
+		}
+		p->timestamp = now;
+		Libburn_pressure_barrieR;
+		fs->pressure_seq++;
+		fs->pressure_time = now;
+		fs->pressure_in = fs->in_counter;
+		fs->pressure_out = fs->out_counter;
+		fs->pressure_fill = fill;
+	}
+	if ((flag & 1) && fs->pressure_handler != NULL &&
+	    p->timestamp > 0.0 &&
+	    now - fs->pressure_call_time >= fs->pressure_interval) {
+		fs->pressure_call_time = now;
+		memcpy(&copy, p, sizeof(struct burn_fifo_pressure));
+		(*fs->pressure_handler)(fs->pressure_handle, &copy);
+	}
+	return 1;
+}
+
+
+/* ts C61019 : Spilling of fifo input to a scratch file.
+   The shoveller packs read chunks into put_buf. A full put_buf gets written
+   as one batch into the next slot of the ring of slots on disk.
+   The shoveller changes only writepos, the consumer only readpos.
+   As long as the disk or put_buf hold data, new input goes to put_buf,
+   so that the ring buffer in memory always holds the oldest data.
+   If the disk is empty, put_buf gets moved into the ring buffer as soon
+   as there is room. Only if the consumer would starve otherwise, a batch
+   gets written before put_buf is full.
+*/
+
+static int fifo_spill_destroy(struct burn_fifo_spill **spill, int flag)
+{
+	struct burn_fifo_spill *sp = *spill;
+
+	if (sp == NULL)
+		return 0;
+	if (sp->fd != -1)
+		close(sp->fd);
+	if (sp->put_buf != NULL)
+		burn_os_free_buffer(sp->put_buf, (size_t) sp->slot_size, 0);
+	if (sp->get_buf != NULL)
+		burn_os_free_buffer(sp->get_buf, (size_t) sp->slot_size, 0);
+	BURN_FREE_MEM(sp->slot_len);
+	free((char *) sp);
+	*spill = NULL;
+	return 1;
+}
+
+
+/* Transfer the first len bytes of a slot between memory and disk.
+   The transfer size gets rounded up to the alignment of O_DIRECT.
+   O_DIRECT is given up if the filesystem refuses it only at transfer time.
+   @param flag bit0= write rather than read
+*/
+static int fifo_spill_io(struct burn_fifo_spill *sp, char *buf, int slot,
+			 int len, int flag)
+{
+	int ret, todo, done = 0;
+	off_t pos;
+
+	pos = ((off_t) slot) * (off_t) sp->slot_size;
+	todo = len + (Libburn_spill_aligN - len % Libburn_spill_aligN) %
+							Libburn_spill_aligN;
+	if (todo > sp->slot_size)
+		todo = sp->slot_size;
+	while (done < todo) {
+		if (flag & 1)
+			ret = pwrite(sp->fd, buf + done, todo - done,
+							pos + done);
+		else
+			ret = pread(sp->fd, buf + done, todo - done,
+							pos + done);
+		if (ret == -1 && errno == EINVAL && sp->direct) {
+			fcntl(sp->fd, F_SETFL,
+					fcntl(sp->fd, F_GETFL) & ~O_DIRECT);
+			sp->direct = 0;
+	continue;
+		}
+		if (ret == -1 && errno == EINTR)
+	continue;
+		if (ret <= 0) {
+			libdax_msgs_submit(libdax_messenger, -1, 0x000201b3,
+				LIBDAX_MSGS_SEV_SORRY, LIBDAX_MSGS_PRIO_HIGH,
+				(flag & 1) ? "Cannot write to fifo spill file"
+					   : "Cannot read from fifo spill file",
+				errno, 0);
+			return -1;
+		}
+		done += ret;
+	}
+	return 1;
+}
+
+
+
+/* ts C61019 */
+/* Judge one block of the volume recognition area.
+   @return 0= not a volume structure descriptor, 1= descriptor
+*/
+static int fifo_sniff_descr(struct burn_source_fifo *fs, unsigned char *b,
+                            int flag)
+{
+	static char *vrs_ids[] = {
+		"CD001", "BEA01", "NSR02", "NSR03", "TEA01", "BOOT2", "CDW02"
+	};
+	int i, l;
+
+	for (i = 0; i < (int) (sizeof(vrs_ids) / sizeof(char *)); i++)
+		if (memcmp(b + 1, vrs_ids[i], 5) == 0)
+	break;
+	if (i >= (int) (sizeof(vrs_ids) / sizeof(char *)))
+		return 0;
+	if (i == 2 || i == 3) {
+		fs->iso_fs_types |= 8;                   /* UDF */
+		return 1;
+	}
+	if (i != 0)
+		return 1;
+	if (b[0] == 1 && !(fs->iso_fs_types & 1)) {
+		/* Primary Volume Descriptor */
+		fs->iso_fs_types |= 1;
+		fs->iso_blocks = ((off_t) b[80]) | (((off_t) b[81]) << 8) |
+		                 (((off_t) b[82]) << 16) |
+		                 (((off_t) b[83]) << 24);
+		memcpy(fs->iso_volume_id, b + 40, 32);
+		for (l = 32; l > 0 && fs->iso_volume_id[l - 1] == ' '; l--);
+		fs->iso_volume_id[l] = 0;
+	} else if (b[0] == 2 && b[88] == '%' && b[89] == '/' &&
+	           (b[90] == '@' || b[90] == 'C' || b[90] == 'E')) {
+		fs->iso_fs_types |= 2;                   /* Joliet */
+	} else if (b[0] == 0 &&
+		   memcmp(b + 7, "EL TORITO SPECIFICATION", 23) == 0) {
+		fs->iso_fs_types |= 4;                   /* El Torito */
+	}
+	return 1;
+}
+
+
+/* ts C61019 */
+/* Collect and judge the blocks 16 to 31 while the input data pass by.
+   Each block gets looked at once, as soon as it is complete. Sniffing ends
+   at the first block which is not a volume structure descriptor.
+   @param data      The input chunk
+   @param in_start  Byte address of the chunk in the input stream
+   @param count     Number of bytes in data
+   @param flag      bit0= input has ended, finish sniffing
+*/
+static int fifo_sniff_iso(struct burn_source_fifo *fs, char *data,
+                          off_t in_start, int count, int flag)
+{
+	int skip, n;
+
+	if (fs->iso_state != 0)
+		return 2;
+	if (!(flag & 1)) {
+		if (in_start + count <= 16 * 2048)
+			return 1;
+		skip = 0;
+		if (in_start < 16 * 2048)
+			skip = 16 * 2048 - in_start;
+		n = count - skip;
+		if (fs->iso_fill + n > 16 * 2048)
+			n = 16 * 2048 - fs->iso_fill;
+		memcpy(fs->iso_descr + fs->iso_fill, data + skip, n);
+		fs->iso_fill += n;
+	}
+	while (fs->iso_judged < fs->iso_fill / 2048) {
+		if (!fifo_sniff_descr(fs, (unsigned char *) fs->iso_descr +
+		                          fs->iso_judged * 2048, 0))
+			flag |= 1;
+		fs->iso_judged++;
+		if (flag & 1)
+	break;
+	}
+	if (fs->iso_judged < 16 && !(flag & 1))
+		return 1;
+	memset(fs->iso_descr + fs->iso_fill, 0, 16 * 2048 - fs->iso_fill);
+	fs->iso_state = (fs->iso_fs_types & 1) ? 1 : 2;
+	return 2;
+}
+
+
+/* Shoveller: read one chunk of input and append it to put_buf.
+   The caller has to make sure that put_buf has room for inp_read_size.
+   @return like burn_source.read_xt()
+*/
+static int fifo_spill_put(struct burn_source_fifo *fs, int flag)
+{
+	struct burn_fifo_spill *sp = fs->spill;
+	int ret;
+	char *bufpt;
+
+	bufpt = sp->put_buf + sp->put_len;
+	if (fs->inp->read != NULL)
+		ret = fs->inp->read(fs->inp,
+			 (unsigned char *) bufpt, fs->inp_read_size);
+	else
+		ret = fs->inp->read_xt(fs->inp,
+			 (unsigned char *) bufpt, fs->inp_read_size);
+	if (ret <= 0)
+		return ret;
+	if (ret > fs->inp_read_size)
+		ret = fs->inp_read_size;
+	fifo_sniff_iso(fs, bufpt, fs->in_counter, ret, 0);
+	sp->put_len += ret;
+	sp->in_counter += ret;
+	if (sp->in_counter - sp->out_counter > sp->max_fill)
+		sp->max_fill = sp->in_counter - sp->out_counter;
+	return ret;
+}
+
+
+/* Shoveller: write put_buf as one batch into the next slot, which has to
+   be free.
+*/
+static int fifo_spill_flush(struct burn_source_fifo *fs, int flag)
+{
+	struct burn_fifo_spill *sp = fs->spill;
+	int wpos;
+
+	wpos = sp->writepos;
+	if (fifo_spill_io(sp, sp->put_buf, wpos, sp->put_len, 1) <= 0) {
+		errno = EIO;
+		return -1;
+	}
+	sp->slot_len[wpos] = sp->put_len;
+	sp->put_len = 0;
+	sp->spill_counter++;
+	sp->writepos = (wpos + 1) % sp->slots;
+	return 1;
+}
+
+
+/* Shoveller: move put_buf into the ring buffer. The disk has to be empty
+   and the ring buffer has to have room for put_len bytes.
+*/
+static int fifo_spill_unpend(struct burn_source_fifo *fs, int flag)
+{
+	struct burn_fifo_spill *sp = fs->spill;
+	int bufsize, wpos, part, len;
+
+	bufsize = fs->chunksize * fs->chunks;
+	wpos = fs->buf_writepos;
+	len = sp->put_len;
+	part = bufsize - wpos;
+	if (part > len)
+		part = len;
+	memcpy(fs->buf + wpos, sp->put_buf, part);
+	if (len > part)
+		memcpy(fs->buf, sp->put_buf + part, len - part);
+	sp->put_len = 0;
+	/* out_counter belongs to the consumer */
+	sp->in_counter -= len;
+	fs->buf_writepos = (wpos + len) % bufsize;
+	return 1;
+}
+
+
+/* Shoveller: decide what to do with put_buf.
+   @param free_bytes  free space in the ring buffer
+   @param mem_empty   whether the ring buffer is empty
+   @param flag        bit0= input has ended. Write put_buf as soon as
+                            a slot is free.
+   @return 0= nothing to do
+           1= put_buf was moved into the ring buffer
+           2= put_buf has to be written by fifo_spill_flush()
+           3= put_buf and disk are full. Wait for the consumer.
+*/
+static int fifo_spill_settle(struct burn_source_fifo *fs, int free_bytes,
+                             int mem_empty, int flag)
+{
+	struct burn_fifo_spill *sp = fs->spill;
+	int disk_empty, slot_free;
+
+	if (sp == NULL || sp->put_len <= 0)
+		return 0;
+	disk_empty = (sp->writepos == sp->readpos);
+	slot_free = ((sp->writepos + 1) % sp->slots != sp->readpos);
+	if (disk_empty && free_bytes >= sp->put_len) {
+		fifo_spill_unpend(fs, 0);
+		return 1;
+	}
+	if ((flag & 1) || sp->put_len + fs->inp_read_size > sp->slot_size ||
+	    (disk_empty && mem_empty))
+		return slot_free ? 2 : 3;
+	return 0;
+}
+
+
+/* Consumer: fetch the oldest slot into the get buffer */
+static int fifo_spill_get(struct burn_source_fifo *fs, int flag)
+{
+	struct burn_fifo_spill *sp = fs->spill;
+	int rpos;
+
+	rpos = sp->readpos;
+	if (fifo_spill_io(sp, sp->get_buf, rpos, sp->slot_len[rpos], 0) <= 0)
+		return -1;
+	sp->get_len = sp->slot_len[rpos];
+	sp->get_off = 0;
+	sp->out_counter += sp->get_len; /* the batch has left the disk */
+	sp->readpos = (rpos + 1) % sp->slots;
+	return 1;
+}
+
+
 static int fifo_read(struct burn_source *source,
 		     unsigned char *buffer,
 		     int size)
 {
 	struct burn_source_fifo *fs = source->data;
+	struct burn_fifo_spill *sp;
 	int ret, todo, rpos, bufsize, diff, counted = 0;
 
 	if (fs->end_of_consumption) {
@@ -249,6 +692,8 @@ static int fifo_read(struct burn_source *source,
 	}
 	if (size == 0)
 		return 0;
+	if (!fs->gate_open)
+		fifo_wait_gate(fs, 0);
 
 	/* Reading from the ring buffer */
 
@@ -260,9 +705,26 @@ static int fifo_read(struct burn_source *source,
 	todo = size;
 	bufsize = fs->chunksize * fs->chunks;
 	while (todo > 0) {
+		/* Spilled data which are already fetched from disk are
+		   older than anything in the ring buffer
+		*/
+		sp = fs->spill;
+		if (sp != NULL && sp->get_off < sp->get_len) {
+			diff = sp->get_len - sp->get_off;
+			if (diff > todo)
+				diff = todo;
+			memcpy(buffer + (size - todo),
+				sp->get_buf + sp->get_off, diff);
+			sp->get_off += diff;
+			todo -= diff;
+	continue;
+		}
+
 		/* readpos is not volatile here , writepos is volatile */
 		rpos = fs->buf_readpos;
 		while (rpos == fs->buf_writepos) {
+			if (sp != NULL && sp->writepos != sp->readpos)
+		break;
 			if (fs->end_of_input)
 		break;
 			if (fs->input_error) {
@@ -281,6 +743,18 @@ static int fifo_read(struct burn_source *source,
 			fifo_sleep(0);
 		}
 		diff = fs->buf_writepos - rpos; /* read volatile only once */
+		if (diff == 0 && sp != NULL && sp->writepos != sp->readpos) {
+			/* The ring buffer is empty. So the oldest data are
+			   on disk and the shoveller puts no new data into the
+			   ring buffer before the disk is empty.
+			*/
+			ret = fifo_spill_get(fs, 0);
+			if (ret <= 0) {
+				fs->end_of_consumption = 1;
+				return -1;
+			}
+	continue;
+		}
 		if (diff == 0)
 	break;
 		if (diff > 0)
@@ -290,7 +764,7 @@ static int fifo_read(struct burn_source *source,
 			diff =  bufsize - rpos;
 		if (diff > todo)
 			diff = todo;
-		memcpy(buffer, fs->buf+(size-todo)+rpos, diff);
+		memcpy(buffer + (size - todo), fs->buf + rpos, diff);
 		fs->buf_readpos += diff;
 		if (fs->buf_readpos >= bufsize)
 			fs->buf_readpos = 0;
@@ -331,21 +805,16 @@ static int fifo_set_size(struct burn_source *source, off_t size)
 static void fifo_free(struct burn_source *source)
 {
 	struct burn_source_fifo *fs = source->data;
-	int wait_count;
-	static int wait_max = 30, wait_usleep = 100000;
 
 	burn_fifo_abort(fs, 0);
-	for (wait_count = 0; wait_count <= wait_max; wait_count++) {
-		if (fs->thread_is_valid <= 0)
-	break;
-		if (wait_count < wait_max)
-			usleep(wait_usleep);
-	}
-	if (wait_count > wait_max) {
-		/* The shoveler thread might still be active. If so, it would
-		   use invalid or inappropriate memory if the fifo would be
-		   disposed now. A memory and resource leak is the better
-		   option here.
+	/* ts C61019 : The shoveller checks fs->do_abort between its reads
+	   and then ends. It must not touch the fifo any more when it gets
+	   disposed.
+	*/
+	if (burn_fifo_wait_end(fs, 0) <= 0) {
+		/* The shoveller is possibly stuck in a read call. It would
+		   use invalid memory if the fifo would be disposed now.
+		   A memory and resource leak is the better option here.
 		*/
 		libdax_msgs_submit(libdax_messenger, -1,
 				   0x000201ab,
@@ -362,6 +831,7 @@ static void fifo_free(struct burn_source *source)
 	if (fs->buf != NULL)
 		burn_os_free_buffer(fs->buf,
 			((size_t) fs->chunksize) * (size_t) fs->chunks, 0);
+	fifo_spill_destroy(&(fs->spill), 0);
 	free((char *) fs);
 }
 
@@ -370,8 +840,9 @@ int burn_fifo_source_shoveller(struct burn_source *source, int flag)
 {
 	struct burn_source_fifo *fs = source->data;
 	int ret, bufsize, diff, wpos, rpos, trans_end, free_bytes, fill;
-	int counted;
+	int counted, to_spill;
 	char *bufpt;
+	struct burn_fifo_spill *sp;
 	pthread_t thread_handle_storage;
 
 	fs->thread_handle= &thread_handle_storage;
@@ -390,6 +861,7 @@ int burn_fifo_source_shoveller(struct burn_source *source, int flag)
 		/* wait for enough buffer space available */
 		wpos = fs->buf_writepos;
 		counted = 0;
+		to_spill = 0;
 		while (1) {
 			if (fs->do_abort)
 				goto emergency_exit;
@@ -405,13 +877,59 @@ int burn_fifo_source_shoveller(struct burn_source *source, int flag)
 				if (bufsize - wpos < fs->inp_read_size)
 					trans_end = 1;
 			}
-			if (free_bytes >= fs->inp_read_size)
+			sp = fs->spill;
+			ret = fifo_spill_settle(fs, free_bytes, rpos == wpos,
+						0);
+			if (ret == 1) {
+				wpos = fs->buf_writepos;
+		continue;
+			} else if (ret == 2) {
+				to_spill = 2;
+		break;
+			}
+			if (sp != NULL && (free_bytes < fs->inp_read_size ||
+					   sp->writepos != sp->readpos ||
+					   sp->put_len > 0)) {
+				/* Memory is full or older data are spilled.
+				   Go on if put_buf has room.
+				*/
+				if (ret == 0) {
+					to_spill = 1;
+		break;
+				}
+			} else if (free_bytes >= fs->inp_read_size)
 		break;
 			if (!counted)
 				fs->full_counter++;
 			counted = 1;
+			fifo_pressure_check(fs, 0);
 			fifo_sleep(0);
 		}
+		fifo_pressure_check(fs, 1);
+		if (to_spill == 2) {
+			if (fifo_spill_flush(fs, 0) <= 0) {
+				fs->input_error = EIO;
+	break;
+			}
+	continue;
+		} else if (to_spill) {
+			ret = fifo_spill_put(fs, 0);
+			if (ret == 0)
+	break; /* EOF */
+			if (ret < 0) {
+				libdax_msgs_submit(libdax_messenger, -1,
+				  0x00020153,
+				  LIBDAX_MSGS_SEV_SORRY, LIBDAX_MSGS_PRIO_HIGH,
+				  "Read error on fifo input", errno, 0);
+				fs->input_error = errno;
+				if(errno == 0)
+					fs->input_error = EIO;
+	break;
+			}
+			fs->in_counter += ret;
+			fs->put_counter++;
+	continue;
+		}
 
 		fill = bufsize - free_bytes - 1;
 		if (fill < fs->total_min_fill)
@@ -423,7 +941,7 @@ int burn_fifo_source_shoveller(struct burn_source *source, int flag)
 		bufpt = fs->buf + wpos;
 		if (trans_end) {
 			bufpt = burn_os_alloc_buffer(
-					(size_t) fs->inp_read_size, 0);
+					(size_t) fs->inp_read_size, 1);
 			if (bufpt == NULL) {
 				libdax_msgs_submit(libdax_messenger, -1,
 				  0x00000003,
@@ -458,15 +976,15 @@ int burn_fifo_source_shoveller(struct burn_source *source, int flag)
 				fs->input_error = EIO;
 	break;
 		}
-		fs->in_counter += ret;
-		fs->put_counter++;
-
 		/* activate read chunk */
 		if (fs->do_abort)
 			goto emergency_exit;
 		if (ret > fs->inp_read_size)
 					/* beware of ill custom burn_source */
 			ret = fs->inp_read_size;
+		fifo_sniff_iso(fs, bufpt, fs->in_counter, ret, 0);
+		fs->in_counter += ret;
+		fs->put_counter++;
 		if (trans_end) {
 			/* copy to end of buffer */
 			memcpy(fs->buf + wpos, bufpt, bufsize - wpos);
@@ -493,11 +1011,34 @@ int burn_fifo_source_shoveller(struct burn_source *source, int flag)
 			fs->buf_writepos, (double) fs->in_counter);
 */
 	}
+	fifo_sniff_iso(fs, NULL, (off_t) 0, 0, 1);
+
+	/* Hand over the last batch of spilled input */
+	while (fs->spill != NULL && fs->spill->put_len > 0 &&
+	       !fs->end_of_consumption && !fs->input_error) {
+		if (fs->do_abort)
+			goto emergency_exit;
+		fill = fifo_fill_bytes(fs, 0);
+		ret = fifo_spill_settle(fs, bufsize - fill - 1, fill == 0, 1);
+		if (ret == 1)
+	continue;
+		if (ret == 2) {
+			if (fifo_spill_flush(fs, 0) <= 0)
+				fs->input_error = EIO;
+	continue;
+		}
+		fifo_sleep(0);
+	}
+
 	if (!fs->end_of_consumption)
 		fs->end_of_input = 1;
 
 	/* wait for end of reading by consumer */;
-	while (fs->buf_readpos != fs->buf_writepos && !fs->end_of_consumption) {
+	while ((fs->buf_readpos != fs->buf_writepos ||
+		(fs->spill != NULL &&
+		 (fs->spill->writepos != fs->spill->readpos ||
+		  fs->spill->get_off < fs->spill->get_len)))
+	       && !fs->end_of_consumption) {
 		if (fs->do_abort)
 			goto emergency_exit;
 		fifo_sleep(0);
@@ -519,11 +1060,10 @@ int burn_fifo_source_shoveller(struct burn_source *source, int flag)
 	fs->buf = NULL;
 
 emergency_exit:;
-	burn_async_manage_lock(BURN_ASYNC_LOCK_OBTAIN);
-	fs->thread_handle= NULL;
-	fs->thread_is_valid = 0;
-	burn_async_manage_lock(BURN_ASYNC_LOCK_RELEASE);
-	return (fs->input_error == 0);
+	ret = (fs->input_error == 0);
+	/* After this call the fifo may be disposed at any time */
+	burn_fifo_ended(fs, 0);
+	return ret;
 }
 
 
@@ -538,6 +1078,7 @@ int burn_fifo_cancel(struct burn_source *source)
 
 /*
    @param flag bit0= allow larger read chunks
+               bit1= try to use explicit huge pages for the buffer
 */
 struct burn_source *burn_fifo_source_new(struct burn_source *inp,
 		 		int chunksize, int chunks, int flag)
@@ -573,6 +1114,9 @@ struct burn_source *burn_fifo_source_new(struct burn_source *inp,
 	fs->chunksize = chunksize;
 	fs->chunks = chunks;
 	fs->buf = NULL;
+	/* Not zeroed , transparent huge pages , eventually explicit ones */
+	fs->buf_alloc_flag = 1 | 2 | ((flag & 2) << 1);
+	fs->buf_obtained = 0;
 	fs->buf_writepos = fs->buf_readpos = 0;
 	fs->end_of_input = 0;
 	fs->input_error = 0;
@@ -581,6 +1125,26 @@ struct burn_source *burn_fifo_source_new(struct burn_source *inp,
 	fs->total_min_fill = fs->interval_min_fill = 0;
 	fs->put_counter = fs->get_counter = 0;
 	fs->empty_counter = fs->full_counter = 0;
+	fs->gate_fill = 0;
+	fs->gate_budget = 0.0;
+	fs->prefetch_start = 0.0;
+	fs->gate_open = 1;
+	fs->spill = NULL;
+	fs->drive = NULL;
+	memset(&(fs->pressure), 0, sizeof(struct burn_fifo_pressure));
+	fs->pressure_seq = 0;
+	fs->pressure_time = 0.0;
+	fs->pressure_in = fs->pressure_out = 0;
+	fs->pressure_fill = 0;
+	fs->pressure_handler = NULL;
+	fs->pressure_handle = NULL;
+	fs->pressure_interval = 1.0;
+	fs->pressure_call_time = 0.0;
+	fs->iso_fill = fs->iso_judged = 0;
+	fs->iso_blocks = 0;
+	fs->iso_volume_id[0] = 0;
+	fs->iso_fs_types = 0;
+	fs->iso_state = 0;
 
 	src = burn_source_new();
 	if (src == NULL) {
@@ -603,6 +1167,31 @@ struct burn_source *burn_fifo_source_new(struct burn_source *inp,
 }
 
 
+/* ts C61019 */
+int burn_source_is_fifo(struct burn_source *source, int flag)
+{
+	return (source->free_data == fifo_free);
+}
+
+
+/* ts C61019 : API */
+int burn_fifo_inquire_memory(struct burn_source *source, off_t *size,
+                             int *obtained, int flag)
+{
+	struct burn_source_fifo *fs = source->data;
+
+	*size = 0;
+	*obtained = 0;
+	if (!burn_source_is_fifo(source, 0))
+		return -1;
+	if (fs->buf == NULL)
+		return 0;
+	*size = ((off_t) fs->chunksize) * (off_t) fs->chunks;
+	*obtained = fs->buf_obtained;
+	return 1;
+}
+
+
 /* ts A71003 : API */
 int burn_fifo_inquire_status(struct burn_source *source,
 		 int *size, int *free_bytes, char **status_text)
@@ -800,60 +1389,424 @@ int burn_fifo_fill(struct burn_source *source, int bufsize, int flag)
 }
 
 
-/* ----------------------------- Offset source ----------------------------- */
-/* ts B00922 */
-
-static void offst_free(struct burn_source *source);
-
-/* @param flag bit0 = do not check for burn_source_offst, do not return NULL
-*/
-static struct burn_source_offst *offst_auth(struct burn_source *source,
-								int flag)
+/* ts C61019 : API */
+int burn_fifo_prefetch(struct burn_source *source, int fill_percent,
+                       double time_budget, int flag)
 {
-	if (source->free_data != offst_free && !(flag & 1)) {
-		libdax_msgs_submit(libdax_messenger, -1, 0x0002017a,
-			LIBDAX_MSGS_SEV_FAILURE, LIBDAX_MSGS_PRIO_HIGH,
- 			"Expected offset source object as parameter",
+	struct burn_source_fifo *fs = source->data;
+	int ret, usable;
+
+	if (!burn_source_is_fifo(source, 0)) {
+		libdax_msgs_submit(libdax_messenger, -1, 0x00020157,
+				 LIBDAX_MSGS_SEV_FATAL, LIBDAX_MSGS_PRIO_HIGH,
+		  "burn_source is not a fifo object", 0, 0);
+		return -1;
+	}
+	if (fs->out_counter > 0 || fs->end_of_consumption) {
+		libdax_msgs_submit(libdax_messenger, -1, 0x000201b1,
+			LIBDAX_MSGS_SEV_SORRY, LIBDAX_MSGS_PRIO_HIGH,
+		"Fifo is already under consumption when prefetching is desired",
 			0, 0);
-		return NULL;
+		return 0;
 	}
-	return (struct burn_source_offst *) source->data;
+	if (fill_percent < 0)
+		fill_percent = 0;
+	else if (fill_percent > 100)
+		fill_percent = 100;
+
+	/* The shoveller stops when less than one read chunk is free */
+	usable = fs->chunksize * fs->chunks;
+	usable -= (usable % fs->inp_read_size) + fs->inp_read_size;
+	if (usable < 0)
+		usable = 0;
+	fs->gate_fill = ((double) usable) * fill_percent / 100.0;
+	fs->gate_budget = time_budget;
+	fs->prefetch_start = burn_get_time(0);
+	fs->gate_open = (fs->gate_fill <= 0);
+
+	/* Start fifo thread by reading 0 bytes */
+	ret = fifo_read(source, (unsigned char *) NULL, 0);
+	if (ret < 0)
+		return -1;
+	return 1;
 }
 
-static off_t offst_get_size(struct burn_source *source)
-{
-        struct burn_source_offst *fs;
-
-	if ((fs = offst_auth(source, 0)) == NULL)
-		return (off_t) 0;
-        return fs->nominal_size;
-}
 
-static int offst_set_size(struct burn_source *source, off_t size)
+/* ts C61019 : API */
+int burn_fifo_set_spill(struct burn_source *source, char *path, off_t size,
+                        int flag)
 {
-	struct burn_source_offst *fs;
+	struct burn_source_fifo *fs = source->data;
+	struct burn_fifo_spill *sp = NULL;
+	int ret, open_flags, min_size, created = 0;
+	off_t total;
+	char *msg = NULL;
 
-	if ((fs = offst_auth(source, 0)) == NULL)
+	if (!burn_source_is_fifo(source, 0)) {
+		libdax_msgs_submit(libdax_messenger, -1, 0x00020157,
+				 LIBDAX_MSGS_SEV_FATAL, LIBDAX_MSGS_PRIO_HIGH,
+		  "burn_source is not a fifo object", 0, 0);
+		return -1;
+	}
+	if (fs->is_started) {
+		libdax_msgs_submit(libdax_messenger, -1, 0x000201b2,
+			LIBDAX_MSGS_SEV_SORRY, LIBDAX_MSGS_PRIO_HIGH,
+			"Fifo is already started when spill file is desired",
+			0, 0);
 		return 0;
+	}
+	fifo_spill_destroy(&(fs->spill), 0);
+	if (path == NULL || size <= 0)
+		return 1;
 
-	fs->nominal_size = size;
-	if (fs->size <= 0 || fs->size_adjustable)
-		fs->size = size;
-	return 1;
-}
+	BURN_ALLOC_MEM(msg, char, 4096);
+	sp = calloc(1, sizeof(struct burn_fifo_spill));
+	if (sp == NULL)
+		goto out_of_mem;
+	sp->fd = -1;
 
-static void offst_free(struct burn_source *source)
-{
-	struct burn_source_offst *fs;
+	/* Input chunks get packed into batches of up to Libburn_spill_batcH.
+	   Smaller spill files get smaller batches.
+	*/
+	min_size = fs->inp_read_size + (Libburn_spill_aligN -
+			fs->inp_read_size % Libburn_spill_aligN) %
+							Libburn_spill_aligN;
+	sp->slot_size = Libburn_spill_batcH;
+	while (sp->slot_size / 2 >= min_size &&
+	       size / sp->slot_size < Libburn_spill_min_slotS)
+		sp->slot_size /= 2;
+	if (sp->slot_size < min_size)
+		sp->slot_size = min_size;
+	if (size / sp->slot_size > 0x7fffffff)
+		sp->slots = 0x7fffffff;
+	else
+		sp->slots = size / sp->slot_size;
+	if (sp->slots < 2) {
+		libdax_msgs_submit(libdax_messenger, -1, 0x000201b2,
+			LIBDAX_MSGS_SEV_SORRY, LIBDAX_MSGS_PRIO_HIGH,
+			"Desired fifo spill file too small", 0, 0);
+		ret = 0; goto ex;
+	}
+	sp->slot_len = calloc(sp->slots, sizeof(int));
+	sp->put_buf = burn_os_alloc_buffer((size_t) sp->slot_size, 0);
+	sp->get_buf = burn_os_alloc_buffer((size_t) sp->slot_size, 0);
+	if (sp->slot_len == NULL || sp->put_buf == NULL || sp->get_buf == NULL)
+		goto out_of_mem;
+
+	open_flags = O_RDWR | O_CREAT | O_EXCL | O_BINARY;
+	sp->fd = open(path, open_flags | O_DIRECT, S_IRUSR | S_IWUSR);
+	sp->direct = (O_DIRECT != 0);
+	if (sp->fd == -1 && errno == EINVAL && O_DIRECT != 0) {
+		sp->fd = open(path, open_flags, S_IRUSR | S_IWUSR);
+		sp->direct = 0;
+	}
+	if (sp->fd == -1) {
+		sprintf(msg, "Cannot create fifo spill file '%.4000s'", path);
+		libdax_msgs_submit(libdax_messenger, -1, 0x000201b2,
+			LIBDAX_MSGS_SEV_SORRY, LIBDAX_MSGS_PRIO_HIGH,
+			burn_printify(msg), errno, 0);
+		ret = 0; goto ex;
+	}
+	if (flag & 1)
+		created = 1;
+	else
+		unlink(path); /* The file vanishes with the fifo */
 
-	if ((fs = offst_auth(source, 0)) == NULL)
-		return;
-	if (fs->prev != NULL)
-		offst_auth(fs->prev, 1)->next = fs->next;
-	if (fs->next != NULL)
-		offst_auth(fs->next, 1)->prev = fs->prev;
-	if (fs->inp != NULL)
-		burn_source_free(fs->inp); /* i.e. decrement refcount */
+	/* Reserve the disk space now rather than failing in the middle of
+	   the burn run
+	*/
+	total = ((off_t) sp->slots) * (off_t) sp->slot_size;
+#ifdef Libburn_os_has_fallocatE
+	ret = posix_fallocate(sp->fd, (off_t) 0, total);
+#else
+	ret = EOPNOTSUPP;
+#endif
+	if (ret == EINVAL || ret == EOPNOTSUPP) {
+		/* Filesystem cannot preallocate. Have at least the size. */
+		ret = 0;
+		if (ftruncate(sp->fd, total) == -1)
+			ret = errno;
+	}
+	if (ret != 0) {
+		sprintf(msg,
+		     "Cannot reserve %.f bytes for fifo spill file '%.4000s'",
+			(double) total, path);
+		libdax_msgs_submit(libdax_messenger, -1, 0x000201b2,
+			LIBDAX_MSGS_SEV_SORRY, LIBDAX_MSGS_PRIO_HIGH,
+			burn_printify(msg), ret, 0);
+		ret = 0; goto ex;
+	}
+	sp->writepos = sp->readpos = 0;
+	sp->put_len = 0;
+	sp->get_len = sp->get_off = 0;
+	sp->in_counter = sp->out_counter = sp->max_fill = 0;
+	sp->spill_counter = 0;
+	fs->spill = sp;
+	sp = NULL;
+	ret = 1;
+ex:;
+	if (sp != NULL && created)
+		unlink(path); /* Do not leave a useless file behind */
+	fifo_spill_destroy(&sp, 0);
+	BURN_FREE_MEM(msg);
+	return ret;
+
+out_of_mem:;
+	libdax_msgs_submit(libdax_messenger, -1, 0x00000003,
+			LIBDAX_MSGS_SEV_FATAL, LIBDAX_MSGS_PRIO_HIGH,
+			"Out of virtual memory", 0, 0);
+	ret = -1; goto ex;
+}
+
+
+/* ts C61019 : API */
+int burn_fifo_inquire_spill(struct burn_source *source,
+                            off_t *disk_size, off_t *disk_fill,
+                            int *mem_size, int *mem_fill,
+                            off_t *max_disk_fill, int flag)
+{
+	struct burn_source_fifo *fs = source->data;
+	struct burn_fifo_spill *sp;
+
+	*disk_size = *disk_fill = *max_disk_fill = 0;
+	*mem_size = *mem_fill = 0;
+	if (!burn_source_is_fifo(source, 0)) {
+		libdax_msgs_submit(libdax_messenger, -1, 0x00020157,
+				 LIBDAX_MSGS_SEV_FATAL, LIBDAX_MSGS_PRIO_HIGH,
+		  "burn_source is not a fifo object", 0, 0);
+		return -1;
+	}
+	*mem_size = fs->chunksize * fs->chunks;
+	if (fs->buf != NULL)
+		*mem_fill = fifo_fill_bytes(fs, 0);
+	sp = fs->spill;
+	if (sp == NULL)
+		return 0;
+	*disk_size = ((off_t) sp->slots) * (off_t) sp->slot_size;
+	*disk_fill = sp->in_counter - sp->out_counter;
+	*max_disk_fill = sp->max_fill;
+	return 1;
+}
+
+
+/* ts C61019 : API */
+int burn_fifo_inquire_pressure(struct burn_source *source,
+                               struct burn_fifo_pressure *pressure, int flag)
+{
+	struct burn_source_fifo *fs = source->data;
+	unsigned int seq;
+
+	memset(pressure, 0, sizeof(struct burn_fifo_pressure));
+	if (!burn_source_is_fifo(source, 0)) {
+		libdax_msgs_submit(libdax_messenger, -1, 0x00020157,
+				 LIBDAX_MSGS_SEV_FATAL, LIBDAX_MSGS_PRIO_HIGH,
+		  "burn_source is not a fifo object", 0, 0);
+		return -1;
+	}
+	/* The shoveller may change fs->pressure meanwhile. An odd or changed
+	   sequence number indicates that the copy is not consistent.
+	*/
+	while (1) {
+		seq = fs->pressure_seq;
+		if (!(seq & 1)) {
+			Libburn_pressure_barrieR;
+			memcpy(pressure, &(fs->pressure),
+			       sizeof(struct burn_fifo_pressure));
+			Libburn_pressure_barrieR;
+			if (fs->pressure_seq == seq)
+	break;
+		}
+		sched_yield();
+	}
+	if (pressure->timestamp <= 0.0) {
+		memset(pressure, 0, sizeof(struct burn_fifo_pressure));
+		return 0;
+	}
+	return 1;
+}
+
+
+/* ts C61019 : API */
+int burn_fifo_set_pressure_handler(struct burn_source *source,
+                int (*handler)(void *handle,
+                               struct burn_fifo_pressure *pressure),
+                void *handle, double interval, int flag)
+{
+	struct burn_source_fifo *fs = source->data;
+
+	if (!burn_source_is_fifo(source, 0)) {
+		libdax_msgs_submit(libdax_messenger, -1, 0x00020157,
+				 LIBDAX_MSGS_SEV_FATAL, LIBDAX_MSGS_PRIO_HIGH,
+		  "burn_source is not a fifo object", 0, 0);
+		return -1;
+	}
+	fs->pressure_handler = NULL;
+	fs->pressure_handle = handle;
+	fs->pressure_interval = interval > 0.0 ? interval : 1.0;
+	fs->pressure_call_time = 0.0;
+	fs->pressure_handler = handler;
+	return 1;
+}
+
+
+int burn_fifo_set_drive(struct burn_source *source, struct burn_drive *d,
+                        int flag)
+{
+	struct burn_source_fifo *fs;
+
+	source = burn_source_get_fifo(source, 0);
+	if (source == NULL)
+		return 0;
+	fs = source->data;
+	fs->drive = d;
+	return 1;
+}
+
+
+/* ts C61019 : API */
+int burn_fifo_inquire_prefetch(struct burn_source *source, int *target,
+                               int *fill, double *eta, int flag)
+{
+	struct burn_source_fifo *fs = source->data;
+	double elapsed, rate, remaining_budget;
+
+	*target = *fill = 0;
+	*eta = -1.0;
+	if (!burn_source_is_fifo(source, 0)) {
+		libdax_msgs_submit(libdax_messenger, -1, 0x00020157,
+				 LIBDAX_MSGS_SEV_FATAL, LIBDAX_MSGS_PRIO_HIGH,
+		  "burn_source is not a fifo object", 0, 0);
+		return -1;
+	}
+	*target = fs->gate_fill;
+	if (fs->buf != NULL)
+		*fill = fifo_fill_bytes(fs, 0);
+	if (fs->gate_open) {
+		*eta = 0.0;
+		return 0;
+	}
+	if (*fill >= *target || fs->end_of_input || fs->input_error) {
+		*eta = 0.0;
+		return 1;
+	}
+	elapsed = burn_get_time(0) - fs->prefetch_start;
+	if (elapsed > 0.0 && fs->in_counter > 0) {
+		rate = ((double) fs->in_counter) / elapsed;
+		*eta = ((double) (*target - *fill)) / rate;
+	}
+	if (fs->gate_budget > 0.0) {
+		remaining_budget = fs->gate_budget - elapsed;
+		if (remaining_budget < 0.0)
+			remaining_budget = 0.0;
+		if (*eta < 0.0 || *eta > remaining_budget)
+			*eta = remaining_budget;
+	}
+	return 1;
+}
+
+
+/* ts C61019 : API */
+int burn_fifo_inquire_iso(struct burn_source *source, off_t *image_blocks,
+                          char volume_id[33], char *descr, int *fs_types,
+                          int flag)
+{
+	struct burn_source *fifo;
+	struct burn_source_fifo *fs;
+	int ret;
+
+	*image_blocks = 0;
+	volume_id[0] = 0;
+	*fs_types = 0;
+	fifo = burn_source_get_fifo(source, 0);
+	if (fifo == NULL) {
+		libdax_msgs_submit(libdax_messenger, -1, 0x00020157,
+				 LIBDAX_MSGS_SEV_FATAL, LIBDAX_MSGS_PRIO_HIGH,
+		  "burn_source is not a fifo object", 0, 0);
+		return -1;
+	}
+	fs = fifo->data;
+	if ((flag & 1) && fs->iso_state == 0) {
+		/* Eventually start fifo thread by reading 0 bytes */
+		ret = fifo_read(fifo, (unsigned char *) NULL, 0);
+		if (ret < 0)
+			return 0;
+		while (fs->iso_state == 0) {
+			if (fs->end_of_input || fs->input_error ||
+			    fs->end_of_consumption || fs->do_abort)
+		break;
+			/* The input cannot go on if the buffer is full */
+			if (fs->buf != NULL && fs->spill == NULL &&
+			    fs->chunksize * fs->chunks - fifo_fill_bytes(fs, 0)
+			    <= fs->inp_read_size)
+		break;
+			fifo_sleep(0);
+		}
+	}
+	if (fs->iso_state == 0)
+		return 0;
+	*image_blocks = fs->iso_blocks;
+	strcpy(volume_id, fs->iso_volume_id);
+	*fs_types = fs->iso_fs_types;
+	if (descr != NULL)
+		memcpy(descr, fs->iso_descr, 16 * 2048);
+	return fs->iso_state;
+}
+
+
+/* ----------------------------- Offset source ----------------------------- */
+/* ts B00922 */
+
+static void offst_free(struct burn_source *source);
+
+/* @param flag bit0 = do not check for burn_source_offst, do not return NULL
+*/
+static struct burn_source_offst *offst_auth(struct burn_source *source,
+								int flag)
+{
+	if (source->free_data != offst_free && !(flag & 1)) {
+		libdax_msgs_submit(libdax_messenger, -1, 0x0002017a,
+			LIBDAX_MSGS_SEV_FAILURE, LIBDAX_MSGS_PRIO_HIGH,
+ 			"Expected offset source object as parameter",
+			0, 0);
+		return NULL;
+	}
+	return (struct burn_source_offst *) source->data;
+}
+
+static off_t offst_get_size(struct burn_source *source)
+{
+        struct burn_source_offst *fs;
+
+	if ((fs = offst_auth(source, 0)) == NULL)
+		return (off_t) 0;
+        return fs->nominal_size;
+}
+
+static int offst_set_size(struct burn_source *source, off_t size)
+{
+	struct burn_source_offst *fs;
+
+	if ((fs = offst_auth(source, 0)) == NULL)
+		return 0;
+
+	fs->nominal_size = size;
+	if (fs->size <= 0 || fs->size_adjustable)
+		fs->size = size;
+	return 1;
+}
+
+static void offst_free(struct burn_source *source)
+{
+	struct burn_source_offst *fs;
+
+	if ((fs = offst_auth(source, 0)) == NULL)
+		return;
+	if (fs->prev != NULL)
+		offst_auth(fs->prev, 1)->next = fs->next;
+	if (fs->next != NULL)
+		offst_auth(fs->next, 1)->prev = fs->prev;
+	if (fs->inp != NULL)
+		burn_source_free(fs->inp); /* i.e. decrement refcount */
 	free(source->data);
 }
 
@@ -967,6 +1920,544 @@ struct burn_source *burn_offst_source_new(
 }
 
 
+/* ts C61019 */
+struct burn_source *burn_source_get_fifo(struct burn_source *source,
+                                         int flag)
+{
+	while (source != NULL) {
+		if (burn_source_is_fifo(source, 0))
+			return source;
+		if (source->free_data != offst_free)
+			return NULL;
+		source = ((struct burn_source_offst *) source->data)->inp;
+	}
+	return NULL;
+}
+
+
+/* -------------------------- Audio playlist source ------------------------ */
+/* ts C61019 */
+
+static void playlist_free(struct burn_source *source);
+
+static struct burn_source_playlist *playlist_auth(struct burn_source *source,
+								int flag)
+{
+	if (source->free_data != playlist_free) {
+		libdax_msgs_submit(libdax_messenger, -1, 0x000201ae,
+			LIBDAX_MSGS_SEV_FAILURE, LIBDAX_MSGS_PRIO_HIGH,
+ 			"Expected audio playlist source object as parameter",
+			0, 0);
+		return NULL;
+	}
+	return (struct burn_source_playlist *) source->data;
+}
+
+
+static void playlist_destroy_file(struct burn_source_playlist *pl, int idx,
+								int flag)
+{
+	if (pl->xtrs[idx] != NULL)
+		libdax_audioxtr_destroy(&(pl->xtrs[idx]), 0);
+	BURN_FREE_MEM(pl->prefetch[idx]);
+	pl->prefetch[idx] = NULL;
+}
+
+
+static int playlist_destroy(struct burn_source_playlist **pl_handle, int flag)
+{
+	struct burn_source_playlist *pl;
+	int i;
+
+	pl = *pl_handle;
+	if (pl == NULL)
+		return 0;
+	if (pl->lock_valid) {
+		/* The helper thread must not touch the object any more */
+		pthread_mutex_lock(&(pl->lock));
+		while (pl->job_idx >= 0)
+			pthread_cond_wait(&(pl->prepared), &(pl->lock));
+		pthread_mutex_unlock(&(pl->lock));
+		pthread_cond_destroy(&(pl->prepared));
+		pthread_mutex_destroy(&(pl->lock));
+	}
+	for (i = 0; i < pl->num_files; i++) {
+		if (pl->xtrs != NULL && pl->prefetch != NULL)
+			playlist_destroy_file(pl, i, 0);
+		if (pl->paths != NULL)
+			BURN_FREE_MEM(pl->paths[i]);
+	}
+	BURN_FREE_MEM(pl->paths);
+	BURN_FREE_MEM(pl->sizes);
+	BURN_FREE_MEM(pl->swap);
+	BURN_FREE_MEM(pl->extents);
+	BURN_FREE_MEM(pl->xtrs);
+	BURN_FREE_MEM(pl->prefetch);
+	BURN_FREE_MEM(pl->prefetch_fill);
+	BURN_FREE_MEM(pl->states);
+	free((char *) pl);
+	*pl_handle = NULL;
+	return 1;
+}
+
+
+static int playlist_open_file(struct burn_source_playlist *pl, int idx,
+								int flag);
+
+/* Read the first bytes of file idx into its prefetch buffer */
+static int playlist_prefetch(struct burn_source_playlist *pl, int idx,
+								int flag)
+{
+	int ret, todo;
+
+	if (idx >= pl->num_files || pl->prefetch[idx] != NULL ||
+	    pl->xtrs[idx] == NULL || pl->prefetch_size <= 0)
+		return 2;
+	todo = pl->prefetch_size;
+	if (pl->sizes[idx] < todo)
+		todo = pl->sizes[idx];
+	if (todo <= 0)
+		return 2;
+	pl->prefetch[idx] = burn_alloc_mem(1, todo, 0);
+	if (pl->prefetch[idx] == NULL)
+		return -1;
+	pl->prefetch_fill[idx] = 0;
+	while (pl->prefetch_fill[idx] < todo) {
+		ret = libdax_audioxtr_read(pl->xtrs[idx],
+			pl->prefetch[idx] + pl->prefetch_fill[idx],
+			todo - pl->prefetch_fill[idx], 0);
+		if (ret <= 0)
+	break;
+		pl->prefetch_fill[idx] += ret;
+	}
+	return 1;
+}
+
+
+/* Open file idx again and read its first bytes. A file which cannot be
+   opened any more delivers zeros, see playlist_read_raw().
+*/
+static int playlist_prepare(struct burn_source_playlist *pl, int idx,
+								int flag)
+{
+	int ret;
+
+	ret = playlist_open_file(pl, idx, 1);
+	if (ret <= 0)
+		return ret;
+	return playlist_prefetch(pl, idx, 0);
+}
+
+
+static void *playlist_prepare_thread(void *handle)
+{
+	struct burn_source_playlist *pl = handle;
+	int idx;
+
+	idx = pl->job_idx;
+	playlist_prepare(pl, idx, 0);
+	pthread_mutex_lock(&(pl->lock));
+	pl->states[idx] = 2;
+	pl->job_idx = -1;
+	pthread_cond_broadcast(&(pl->prepared));
+	pthread_mutex_unlock(&(pl->lock));
+	return NULL;
+}
+
+
+/* Let the helper thread prepare file idx
+   @return 1= started, 2= nothing to do, 0= no thread available
+*/
+static int playlist_prepare_ahead(struct burn_source_playlist *pl, int idx,
+								int flag)
+{
+	int ret;
+
+	if (idx >= pl->num_files)
+		return 2;
+	pthread_mutex_lock(&(pl->lock));
+	if (pl->states[idx] != 0 || pl->job_idx >= 0) {
+		pthread_mutex_unlock(&(pl->lock));
+		return 2;
+	}
+	pl->states[idx] = 1;
+	pl->job_idx = idx;
+	pthread_mutex_unlock(&(pl->lock));
+	ret = burn_async_start_helper(playlist_prepare_thread, pl, 0);
+	if (ret <= 0) {
+		/* The consumer will prepare the file by itself */
+		pthread_mutex_lock(&(pl->lock));
+		pl->states[idx] = 0;
+		pl->job_idx = -1;
+		pthread_mutex_unlock(&(pl->lock));
+		return 0;
+	}
+	return 1;
+}
+
+
+/* Make sure that the current file is prepared and let the helper thread
+   prepare its successor
+*/
+static int playlist_get_ready(struct burn_source_playlist *pl, int flag)
+{
+	int idx, state;
+
+	idx = pl->current;
+	pthread_mutex_lock(&(pl->lock));
+	while (pl->states[idx] == 1)
+		pthread_cond_wait(&(pl->prepared), &(pl->lock));
+	state = pl->states[idx];
+	pthread_mutex_unlock(&(pl->lock));
+	if (state == 0) {
+		playlist_prepare(pl, idx, 0);
+		pthread_mutex_lock(&(pl->lock));
+		pl->states[idx] = 2;
+		pthread_mutex_unlock(&(pl->lock));
+	}
+	pl->current_ready = 1;
+	playlist_prepare_ahead(pl, idx + 1, 0);
+	return 1;
+}
+
+
+/* Read count unswapped payload bytes of the current file. Missing bytes of
+   a file which is shorter than announced get replaced by zeros.
+*/
+static int playlist_read_raw(struct burn_source_playlist *pl,
+				char *buffer, int count, int flag)
+{
+	int idx, done = 0, n, ret;
+	char msg[80];
+
+	idx = pl->current;
+	if (pl->prefetch[idx] != NULL && pl->raw_pos < pl->prefetch_fill[idx]) {
+		n = pl->prefetch_fill[idx] - pl->raw_pos;
+		if (n > count)
+			n = count;
+		memcpy(buffer, pl->prefetch[idx] + pl->raw_pos, n);
+		done += n;
+		pl->raw_pos += n;
+	}
+	while (done < count && pl->xtrs[idx] != NULL) {
+		ret = libdax_audioxtr_read(pl->xtrs[idx], buffer + done,
+						count - done, 0);
+		if (ret <= 0)
+	break;
+		done += ret;
+		pl->raw_pos += ret;
+	}
+	if (done < count) {
+		if (!pl->premature_reported) {
+			sprintf(msg,
+			  "Premature end of audio playlist file #%d. Padding.",
+				idx + 1);
+			libdax_msgs_submit(libdax_messenger, -1, 0x000201af,
+				LIBDAX_MSGS_SEV_WARNING, LIBDAX_MSGS_PRIO_HIGH,
+				msg, 0, 0);
+			pl->premature_reported = 1;
+		}
+		memset(buffer + done, 0, count - done);
+		pl->raw_pos += count - done;
+	}
+	return count;
+}
+
+
+/* Deliver count payload bytes of the current file, eventually swapped to
+   LSB first byte order.
+*/
+static int playlist_read_payload(struct burn_source_playlist *pl,
+				char *buffer, int count, int flag)
+{
+	int i;
+	char c, extra[1];
+
+	if (pl->has_pending) {
+		buffer[0] = pl->pending_byte;
+		pl->has_pending = 0;
+		pl->file_pos++;
+		return 1;
+	}
+	playlist_read_raw(pl, buffer, count, 0);
+	if (pl->swap[pl->current]) {
+		if (count % 2) {
+			if (pl->file_pos + count < pl->sizes[pl->current]) {
+				/* Complete the last pair */
+				playlist_read_raw(pl, extra, 1, 0);
+				pl->pending_byte = buffer[count - 1];
+				buffer[count - 1] = extra[0];
+				pl->has_pending = 1;
+			}
+		}
+		for (i = 0; i < count - 1; i += 2) {
+			c = buffer[i];
+			buffer[i] = buffer[i + 1];
+			buffer[i + 1] = c;
+		}
+	}
+	pl->file_pos += count;
+	return count;
+}
+
+
+static int playlist_next_file(struct burn_source_playlist *pl, int flag)
+{
+	playlist_destroy_file(pl, pl->current, 0);
+	pthread_mutex_lock(&(pl->lock));
+	pl->states[pl->current] = 3;
+	pthread_mutex_unlock(&(pl->lock));
+	pl->current++;
+	pl->current_ready = 0;
+	pl->file_pos = 0;
+	pl->raw_pos = 0;
+	pl->has_pending = 0;
+	pl->premature_reported = 0;
+	return 1;
+}
+
+
+static int playlist_read(struct burn_source *source, unsigned char *buffer,
+			int size)
+{
+	struct burn_source_playlist *pl;
+	int done = 0, n;
+	off_t room;
+	char *buf;
+
+	if ((pl = playlist_auth(source, 0)) == NULL)
+		return -1;
+	buf = (char *) buffer;
+	while (done < size && pl->pos + done < pl->stream_size) {
+		if (pl->current >= pl->num_files) {
+			/* Padding up to the end of the last sector */
+			room = pl->stream_size - (pl->pos + done);
+			n = size - done;
+			if (n > room)
+				n = room;
+			memset(buf + done, 0, n);
+			done += n;
+	continue;
+		}
+		if (!pl->current_ready)
+			playlist_get_ready(pl, 0);
+		room = pl->extents[pl->current] - pl->file_pos;
+		if (room <= 0 && !pl->has_pending) {
+			if (playlist_next_file(pl, 0) < 0)
+				return -1;
+	continue;
+		}
+		n = size - done;
+		if (n > room)
+			n = room;
+		if (pl->file_pos < pl->sizes[pl->current]) {
+			if (n > pl->sizes[pl->current] - pl->file_pos)
+				n = pl->sizes[pl->current] - pl->file_pos;
+			n = playlist_read_payload(pl, buf + done, n, 0);
+		} else {
+			/* Padding up to the end of the file's extent */
+			memset(buf + done, 0, n);
+			pl->file_pos += n;
+		}
+		done += n;
+	}
+	pl->pos += done;
+	return done;
+}
+
+
+static off_t playlist_get_size(struct burn_source *source)
+{
+	struct burn_source_playlist *pl;
+
+	if ((pl = playlist_auth(source, 0)) == NULL)
+		return (off_t) 0;
+	return pl->stream_size;
+}
+
+
+static int playlist_set_size(struct burn_source *source, off_t size)
+{
+	return 0;
+}
+
+
+static int playlist_cancel(struct burn_source *source)
+{
+	return 1;
+}
+
+
+static void playlist_free(struct burn_source *source)
+{
+	struct burn_source_playlist *pl;
+
+	if ((pl = playlist_auth(source, 0)) == NULL)
+		return;
+	playlist_destroy(&pl, 0);
+}
+
+
+/* Open and check one audio file of the playlist
+   @param flag bit0= only open the file which was checked before
+*/
+static int playlist_open_file(struct burn_source_playlist *pl, int idx,
+								int flag)
+{
+	char *fmt, *fmt_info, *msg = NULL;
+	int ret, num_channels, sample_rate, bits_per_sample, msb_first;
+
+	BURN_ALLOC_MEM(msg, char, 4096);
+
+	ret = libdax_audioxtr_new(&(pl->xtrs[idx]), pl->paths[idx], 0);
+	if (ret <= 0) {
+		sprintf(msg, "Cannot open audio playlist file '%.4000s'",
+			pl->paths[idx]);
+		libdax_msgs_submit(libdax_messenger, -1, 0x000201bb,
+				LIBDAX_MSGS_SEV_FAILURE, LIBDAX_MSGS_PRIO_HIGH,
+				burn_printify(msg), errno, 0);
+		ret = 0; goto ex;
+	}
+	if (flag & 1)
+		{ret = 1; goto ex;}
+	libdax_audioxtr_get_id(pl->xtrs[idx], &fmt, &fmt_info, &num_channels,
+		 		&sample_rate, &bits_per_sample, &msb_first, 0);
+	if (num_channels != 2 || sample_rate != 44100 ||
+	    bits_per_sample != 16) {
+		sprintf(msg,
+	     "Audio file is not 44100 Hz, 16 bit, stereo: '%.4000s'",
+			pl->paths[idx]);
+		libdax_msgs_submit(libdax_messenger, -1, 0x000201b0,
+				LIBDAX_MSGS_SEV_FAILURE, LIBDAX_MSGS_PRIO_HIGH,
+				burn_printify(msg), 0, 0);
+		ret = 0; goto ex;
+	}
+	ret = libdax_audioxtr_get_size(pl->xtrs[idx], &(pl->sizes[idx]), 0);
+	if (ret <= 0) {
+		sprintf(msg, "Cannot get payload size of audio file '%.4000s'",
+			pl->paths[idx]);
+		libdax_msgs_submit(libdax_messenger, -1, 0x000201bc,
+				LIBDAX_MSGS_SEV_FAILURE, LIBDAX_MSGS_PRIO_HIGH,
+				burn_printify(msg), 0, 0);
+		ret = 0; goto ex;
+	}
+	pl->swap[idx] = (msb_first == 1);
+	ret = 1;
+ex:;
+	BURN_FREE_MEM(msg);
+	return ret;
+}
+
+
+/* API */
+struct burn_source *burn_audio_playlist_source_new(char **paths,
+				int num_paths, int prefetch_bytes,
+				off_t *track_starts, int flag)
+{
+	struct burn_source_playlist *pl = NULL;
+	struct burn_source *src = NULL;
+	int i, ret;
+	off_t sum = 0;
+
+	if (num_paths <= 0 || num_paths > 99) {
+		libdax_msgs_submit(libdax_messenger, -1, 0x000201bd,
+				LIBDAX_MSGS_SEV_FAILURE, LIBDAX_MSGS_PRIO_HIGH,
+				"Audio playlist needs 1 to 99 files", 0, 0);
+		return NULL;
+	}
+	pl = calloc(1, sizeof(struct burn_source_playlist));
+	if (pl == NULL)
+		goto out_of_mem;
+	pl->num_files = num_paths;
+	pl->prefetch_size = prefetch_bytes;
+	if (pl->prefetch_size < 0)
+		pl->prefetch_size = Libburn_playlist_prefetcH;
+	pl->paths = calloc(num_paths, sizeof(char *));
+	pl->sizes = calloc(num_paths, sizeof(off_t));
+	pl->swap = calloc(num_paths, sizeof(int));
+	pl->extents = calloc(num_paths, sizeof(off_t));
+	pl->xtrs = calloc(num_paths, sizeof(struct libdax_audioxtr *));
+	pl->prefetch = calloc(num_paths, sizeof(char *));
+	pl->prefetch_fill = calloc(num_paths, sizeof(int));
+	pl->states = calloc(num_paths, sizeof(int));
+	if (pl->paths == NULL || pl->sizes == NULL || pl->swap == NULL ||
+	    pl->extents == NULL || pl->xtrs == NULL || pl->prefetch == NULL ||
+	    pl->prefetch_fill == NULL || pl->states == NULL)
+		goto out_of_mem;
+	pl->job_idx = -1;
+	if (pthread_mutex_init(&(pl->lock), NULL) != 0)
+		goto out_of_mem;
+	if (pthread_cond_init(&(pl->prepared), NULL) != 0) {
+		pthread_mutex_destroy(&(pl->lock));
+		goto out_of_mem;
+	}
+	pl->lock_valid = 1;
+
+	/* Validate all files before the first byte gets burned. They get
+	   opened again when their turn comes.
+	*/
+	for (i = 0; i < num_paths; i++) {
+		pl->paths[i] = strdup(paths[i]);
+		if (pl->paths[i] == NULL)
+			goto out_of_mem;
+		ret = playlist_open_file(pl, i, 0);
+		if (ret <= 0)
+			goto failed;
+		libdax_audioxtr_destroy(&(pl->xtrs[i]), 0);
+	}
+
+	/* Lay out the stream and the track start addresses */
+	for (i = 0; i < num_paths; i++) {
+		pl->extents[i] = pl->sizes[i];
+		if (flag & 1)
+			pl->extents[i] += (2352 - pl->sizes[i] % 2352) % 2352;
+		if (track_starts != NULL) {
+			if (i == 0)
+				track_starts[i] = 0;
+			else if (flag & 1)
+				track_starts[i] = sum;
+			else
+				track_starts[i] = (sum + 1176) / 2352 * 2352;
+		}
+		sum += pl->extents[i];
+	}
+	pl->stream_size = sum + (2352 - sum % 2352) % 2352;
+	if (track_starts != NULL)
+		track_starts[num_paths] = pl->stream_size;
+
+	pl->current = 0;
+	pl->current_ready = 0;
+	pl->file_pos = pl->raw_pos = pl->pos = 0;
+	pl->has_pending = 0;
+	pl->premature_reported = 0;
+
+	src = burn_source_new();
+	if (src == NULL)
+		goto out_of_mem;
+	src->read = NULL;
+	src->read_sub = NULL;
+	src->get_size = playlist_get_size;
+	src->set_size = playlist_set_size;
+	src->free_data = playlist_free;
+	src->data = pl;
+	src->version = 1;
+	src->read_xt = playlist_read;
+	src->cancel = playlist_cancel;
+
+	/* The first file gets prepared while the burn run starts up */
+	playlist_prepare_ahead(pl, 0, 0);
+	return src;
+
+out_of_mem:;
+	libdax_msgs_submit(libdax_messenger, -1, 0x00000003,
+			LIBDAX_MSGS_SEV_FATAL, LIBDAX_MSGS_PRIO_HIGH,
+			"Out of virtual memory", 0, 0);
+failed:;
+	playlist_destroy(&pl, 0);
+	return NULL;
+}
+
+
 /* -------------------- WAVE file extractor ------------------- */
 
 
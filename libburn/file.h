@@ -8,6 +8,8 @@
 #ifndef BURN__FILE_H
 #define BURN__FILE_H
 
+#include <pthread.h>
+
 struct burn_source_file
 {
 	char magic[4];
@@ -20,6 +22,38 @@ struct burn_source_file
 /* ts A70126 : burn_source_file obsoleted burn_source_fd */
 
 
+/* ts C61019 : Overflow of a fifo into a scratch file.
+   See burn_fifo_set_spill() and the spill functions in file.c
+*/
+struct burn_fifo_spill {
+	int fd;
+	int direct;
+
+	/* The file is a ring of slots. Each holds one batch of read chunks
+	   which are packed without gaps.
+	*/
+	int slot_size;
+	int slots;
+	int *slot_len;
+	volatile int writepos; /* changed only by the shoveller */
+	volatile int readpos;  /* changed only by the consumer */
+
+	/* Aligned transfer buffers of shoveller and consumer.
+	   put_len bytes in put_buf wait for being written as one batch.
+	*/
+	char *put_buf;
+	volatile int put_len;
+	char *get_buf;
+	volatile int get_len;
+	volatile int get_off;
+
+	volatile off_t in_counter;
+	volatile off_t out_counter;
+	off_t max_fill;
+	int spill_counter;
+};
+
+
 /* ts A70930 */
 struct burn_source_fifo {
 	char magic[4];
@@ -52,6 +86,10 @@ struct burn_source_fifo {
 	int chunksize;
 	int chunks;
 	char *buf;
+
+	/* ts C61019 : flag for burn_os_alloc_buffer_v2() and its outcome */
+	int buf_alloc_flag;
+	int buf_obtained;
 	volatile int buf_writepos;
 	volatile int buf_readpos;
 	volatile int end_of_input;
@@ -68,6 +106,50 @@ struct burn_source_fifo {
 	int empty_counter;
 	int full_counter;
 
+	/* ts C61019 : See burn_fifo_prefetch(). The first read of the
+	   consumer waits until gate_fill bytes are in the buffer or until
+	   gate_budget seconds have passed since prefetch_start.
+	*/
+	int gate_fill;
+	double gate_budget;
+	double prefetch_start;
+	volatile int gate_open;
+
+	/* ts C61019 : Eventual overflow to disk. See burn_fifo_set_spill() */
+	struct burn_fifo_spill *spill;
+
+	/* ts C61019 : Flow measurement. See burn_fifo_inquire_pressure().
+	   Only the shoveller thread changes these values. It makes
+	   pressure_seq odd while it changes .pressure, so that readers in
+	   other threads can detect and retry torn copies.
+	*/
+	struct burn_drive *drive;
+	struct burn_fifo_pressure pressure;
+	volatile unsigned int pressure_seq;
+	double pressure_time;
+	off_t pressure_in;
+	off_t pressure_out;
+	off_t pressure_fill;
+	int (*pressure_handler)(void *handle,
+				struct burn_fifo_pressure *pressure);
+	void *pressure_handle;
+	double pressure_interval;
+	double pressure_call_time;
+
+	/* ts C61019 : Volume recognition of ISO 9660 and ECMA-167 (UDF) in
+	   the blocks 16 to 31 of the input, done by the shoveller thread while
+	   the data pass. See burn_fifo_inquire_iso().
+	   iso_state gets set last: 0= still collecting, 1= ISO 9660 found,
+	   2= no ISO 9660 found.
+	*/
+	char iso_descr[16 * 2048];
+	int iso_fill;
+	int iso_judged;
+	off_t iso_blocks;
+	char iso_volume_id[33];
+	int iso_fs_types;
+	volatile int iso_state;
+
 };
 
 
@@ -76,6 +158,22 @@ struct burn_source_fifo {
 */
 int burn_fifo_source_shoveller(struct burn_source *source, int flag);
 
+/* ts C61019 */
+/** Tell whether source was created by burn_fifo_source_new() */
+int burn_source_is_fifo(struct burn_source *source, int flag);
+
+/* ts C61019 */
+/** Return the fifo which feeds source directly or via offset sources.
+    NULL if there is none.
+*/
+struct burn_source *burn_source_get_fifo(struct burn_source *source,
+                                         int flag);
+
+/* ts C61019 */
+/** Tell the fifo which drive consumes its data */
+int burn_fifo_set_drive(struct burn_source *source, struct burn_drive *d,
+                        int flag);
+
 
 /* ts B00922 */
 struct burn_source_offst {
@@ -99,4 +197,67 @@ struct burn_source_offst {
 
 };
 
+/* ts C61019 */
+struct libdax_audioxtr;
+
+/* Number of payload bytes which get read in advance from the start of the
+   next audio file of a playlist source: 2 seconds of CD-DA
+*/
+#define Libburn_playlist_prefetcH (2 * 44100 * 4)
+
+struct burn_source_playlist {
+
+	/* See burn_audio_playlist_source_new() */
+	int num_files;
+	char **paths;
+
+	/* Payload size as announced by the file header, with byte swapping
+	   need, and the number of stream bytes the file occupies.
+	*/
+	off_t *sizes;
+	int *swap;
+	off_t *extents;
+	off_t stream_size;
+
+	/* Extractors of the prepared files. All files get validated and
+	   closed by burn_audio_playlist_source_new(). A helper thread opens
+	   the next file and reads its first bytes while the current file
+	   gets consumed. The extractor gets destroyed as soon as the file
+	   is read completely.
+	*/
+	struct libdax_audioxtr **xtrs;
+
+	/* The first bytes of the current file and of its successor */
+	int prefetch_size;
+	char **prefetch;
+	int *prefetch_fill;
+
+	/* Preparation state of each file:
+	   0= closed, 1= being prepared by the helper thread,
+	   2= opened and prefetched, 3= consumed and closed.
+	   states and job_idx are protected by lock.
+	*/
+	int *states;
+	int job_idx;            /* file of the running helper thread or -1 */
+	pthread_mutex_t lock;
+	pthread_cond_t prepared;
+	int lock_valid;
+
+	/* The current reading position */
+	int current;
+	int current_ready;
+	off_t file_pos;
+	off_t raw_pos;
+	off_t pos;
+
+	/* The second byte of a swapped pair which did not fit into the
+	   previous read buffer
+	*/
+	int has_pending;
+	char pending_byte;
+
+	int premature_reported;
+};
+
+
 #endif /* LIBBURN__FILE_H */
@@ -32,6 +32,7 @@
 #include "drive.h"
 #include "transport.h"
 #include "util.h"
+#include "scsitrace.h"
 
 /* ts A60825 : The storage location for back_hacks.h variables. */
 #define BURN_BACK_HACKS_INIT 1
@@ -175,14 +176,21 @@ void burn_finish(void)
 		burn_abort(4440, burn_abort_pacifier, abort_message_prefix);
 	}
 
+	/* ts C61019 */
+	burn_drive_hotplug_listen(0, 0);
+
 	/* ts A60904 : ticket 62, contribution by elmom : name addon "_all" */
-	burn_drive_free_all();
+	/* ts C61019 : also disposes the drive objects */
+	burn_drive_registry_free(0);
 
 	/* ts A60924 : ticket 74 */
 	libdax_msgs_destroy(&libdax_messenger,0);
 
 	sg_shutdown(0);
 
+	/* ts C61019 */
+	burn_scsi_trace_control(1);
+
 	burn_drive_clear_whitelist();
 
 	burn_running = 0;
@@ -638,7 +646,10 @@ int burn_set_messenger(void *messenger)
 /* ts A91111 API */
 void burn_set_scsi_logging(int flag)
 {
-	burn_sg_log_scsi = flag & 7;
+	burn_sg_log_scsi = flag & 15;
+
+	/* ts C61019 */
+	burn_scsi_trace_control(0);
 }
 
 
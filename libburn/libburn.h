@@ -471,7 +471,9 @@ struct burn_source {
 	    EOF (return 0) or failure (return -1) at this call or at the
 	    next following call. I.e. the only incomplete buffer may be the
 	    last one from that source.
-	    libburn will read a single sector by each call to (*read).
+	    libburn will read one or more whole sectors by each call to
+	    (*read). It reads a single sector per call when less than the
+	    requested amount is left of the size reported by (*get_size).
 	    The size of a sector depends on BURN_MODE_*. The known range is
 	    2048 to 2352.
 
@@ -705,6 +707,105 @@ struct burn_progress {
 };
 
 
+/* ts C61019 */
+/** Event types of struct burn_drive_event.
+    @since 1.5.2
+*/
+/** Progress of writing, blanking, or formatting */
+#define BURN_EVENT_PROGRESS  1
+/** The drive status as of burn_drive_get_status() has changed */
+#define BURN_EVENT_STATE     2
+/** The current operation was canceled because of an error or by
+    burn_drive_cancel(). Use burn_msgs_obtain() for details.
+*/
+#define BURN_EVENT_ERROR     3
+/** The operation of a burn_disc_write(), burn_disc_erase(), or
+    burn_disc_format() run has ended. See member .success .
+*/
+#define BURN_EVENT_END       4
+
+
+/* ts C61019 */
+/** A report about the activities of a drive, as delivered by
+    burn_drive_set_event_handler() and burn_drive_get_event().
+    This struct will not grow. Further information would be delivered by
+    new API calls.
+    @since 1.5.2
+*/
+struct burn_drive_event {
+	/** One of the BURN_EVENT_* types */
+	int type;
+	/** The drive status at the time of the event */
+	enum burn_drive_status status;
+	/** The time of the event in seconds since 1970 */
+	double timestamp;
+
+	/** Current track and progress counters as of struct burn_progress */
+	int track;
+	int start_sector;
+	int sectors;
+	int sector;
+	/** The number of bytes sent to the drive buffer */
+	off_t buffered_bytes;
+	/** Capacity and free space of the drive buffer */
+	unsigned buffer_capacity;
+	unsigned buffer_available;
+	/** Size and free space of the fifo which feeds the current track.
+	    -1 if the track source is not a fifo from burn_fifo_source_new().
+	*/
+	int fifo_size;
+	int fifo_free;
+
+	/** With BURN_EVENT_END: 1 if the operation succeeded, 0 if not */
+	int success;
+	/** The number of events which were lost before this one because
+	    the queue of burn_drive_get_event() was full.
+	*/
+	int lost;
+};
+
+
+/* ts C61019 */
+/** Description of the flow through a fifo from burn_fifo_source_new() as
+    seen by the producer of the fifo input. It is obtained by
+    burn_fifo_inquire_pressure() or delivered to the handler which was set
+    by burn_fifo_set_pressure_handler().
+    Rates are in bytes per second and get smoothed over a few seconds.
+    This struct will not grow. Further information would be delivered by
+    new API calls.
+    @since 1.5.2
+*/
+struct burn_fifo_pressure {
+	/** The time of the measurement in seconds since 1970 */
+	double timestamp;
+	/** The rate by which the consumer takes data out of the fifo */
+	double consumer_rate;
+	/** The rate by which the fifo reads its input */
+	double producer_rate;
+	/** The write speed which was set by burn_drive_set_speed() for the
+	    drive which consumes the fifo. Autotuning may temporarily write
+	    slower. 0 if not known yet.
+	*/
+	double drive_rate;
+	/** Size and fill of the fifo. They include the eventual spill file
+	    of burn_fifo_set_spill().
+	*/
+	off_t size;
+	off_t fill;
+	/** The change of fill per second. Negative means draining. */
+	double fill_trend;
+	/** The number of seconds until the fifo would be empty if the input
+	    stopped. -1 if the consumer takes no data yet.
+	*/
+	double seconds_left;
+	/** The input rate which would bring the fifo to 3/4 fill within a
+	    few seconds and keep it there. -1 if the producer should deliver
+	    as fast as it can, e.g. because consumption has not begun yet.
+	*/
+	double suggested_rate;
+};
+
+
 /* ts A61226 */
 /* @since 0.3.0 */
 /** Description of a speed capability as reported by the drive in conjunction
@@ -830,6 +931,13 @@ void burn_set_verbosity(int level);
                  bit0= log to file /tmp/libburn_sg_command_log
                  bit1= log to stderr
                  bit2= flush output after each line
+                 bit3= @since 1.5.2
+                       record a binary trace in the file
+                       /tmp/libburn_sg_command_trace . It gets written
+                       by a background thread and thus is much less
+                       intrusive than bit0 or bit1. The program
+                       test/sgtrace converts it into the text format of
+                       bit0 or replays it against an emulated drive.
     @since 0.7.4
 */
 void burn_set_scsi_logging(int flag);
@@ -988,7 +1096,10 @@ void burn_drive_clear_whitelist(void);
     calls to this function !
     To avoid invalid pointers one MUST free all burn_drive_info arrays
     by burn_drive_info_free() before calling burn_drive_scan() a second time.
-    If there are drives left, then burn_drive_scan() will refuse to work.
+    If there are drives left, then burn_drive_scan() only looks for drives
+    which are not known yet and returns only those. The known drives stay
+    valid and may go on with their operations. (Before version 1.5.2 it
+    refused to work in this situation.)
 
     After this call all drives depicted by the returned array are subject
     to eventual (O_EXCL) locking. See burn_preset_device_open(). This state
@@ -1032,6 +1143,66 @@ int burn_drive_info_forget(struct burn_drive_info *drive_info, int force);
 void burn_drive_info_free(struct burn_drive_info drive_infos[]);
 
 
+/* ts C61019 */
+/** Start or end watching for drives which get attached to or detached from
+    the system while the program runs. Currently this is only supported on
+    GNU/Linux, where the kernel uevents about the devices of the drive
+    family are evaluated. See burn_preset_device_open().
+    @param on    1= start watching, 0= end watching
+    @param flag  Bitfield for control purposes. Unused yet. Submit 0.
+    @return      With on == 1:
+                 A file descriptor which becomes readable when events are
+                 pending. Watch it by poll(2) or select(2) and call
+                 burn_drive_hotplug_check() when it is readable. The file
+                 descriptor belongs to libburn. Do not close it.
+                 -1 = not supported on this system, -2 = failure
+                 With on == 0: always 0
+    @since 1.5.2
+*/
+int burn_drive_hotplug_listen(int on, int flag);
+
+
+/* ts C61019 */
+/** Evaluate the pending events about attached and detached drives.
+    A detached drive gets marked, so that burn_drive_is_detached() reports
+    it. Its struct burn_drive stays valid until the application disposes it
+    by burn_drive_info_forget() or burn_drive_info_free().
+    burn_drive_grab() and the operations which run in a worker thread, like
+    burn_disc_write(), refuse it. Other operations on it will fail.
+    Attached drives get scanned at their announced address like by
+    burn_drive_scan() with drives left known. The whitelist of
+    burn_drive_add_whitelist() applies. Drives which are already known get
+    not reported again.
+    The kernel announces a new drive before it is ready for use. Therefore
+    this call should be repeated as long as it returns 2, e.g. once per
+    second.
+    Do not call this function while burn_drive_scan() is going on.
+    @param drive_infos Returns NULL or an array of drive info items about the
+                  newly found drives. The array must be freed by
+                  burn_drive_info_free() before burn_finish().
+    @param n_drives Returns the number of drive items in drive_infos.
+    @param flag   Bitfield for control purposes. Unused yet. Submit 0.
+    @return  0= no events were pending
+             1= events were processed, new drives are in drive_infos if any
+             2= an announced drive is not usable yet. Call again later.
+                Other new drives may be in drive_infos nevertheless.
+            <0= failure
+    @since 1.5.2
+*/
+int burn_drive_hotplug_check(struct burn_drive_info *drive_infos[],
+                             unsigned int *n_drives, int flag);
+
+
+/* ts C61019 */
+/** Inquire whether a drive was detached from the system according to
+    burn_drive_hotplug_check().
+    @param d     The drive to inquire
+    @return      1= detached, 0= not known to be detached
+    @since 1.5.2
+*/
+int burn_drive_is_detached(struct burn_drive *d);
+
+
 /* ts A60823 */
 /* @since 0.2.2 */
 /** Maximum length+1 to expect with a drive device file address string */
@@ -1650,6 +1821,57 @@ int burn_disc_erasable(struct burn_drive *d);
 enum burn_drive_status burn_drive_get_status(struct burn_drive *drive,
 					     struct burn_progress *p);
 
+
+/* ts C61019 */
+/** Register a function which gets called with each event of the drive,
+    and/or enable the event queue for burn_drive_get_event().
+    This avoids periodic polling of burn_drive_get_status().
+    The handler gets called by the thread which works on the drive. It must
+    return quickly and must not call any libburn function which operates on
+    the drive. Especially it must not wait for the drive to become idle.
+    @param drive   The drive to watch. It must not be busy.
+    @param handler The function to call, or NULL for none.
+                   Its return value is ignored for now. Return 1.
+    @param handle  A pointer which gets handed to the handler as first
+                   parameter.
+    @param sector_step Minimum progress in sectors between two
+                   BURN_EVENT_PROGRESS. 0 chooses the default of 512.
+                   With blanking and formatting the sector counter is a
+                   relative step number of 0 to 0x10000.
+    @param flag    Bitfield for control purposes
+                   bit0= queue the events for burn_drive_get_event()
+                   If handler is NULL and bit0 is 0, then event delivery
+                   gets disabled.
+    @return 1 = success, 0 = drive busy, <0 = failure
+    @since 1.5.2
+*/
+int burn_drive_set_event_handler(struct burn_drive *drive,
+                int (*handler)(void *handle, struct burn_drive_event *event),
+                void *handle, int sector_step, int flag);
+
+/* ts C61019 */
+/** Obtain a file descriptor which becomes readable when events are waiting
+    in the queue of burn_drive_get_event(). It may be watched by poll(2),
+    select(2), or epoll(7) together with the descriptors of other drives.
+    Do not read from it and do not close it.
+    @param drive   The drive with the enabled event queue.
+    @param flag    Bitfield for control purposes. Submit 0.
+    @return The file descriptor, or -1 if the queue is not enabled.
+    @since 1.5.2
+*/
+int burn_drive_get_event_fd(struct burn_drive *drive, int flag);
+
+/* ts C61019 */
+/** Take the oldest event from the queue of the drive.
+    @param drive   The drive with the enabled event queue.
+    @param event   Returns the event content
+    @param flag    Bitfield for control purposes. Submit 0.
+    @return 1 = event delivered, 0 = no event waiting, <0 = failure
+    @since 1.5.2
+*/
+int burn_drive_get_event(struct burn_drive *drive,
+                         struct burn_drive_event *event, int flag);
+
 /** Creates a write_opts struct for burning to the specified drive.
     The returned object must later be freed with burn_write_opts_free().
     @param drive The drive to write with
@@ -1689,6 +1911,9 @@ void burn_read_opts_free(struct burn_read_opts *opts);
     BURN_DISC_FULL before calling this function. An erase operation is not
     cancellable, as control of the operation is passed wholly to the drive and
     there is no way to interrupt it safely.
+    Since 1.5.2, burn_drive_cancel() ends the waiting for the drive. The
+    drive may then still be busy. burn_drive_get_bg_op_times() tells when
+    the drive was seen to be done.
     @param drive The drive with which to erase a disc.
                  Only drive roles 1 (MMC) and 5 (stdio random write-only)
                  support erasing.
@@ -1900,6 +2125,9 @@ int burn_drive_get_immed(struct burn_drive *drive);
 /** Cancel an operation on a drive.
     This will only work when the drive's busy state is BURN_DRIVE_READING or
     BURN_DRIVE_WRITING.
+    Since 1.5.2 it also ends the waiting for blanking or formatting with
+    states BURN_DRIVE_ERASING or BURN_DRIVE_FORMATTING. The drive itself
+    cannot be stopped and may stay busy for a while.
     @param drive The drive on which to cancel the current operation.
 */
 void burn_drive_cancel(struct burn_drive *drive);
@@ -1918,6 +2146,34 @@ void burn_drive_cancel(struct burn_drive *drive);
 int burn_drive_wrote_well(struct burn_drive *d);
 
 
+/* ts C61019 */
+/** Inquire the timing of the most recent blanking or formatting by
+    burn_disc_erase() or burn_disc_format(). libburn polls the drive in
+    short intervals at first and in longer ones as the operation goes on.
+    When the drive reports progress, the interval shrinks again as the
+    predicted end comes near. So a quick blank gets noticed within a few
+    tens of milliseconds after the drive finished.
+    All times are in seconds since 1970, like the timestamp of
+    struct burn_drive_event.
+    @param d          The drive to inquire.
+    @param start_time Returns when the SCSI command was issued.
+                      0 if no blanking or formatting happened yet.
+    @param poll_time  Returns when the drive was asked for progress lately.
+    @param end_time   Returns when the drive was seen ready.
+                      0 if the operation is still going on or if the
+                      waiting was ended by burn_drive_cancel().
+    @param next_poll  Returns the number of seconds between the most recent
+                      poll and the next one. 0 if not waiting any more.
+    @param flag       Bitfield for control purposes. Submit 0.
+    @return           0 = no operation recorded, 1 = operation ended,
+                      2 = operation going on or not seen ending
+    @since 1.5.2
+*/
+int burn_drive_get_bg_op_times(struct burn_drive *d, double *start_time,
+                               double *poll_time, double *end_time,
+                               double *next_poll, int flag);
+
+
 /* ts B31023 */
 /** Inquire whether a write error occurred which is suspected to have happened
     due to a false report about DVD-RW capability to be written in write type
@@ -2049,6 +2305,37 @@ int burn_session_by_cue_file(struct burn_session *session,
                         unsigned char **text_packs, int *num_packs, int flag);
 
 
+/* ts C61019 */
+/** Equip the session object by one audio track per file of a list of
+    .wav or .au files. The files get read as one continuous stream by a
+    source from burn_audio_playlist_source_new(). So no file gets opened or
+    parsed while the burn run is at a track transition, and the audio
+    passes the track boundaries without gaps or padding.
+    The tracks get no pregap except the one which libburn prescribes for
+    the first track.
+    @param session     Session where to attach tracks. It must not yet have
+                       tracks or else this call will fail.
+    @param paths       Filesystem addresses of the audio files. They have to
+                       contain 44100 Hz, 16 bit, stereo samples.
+    @param num_paths   Number of paths. At most 99.
+    @param fifo_size   Number of bytes in fifo. This will be rounded up by
+                       the block size 2352. <= 0 means no fifo.
+    @param fifo        Returns a reference to the burn_source object that
+                       was installed as fifo between playlist and the track
+                       burn sources. See burn_session_by_cue_file().
+                       It is permissible to submit NULL.
+    @param flag        Bitfield for control purposes.
+                       bit0= Pad each file to full sectors rather than
+                             putting the track boundaries to the sector
+                             which is nearest to the end of the file.
+    @return            > 0 indicates success, <= 0 indicates failure
+    @since 1.5.2
+*/
+int burn_session_by_audio_files(struct burn_session *session,
+			char **paths, int num_paths, int fifo_size,
+			struct burn_source **fifo, int flag);
+
+
 /** Create a track */
 struct burn_track *burn_track_create(void);
 
@@ -2675,6 +2962,9 @@ int burn_track_set_byte_swap(struct burn_track *t, int swap_source_bytes);
 void burn_session_hide_first_track(struct burn_session *s, int onoff);
 
 /** Get the drive's disc struct - free when done
+    Since 1.5.2 the TOC of DVD and BD media with more than one track gets
+    inquired by the first call after grabbing. This needs a grabbed, idle
+    drive. The result stays valid until the media state changes.
 	@param d drive to query
 	@return the disc struct or NULL on failure
 */
@@ -2751,7 +3041,21 @@ int burn_os_open_track_src(char *path, int open_flags, int flag);
     @param amount     Number of bytes to allocate. This should be a multiple
                       of the operating system's i/o block size. 32 KB is
                       guaranteed by libburn to be safe.
-    @param flag       Bitfield for control purposes (unused yet, submit 0).
+    @param flag       Bitfield for control purposes:
+                      bit0= Do not fill the memory with zeros. The content
+                            is undefined. On Linux the memory pages get
+                            placed on the memory node of the thread which
+                            first writes to them. Else the calling thread
+                            decides.
+                            @since 1.5.2
+                      bit1= Advise the operating system to use transparent
+                            huge pages, if amount is at least as large as
+                            a huge page.
+                            @since 1.5.2
+                      bit2= Try to use explicit huge pages, which need to be
+                            reserved by the system administrator. If this
+                            fails, then proceed as with bit1.
+                            @since 1.5.2
     @return           The address of the allocated memory, or NULL on failure.
                       A non-NULL return value has finally to be disposed via
                       burn_os_free_buffer().
@@ -2759,6 +3063,24 @@ int burn_os_open_track_src(char *path, int open_flags, int flag);
 */
 void *burn_os_alloc_buffer(size_t amount, int flag);
 
+/* ts C61019 */
+/** Allocate a memory area like burn_os_alloc_buffer() and tell which
+    properties it actually got.
+    @param amount     Number of bytes to allocate.
+    @param flag       Bitfield for control purposes. See burn_os_alloc_buffer().
+    @param obtained   If not NULL: returns a bitfield telling the properties
+                      of the memory area:
+                      bit0= it was mapped by mmap(2) rather than malloc(3)
+                      bit1= transparent huge pages were advised successfully
+                      bit2= it consists of explicit huge pages
+                      bit3= it was filled with zeros by the calling thread
+    @return           The address of the allocated memory, or NULL on failure.
+                      A non-NULL return value has finally to be disposed via
+                      burn_os_free_buffer().
+    @since 1.5.2
+*/
+void *burn_os_alloc_buffer_v2(size_t amount, int flag, int *obtained);
+
 /** Dispose a memory area which was obtained by burn_os_alloc_buffer(),
     @param buffer     Memory address to be freed.
     @param amount     The number of bytes which was allocated at that
@@ -2826,6 +3148,41 @@ struct burn_source *burn_offst_source_new(
                 struct burn_source *inp, struct burn_source *prev,
                 off_t start, off_t size, int flag);
 
+
+/* ts C61019 */
+/** Creates a data source which delivers the audio payload of a list of
+    .wav or .au files as one continuous stream of CD-DA bytes in LSB first
+    byte order. All files get checked by this call and closed again.
+    While a file gets read, a helper thread opens the next file and reads
+    its first bytes into memory. So track transitions need no opening and
+    no header parsing. Each file gets closed when it is read completely.
+    Files which deliver less bytes than announced by their header get
+    padded by zeros. The stream gets padded up to a multiple of 2352 bytes.
+    Use burn_offst_source_new() with the addresses from track_starts to
+    feed one track per file. See also burn_session_by_audio_files().
+    @param paths          Filesystem addresses of the audio files. They have
+                          to contain 44100 Hz, 16 bit, stereo samples.
+    @param num_paths      Number of paths. At most 99.
+    @param prefetch_bytes Number of bytes to read in advance from the start
+                          of each file. -1 means 2 seconds of audio.
+    @param track_starts   NULL or an array of num_paths + 1 elements.
+                          Returns the stream byte addresses where the tracks
+                          for the files shall start. These are multiples of
+                          2352. The last element tells the stream size.
+    @param flag           Bitfield for control purposes
+                          bit0= Pad each file to full 2352 byte sectors.
+                                Else the files follow each other without
+                                gap and the track start addresses get
+                                rounded to the nearest sector boundary.
+    @return               Pointer to a burn_source object, later to be
+                          freed by burn_source_free(). NULL indicates
+                          failure.
+    @since 1.5.2
+*/
+struct burn_source *burn_audio_playlist_source_new(char **paths,
+                int num_paths, int prefetch_bytes, off_t *track_starts,
+                int flag);
+
 /* ts A70930 */
 /** Creates a fifo which acts as proxy for an already existing data source.
     The fifo provides a ring buffer which shall smoothen the data stream
@@ -2863,6 +3220,11 @@ struct burn_source *burn_offst_source_new(
                             with burn_os_open_track_src().
                             Better do not use with other inp types.
                             @since 0.7.4
+                      bit1= Try to use explicit huge pages for the buffer.
+                            See burn_os_alloc_buffer() flag bit2.
+                            Without this bit, transparent huge pages get
+                            advised for large buffers.
+                            @since 1.5.2
     @return           A pointer to the newly created burn_source.
                       Later both burn_sources, inp and the returned fifo, have
                       to be disposed by calling burn_source_free() for each.
@@ -2895,6 +3257,20 @@ struct burn_source *burn_fifo_source_new(struct burn_source *inp,
 int burn_fifo_inquire_status(struct burn_source *fifo, int *size, 
                             int *free_bytes, char **status_text);
 
+/* ts C61019 */
+/** Inquire the memory properties of the buffer of a fifo burn_source.
+    The buffer exists only while the fifo is active.
+    @param fifo      The fifo object to inquire
+    @param size      Returns the size of the buffer in bytes
+    @param obtained  Returns the memory properties as described with
+                     parameter obtained of burn_os_alloc_buffer_v2()
+    @param flag      Bitfield for control purposes (unused yet, submit 0).
+    @return          1= buffer exists , 0= no buffer , -1= fifo is not a fifo
+    @since 1.5.2
+*/
+int burn_fifo_inquire_memory(struct burn_source *fifo, off_t *size,
+                             int *obtained, int flag);
+
 /* ts A91125 */
 /** Inquire various counters which reflect the fifo operation.
     @param fifo              The fifo object to inquire
@@ -2965,6 +3341,161 @@ int burn_fifo_peek_data(struct burn_source *fifo, char *buf, int bufsize,
 */
 int burn_fifo_fill(struct burn_source *fifo, int fill, int flag);
 
+/* ts C61019 */
+/** Start the fifo worker thread without waiting for data. This lets the
+    fifo fill in the background while the drive gets grabbed and inspected,
+    and while burn_disc_write() performs its preparations.
+    The first read of the consumer will then wait until the fifo has reached
+    the desired fill level, or until the time budget is used up, or until
+    the input has ended.
+    This call is only allowed before consumption of the fifo has begun.
+    It does not disturb burn_fifo_peek_data() and burn_fifo_fill().
+    @param fifo          The fifo object to start
+    @param fill_percent  The fill level in percent of the usable fifo size
+                         which has to be reached before the consumer gets
+                         data. The usable size is fifo size minus one read
+                         chunk. 0 means that the consumer shall not wait.
+    @param time_budget   The maximum number of seconds since this call for
+                         which the consumer shall wait. <= 0 means no limit.
+    @param flag          Bitfield for control purposes (unused yet, submit 0).
+    @return              <0 on severe error, 0 if consumption has begun
+                         already, 1 if the fifo is started
+    @since 1.5.2
+*/
+int burn_fifo_prefetch(struct burn_source *fifo, int fill_percent,
+                       double time_budget, int flag);
+
+/* ts C61019 */
+/** Inquire the progress of the background filling which was started by
+    burn_fifo_prefetch().
+    @param fifo      The fifo object to inquire
+    @param target    Returns the number of bytes which the consumer waits for
+    @param fill      Returns the number of bytes in the fifo
+    @param eta       Returns the estimated number of seconds until the first
+                     read of the consumer will be served, judged by the input
+                     rate since burn_fifo_prefetch(). 0 means that the target
+                     is reached, -1 means that no estimation is possible yet.
+    @param flag      Bitfield for control purposes (unused yet, submit 0).
+    @return          <0 fifo is not a fifo, 0 no consumer is waiting or will
+                     have to wait, 1 the first read of the consumer is still
+                     gated
+    @since 1.5.2
+*/
+int burn_fifo_inquire_prefetch(struct burn_source *fifo, int *target,
+                               int *fill, double *eta, int flag);
+
+/* ts C61019 */
+/** Give a fifo a scratch file on disk where input data go when the buffer
+    in memory is full. The data flow back to the consumer in their original
+    sequence. So the fifo can bridge input bursts and input stalls which
+    are much larger than the 1 GB limit of burn_fifo_source_new().
+    The file gets created anew, its disk space gets reserved, and it gets
+    accessed with O_DIRECT if the operating system and filesystem allow it.
+    This call is only allowed before the fifo gets started.
+    @param fifo  The fifo object to equip
+    @param path  Filesystem address where to create the file. It must not
+                 exist yet. NULL removes an eventual spill file from fifo.
+    @param size  Number of bytes to reserve. The input chunks of the fifo
+                 get packed without gaps and written in batches of up to
+                 1 MiB.
+    @param flag  Bitfield for control purposes.
+                 bit0= Do not remove the file from the filesystem.
+                       Normally it gets removed right after creation and
+                       vanishes when the fifo gets disposed.
+    @return      <0 on severe error, 0 on failure, 1 on success
+    @since 1.5.2
+*/
+int burn_fifo_set_spill(struct burn_source *fifo, char *path, off_t size,
+                        int flag);
+
+/* ts C61019 */
+/** Inquire the fill of memory and disk of a fifo.
+    @param fifo          The fifo object to inquire
+    @param disk_size     Returns the size of the spill file. 0 if none.
+    @param disk_fill     Returns the number of data bytes on disk
+    @param mem_size      Returns the size of the buffer in memory
+    @param mem_fill      Returns the number of data bytes in memory
+    @param max_disk_fill Returns the largest number of data bytes which
+                         were on disk at the same time
+    @param flag          Bitfield for control purposes (unused yet, submit 0).
+    @return              <0 fifo is not a fifo, 0 no spill file,
+                         1 spill file is in use
+    @since 1.5.2
+*/
+int burn_fifo_inquire_spill(struct burn_source *fifo,
+                            off_t *disk_size, off_t *disk_fill,
+                            int *mem_size, int *mem_fill,
+                            off_t *max_disk_fill, int flag);
+
+/* ts C61019 */
+/** Inquire the consumption rate, the drive speed and the fill trend of
+    a fifo, so that the producer of the fifo input can adapt its pace.
+    The measurement gets renewed by the fifo thread a few times per second.
+    @param fifo      The fifo object to inquire
+    @param pressure  Returns the measurement
+    @param flag      Bitfield for control purposes (unused yet, submit 0).
+    @return          <0 fifo is not a fifo, 0 no measurement yet, 1 success
+    @since 1.5.2
+*/
+int burn_fifo_inquire_pressure(struct burn_source *fifo,
+                               struct burn_fifo_pressure *pressure, int flag);
+
+/* ts C61019 */
+/** Set a handler function which gets the measurements of
+    burn_fifo_inquire_pressure() in regular intervals.
+    The handler gets called by the fifo thread right before it reads from
+    the fifo input. So the producer may throttle itself by letting the
+    handler sleep. It must not call libburn functions which operate on this
+    fifo or on the drive.
+    @param fifo      The fifo object to observe
+    @param handler   The function to call. NULL removes the handler.
+                     Its return value is ignored for now. Return 1.
+    @param handle    An opaque pointer which will be submitted to handler
+    @param interval  Minimum number of seconds between handler calls.
+                     <= 0 means 1 second.
+    @param flag      Bitfield for control purposes (unused yet, submit 0).
+    @return          <0 fifo is not a fifo, 1 success
+    @since 1.5.2
+*/
+int burn_fifo_set_pressure_handler(struct burn_source *fifo,
+                int (*handler)(void *handle,
+                               struct burn_fifo_pressure *pressure),
+                void *handle, double interval, int flag);
+
+/* ts C61019 */
+/** Inquire the volume recognition of ISO 9660 and UDF which the fifo
+    performs on its input data while they pass. The blocks 16 to 31 of the
+    input get recorded and judged without any extra read or seek on the
+    input. The judgement ends at the first block which is not a volume
+    structure descriptor of ISO 9660 or ECMA-167.
+    This is suitable for determining the track size of an ISO 9660 image
+    which comes from a pipe, like cdrecord option -isosize does.
+    @param fifo          The fifo object to inquire, or an offset source
+                         from burn_offst_source_new() which reads from it.
+    @param image_blocks  Returns the size of the ISO 9660 filesystem as
+                         recorded in its Primary Volume Descriptor, counted
+                         in blocks of 2048 bytes.
+    @param volume_id     Returns the Volume Id of the Primary Volume
+                         Descriptor without trailing blanks.
+    @param descr         If not NULL: Returns the 32 KiB of the blocks 16
+                         to 31. Blocks which did not arrive are zeroed.
+    @param fs_types      Returns the found volume structures:
+                         bit0= ISO 9660 Primary Volume Descriptor
+                         bit1= Joliet Supplementary Volume Descriptor
+                         bit2= El Torito Boot Record
+                         bit3= UDF NSR descriptor
+    @param flag          Bitfield for control purposes:
+                         bit0= Start the fifo if not yet done and wait until
+                               the judgement is done, or until the input
+                               ended, or until the fifo is full.
+    @return              <0 fifo is not a fifo, 0 judgement not done yet,
+                         1= ISO 9660 found, 2= no ISO 9660 found
+    @since 1.5.2
+*/
+int burn_fifo_inquire_iso(struct burn_source *fifo, off_t *image_blocks,
+                          char volume_id[33], char *descr, int *fs_types,
+                          int flag);
+
 
 /* ts A70328 */
 /** Sets a fixed track size after the data source object has already been
@@ -3245,6 +3776,59 @@ int burn_write_opts_set_leadin_text(struct burn_write_opts *opts,
                                     int num_packs, int flag);
 
 
+/* ts C61019 */
+/** Submit new content for the blocks 16 to 31 of overwritable media, which
+    shall be written after the last track of the write run. This allows to
+    emulate multi-session on DVD+RW, DVD-RAM, formatted DVD-RW, BD-RE, and
+    on random access stdio drives, by updating the ISO 9660 volume
+    descriptors of an image which gets grown by the write run.
+    The write start address of the write run has to be at least 64 KiB,
+    so that the new track does not overlap the head.
+    Only those blocks get written which differ from the head that was read
+    by burn_disc_read_iso_head() or written by a previous write run. The
+    flushing of the drive buffer at the end of the track also commits these
+    blocks, so that no burn_random_access_write() with flushing is needed.
+    If the write run fails, then the head does not get written.
+    @param opts        The option object to be manipulated
+    @param head        32 KiB of data for the blocks 16 to 31 of the medium.
+                       NULL removes a previously submitted head.
+    @param flag        Bitfield for control purposes. Unused yet, submit 0.
+    @return            1 on success, <= 0 on failure
+    @since 1.5.2
+*/
+int burn_write_opts_set_iso_head(struct burn_write_opts *opts, char *head,
+                                 int flag);
+
+
+/* ts C61019 */
+/** Let the write run adapt the write speed of DVD and BD media to the pace
+    which the track source and the drive buffer actually sustain.
+    The speed which was set by burn_drive_set_speed() serves as upper limit.
+    The write run watches the fill of the fifo of the track source, the
+    fill of the drive buffer, and the time which libburn waited for free
+    space in the drive buffer. If the fifo runs low while the drive buffer
+    drains, then the speed gets lowered to the next speed descriptor which
+    the input rate can sustain. If the fifo stays well filled, or if
+    libburn had to wait for the drive, then the speed gets raised by one
+    step of the speed descriptor list. Each change is reported by a NOTE
+    message.
+    CD media do not get tuned, because their write speed should not be
+    changed within a session.
+    @param opts        The option object to be manipulated
+    @param min_speed   The lowest speed in kB/s (1000 bytes/s) to which
+                       the write run may go down. 0 = no limit.
+    @param interval    The minimum number of seconds between decisions.
+                       <= 0 means the default of 4 seconds.
+    @param flag        Bitfield for control purposes.
+                       bit0= enable autotuning. 0 disables it.
+    @return            1 on success, <= 0 on failure
+    @since 1.5.2
+*/
+int burn_write_opts_set_speed_autotune(struct burn_write_opts *opts,
+                                       int min_speed, double interval,
+                                       int flag);
+
+
 /* ts A61222 */
 /** Sets a start address for writing to media and write modes which are able
     to choose this address at all (for now: DVD+RW, DVD-RAM, formatted DVD-RW).
@@ -4060,6 +4644,31 @@ int burn_read_data(struct burn_drive *d, off_t byte_address,
                    char data[], off_t data_size, off_t *data_count, int flag);
 
 
+/* ts C61019 */
+/** Obtain the first 64 KiB of the medium and inquire the size of an
+    ISO 9660 filesystem which begins at block 0. The data get kept in a
+    cache of the drive object. Subsequent calls take them from there, as
+    long as the drive was not released or grabbed again and no write run,
+    blanking, formatting, or burn_random_access_write() altered the start
+    of the medium. A write run with burn_write_opts_set_iso_head() updates
+    the cache.
+    The drive must be grabbed successfully before calling this function.
+    @param d            The drive from which to read
+    @param head         Returns 64 KiB of data from block 0 to 31.
+                        May be NULL if only the size is of interest.
+    @param image_blocks Returns the size of the ISO 9660 filesystem as
+                        recorded in the Primary Volume Descriptor, counted
+                        in blocks of 2048 bytes. 0 if no ISO 9660 was found.
+    @param flag         Bitfield for control purposes:
+                        bit0= read from the medium even if the cache is
+                              valid
+    @return 1= ISO 9660 found , 2= no ISO 9660 found , <=0 error
+    @since 1.5.2
+*/
+int burn_disc_read_iso_head(struct burn_drive *d, char *head,
+                            off_t *image_blocks, int flag);
+
+
 /* ts B21119 */
 /** Read CD audio sectors in random access mode.
     The drive must be grabbed successfully before calling this function.
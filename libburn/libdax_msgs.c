@@ -29,14 +29,17 @@
 
 
 static int libdax_msgs_item_new(struct libdax_msgs_item **item,
-                         struct libdax_msgs_item *link, int flag)
+                         struct libdax_msgs_item *link, int text_size,
+                         int flag)
 {
  int ret;
  struct libdax_msgs_item *o;
  struct timeval tv;
 
- (*item)= o= 
-        (struct libdax_msgs_item *) calloc(1, sizeof(struct libdax_msgs_item));
+ if(text_size<0)
+   text_size= 0;
+ (*item)= o= (struct libdax_msgs_item *)
+                      calloc(1, sizeof(struct libdax_msgs_item) + text_size);
  if(o==NULL)
    return(-1);
  o->timestamp= 0.0;
@@ -49,6 +52,8 @@ static int libdax_msgs_item_new(struct libdax_msgs_item **item,
  o->priority= LIBDAX_MSGS_PRIO_ZERO;
  o->error_code= 0;
  o->msg_text= NULL;
+ if(text_size>0)
+   o->msg_text= (char *) (o+1);
  o->os_errno= 0;
  o->prev= link;
  o->next= NULL;
@@ -93,7 +98,7 @@ int libdax_msgs_item_destroy(struct libdax_msgs_item **item,
  if(o==NULL)
    return(0);
  libdax_msgs_item_unlink(o,NULL,NULL,0); 
- if(o->msg_text!=NULL)
+ if(o->msg_text!=NULL && o->msg_text!=(char *) (o+1))
    free((char *) o->msg_text);
  free((char *) o);
  *item= NULL;
@@ -139,13 +144,29 @@ int libdax_msgs_new(struct libdax_msgs **m, int flag)
 {
  struct libdax_msgs *o;
 
+ unsigned int i;
+
  (*m)= o= (struct libdax_msgs *) calloc(1, sizeof(struct libdax_msgs));
  if(o==NULL)
    return(-1);
  o->refcount= 1;
  o->oldest= NULL;
  o->youngest= NULL;
- o->count= 0;
+ o->count= LIBDAX_MSGS_RING_MARK;
+ o->ring= (struct libdax_msgs_slot *)
+          calloc(LIBDAX_MSGS_RING_SLOTS, sizeof(struct libdax_msgs_slot));
+ if(o->ring==NULL) {
+   free((char *) o);
+   *m= NULL;
+   return(-1);
+ }
+ for(i= 0; i<LIBDAX_MSGS_RING_SLOTS; i++)
+   o->ring[i].sequence= i;
+ o->ring_mask= LIBDAX_MSGS_RING_SLOTS - 1;
+ o->enqueue_pos= 0;
+ o->dequeue_pos= 0;
+ o->dropped= 0;
+ o->dropped_severity= LIBDAX_MSGS_SEV_ALL;
  o->queue_severity= LIBDAX_MSGS_SEV_ALL;
  o->print_severity= LIBDAX_MSGS_SEV_NEVER;
  strcpy(o->print_id,"libdax: ");
@@ -192,6 +213,7 @@ int libdax_msgs_destroy(struct libdax_msgs **m, int flag)
 {
  struct libdax_msgs *o;
  struct libdax_msgs_item *item, *next_item;
+ unsigned int i;
 
  o= *m;
  if(o==NULL)
@@ -216,6 +238,12 @@ int libdax_msgs_destroy(struct libdax_msgs **m, int flag)
    next_item= item->next;
    libdax_msgs_item_destroy(&item,0);
  }
+ if(o->count<0 && o->ring!=NULL) {
+   for(i= 0; i<=o->ring_mask; i++)
+     if(o->ring[i].long_text!=NULL)
+       free(o->ring[i].long_text);
+   free((char *) o->ring);
+ }
  free((char *) o);
  *m= NULL;
  return(1);
@@ -326,6 +354,263 @@ int libdax_msgs__sev_to_text(int severity, char **severity_name,
 }
 
 
+/* ------------------------- submission ring ---------------------------- */
+
+/* ts C61019 :
+   Bounded multi-producer single-consumer ring after the sequence number
+   scheme of Dmitry Vyukov. A submitter claims a slot by advancing
+   enqueue_pos and publishes it by setting the slot's sequence number.
+   The consumer holds lock_mutex anyway.
+   Without atomic builtins the submitters take lock_mutex too.
+*/
+#ifndef LIBDAX_MSGS_SINGLE_THREADED
+#ifdef __GNUC__
+#define LIBDAX_MSGS_LOCK_FREE 1
+#endif
+#endif
+
+#ifdef LIBDAX_MSGS_LOCK_FREE
+#define LIBDAX_MSGS_BARRIER __sync_synchronize()
+#else
+#define LIBDAX_MSGS_BARRIER
+#endif
+
+
+static int libdax_msgs_claim(volatile unsigned int *pos,
+                             unsigned int old_value, int flag)
+{
+#ifdef LIBDAX_MSGS_LOCK_FREE
+ return(__sync_bool_compare_and_swap(pos,old_value,old_value+1));
+#else
+ if(*pos!=old_value)
+   return(0);
+ (*pos)++;
+ return(1);
+#endif
+}
+
+
+static int libdax_msgs_count_lost(struct libdax_msgs *m, int severity,
+                                  int flag)
+{
+#ifdef LIBDAX_MSGS_LOCK_FREE
+ int old_sev;
+
+ __sync_fetch_and_add(&(m->dropped),1);
+ while(1) {
+   old_sev= m->dropped_severity;
+   if(old_sev>=severity)
+ break;
+   if(__sync_bool_compare_and_swap(&(m->dropped_severity),old_sev,severity))
+ break;
+ }
+#else
+ m->dropped++;
+ if(m->dropped_severity<severity)
+   m->dropped_severity= severity;
+#endif
+ return(1);
+}
+
+
+static int libdax_msgs_ring_drain(struct libdax_msgs *m, int flag);
+
+static int libdax_msgs_append(struct libdax_msgs *m, double timestamp,
+                   pid_t process_id, int origin, int error_code,
+                   int severity, int priority, char *msg_text, int os_errno,
+                   int flag);
+
+
+/* Messages of severity SORRY and above must not get lost if the ring is
+   full. Such a message empties the ring into the list and gets appended
+   to the list. This keeps the order of the messages.
+   @param flag bit0= lock_mutex is already obtained
+*/
+static int libdax_msgs_ring_overflow(struct libdax_msgs *m, int origin,
+                                int error_code, int severity, int priority,
+                                char *msg_text, int os_errno, int flag)
+{
+ int ret;
+ struct timeval tv;
+ double timestamp= 0.0;
+
+ if(gettimeofday(&tv, NULL)==0)
+   timestamp= tv.tv_sec+0.000001*tv.tv_usec;
+ if(!(flag & 1)) {
+   ret= libdax_msgs_lock(m,0);
+   if(ret<=0)
+     return(-1);
+ }
+ libdax_msgs_ring_drain(m,0);
+ ret= libdax_msgs_append(m,timestamp,getpid(),origin,error_code,severity,
+                         priority,msg_text,os_errno,0);
+ if(!(flag & 1))
+   libdax_msgs_unlock(m,0);
+ return(ret);
+}
+
+
+static int libdax_msgs_ring_put(struct libdax_msgs *m, int origin,
+                                int error_code, int severity, int priority,
+                                char *msg_text, int os_errno, int flag)
+{
+ int ret, dif, len;
+ unsigned int pos;
+ struct libdax_msgs_slot *slot;
+ struct timeval tv;
+
+#ifndef LIBDAX_MSGS_LOCK_FREE
+ ret= libdax_msgs_lock(m,0);
+ if(ret<=0)
+   return(-1);
+#endif
+
+ pos= m->enqueue_pos;
+ while(1) {
+   slot= m->ring + (pos & m->ring_mask);
+   dif= (int) (slot->sequence - pos);
+   if(dif==0) {
+     if(libdax_msgs_claim(&(m->enqueue_pos),pos,0))
+ break;
+   } else if(dif<0) {
+     /* The consumer did not keep pace */
+     if(severity>=LIBDAX_MSGS_SEV_SORRY) {
+#ifdef LIBDAX_MSGS_LOCK_FREE
+       ret= libdax_msgs_ring_overflow(m,origin,error_code,severity,priority,
+                                      msg_text,os_errno,0);
+#else
+       ret= libdax_msgs_ring_overflow(m,origin,error_code,severity,priority,
+                                      msg_text,os_errno,1);
+#endif
+       goto ex;
+     }
+     libdax_msgs_count_lost(m,severity,0);
+     ret= 0; goto ex;
+   }
+   pos= m->enqueue_pos;
+ }
+
+ slot->timestamp= 0.0;
+ if(gettimeofday(&tv, NULL)==0)
+   slot->timestamp= tv.tv_sec+0.000001*tv.tv_usec;
+ slot->process_id= getpid();
+ slot->origin= origin;
+ slot->severity= severity;
+ slot->priority= priority;
+ slot->error_code= error_code;
+ slot->os_errno= os_errno;
+ slot->long_text= NULL;
+ slot->has_text= (msg_text!=NULL);
+ slot->text[0]= 0;
+ if(msg_text!=NULL) {
+   len= strlen(msg_text);
+   if(len<LIBDAX_MSGS_SLOT_TEXT) {
+     memcpy(slot->text,msg_text,len+1);
+   } else {
+     slot->long_text= strdup(msg_text);
+     if(slot->long_text==NULL) {
+       memcpy(slot->text,msg_text,LIBDAX_MSGS_SLOT_TEXT-1);
+       slot->text[LIBDAX_MSGS_SLOT_TEXT-1]= 0;
+     }
+   }
+ }
+ LIBDAX_MSGS_BARRIER;
+ slot->sequence= pos+1;
+ ret= 1;
+ex:;
+
+#ifndef LIBDAX_MSGS_LOCK_FREE
+ libdax_msgs_unlock(m,0);
+#endif
+
+ return(ret);
+}
+
+
+/* Append a message to the list oldest ... youngest.
+   To be called under lock_mutex.
+*/
+static int libdax_msgs_append(struct libdax_msgs *m, double timestamp,
+                   pid_t process_id, int origin, int error_code,
+                   int severity, int priority, char *msg_text, int os_errno,
+                   int flag)
+{
+ int ret;
+ struct libdax_msgs_item *item= NULL;
+
+ ret= libdax_msgs_item_new(&item,m->youngest,
+                           msg_text==NULL ? 0 : strlen(msg_text)+1,0);
+ if(ret<=0)
+   return(-1);
+ item->timestamp= timestamp;
+ item->process_id= process_id;
+ item->origin= origin;
+ item->error_code= error_code;
+ item->severity= severity;
+ item->priority= priority;
+ if(msg_text!=NULL)
+   strcpy(item->msg_text,msg_text);
+ item->os_errno= os_errno;
+ if(m->oldest==NULL)
+   m->oldest= item;
+ m->youngest= item;
+ return(1);
+}
+
+
+/* Move the content of the ring into the list oldest ... youngest.
+   To be called under lock_mutex.
+*/
+static int libdax_msgs_ring_drain(struct libdax_msgs *m, int flag)
+{
+ int ret, lost, severity;
+ unsigned int pos;
+ char *text, lost_text[80];
+ struct libdax_msgs_slot *slot;
+ struct timeval tv;
+
+ while(1) {
+   pos= m->dequeue_pos;
+   slot= m->ring + (pos & m->ring_mask);
+   if((int) (slot->sequence - (pos+1)) < 0)
+ break; /* empty, or the oldest slot is still being filled */
+   LIBDAX_MSGS_BARRIER;
+   text= NULL;
+   if(slot->long_text!=NULL)
+     text= slot->long_text;
+   else if(slot->has_text)
+     text= slot->text;
+   ret= libdax_msgs_append(m,slot->timestamp,slot->process_id,slot->origin,
+                           slot->error_code,slot->severity,slot->priority,
+                           text,slot->os_errno,0);
+   if(ret<=0)
+     libdax_msgs_count_lost(m,slot->severity,0);
+   if(slot->long_text!=NULL)
+     free(slot->long_text);
+   slot->long_text= NULL;
+   LIBDAX_MSGS_BARRIER;
+   slot->sequence= pos+m->ring_mask+1;
+   m->dequeue_pos= pos+1;
+ }
+
+ lost= m->dropped;
+ if(lost<=0)
+   return(1);
+ severity= m->dropped_severity;
+#ifdef LIBDAX_MSGS_LOCK_FREE
+ __sync_fetch_and_sub(&(m->dropped),lost);
+#else
+ m->dropped-= lost;
+#endif
+ m->dropped_severity= LIBDAX_MSGS_SEV_ALL;
+ sprintf(lost_text,"%d messages lost due to full message queue",lost);
+ gettimeofday(&tv, NULL);
+ libdax_msgs_append(m,tv.tv_sec+0.000001*tv.tv_usec,getpid(),-1,0x00000005,
+                    severity,LIBDAX_MSGS_PRIO_HIGH,lost_text,0,0);
+ return(1);
+}
+
+
 /*
     @param flag Bitfield for control purposes
                     bit0= If direct output to stderr:
@@ -364,10 +649,15 @@ int libdax_msgs_submit(struct libdax_msgs *m, int origin, int error_code,
  if(severity < m->queue_severity)
    return(0);
 
+ /* ts C61019 */
+ if(m->count<0)
+   return(libdax_msgs_ring_put(m,origin,error_code,severity,priority,
+                               msg_text,os_errno,0));
+
  ret= libdax_msgs_lock(m,0);
  if(ret<=0)
    return(-1);
- ret= libdax_msgs_item_new(&item,m->youngest,0);
+ ret= libdax_msgs_item_new(&item,m->youngest,0,0);
  if(ret<=0)
    goto failed;
  item->origin= origin;
@@ -410,6 +700,11 @@ int libdax_msgs_obtain(struct libdax_msgs *m, struct libdax_msgs_item **item,
  ret= libdax_msgs_lock(m,0);
  if(ret<=0)
    return(-1);
+
+ /* ts C61019 */
+ if(m->count<0)
+   libdax_msgs_ring_drain(m,0);
+
  for(im= m->oldest; im!=NULL; im= next_im) {
    for(; im!=NULL; im= next_im) {
      next_im= im->next;
@@ -41,6 +41,38 @@ struct libdax_msgs_item {
 };
 
 
+/* ts C61019 : Preallocated slot of the submission ring */
+#define LIBDAX_MSGS_RING_SLOTS   1024
+#define LIBDAX_MSGS_SLOT_TEXT     256
+
+struct libdax_msgs_slot {
+
+ /* Ring position for which the slot is ready to take or give a message */
+ volatile unsigned int sequence;
+
+ double timestamp;
+ pid_t process_id;
+ int origin;
+ int severity;
+ int priority;
+ int error_code;
+ int os_errno;
+
+ /* Messages longer than LIBDAX_MSGS_SLOT_TEXT - 1 get a heap copy */
+ int has_text;
+ char *long_text;
+ char text[LIBDAX_MSGS_SLOT_TEXT];
+
+};
+
+
+/* Marks objects which have a submission ring in count. Older variants of
+   this code only ever increment count. So it stays negative if an old
+   libiso_msgs shares the object, and then both queues get served.
+*/
+#define LIBDAX_MSGS_RING_MARK  (-0x40000000)
+
+
 struct libdax_msgs {
 
  int refcount;
@@ -57,6 +89,20 @@ struct libdax_msgs {
  pthread_mutex_t lock_mutex;
 #endif
 
+ /* ts C61019 : Bounded multi-producer single-consumer ring. Submitters do
+    not take lock_mutex. The consumer moves the ring content into the
+    list oldest ... youngest while it holds lock_mutex.
+    The following members exist only if count < 0. Objects made by older
+    variants of libdax_msgs_new() end at lock_mutex.
+ */
+ struct libdax_msgs_slot *ring;
+ unsigned int ring_mask;
+ volatile unsigned int enqueue_pos;
+ unsigned int dequeue_pos;
+
+ /* Overflow accounting */
+ volatile int dropped;
+ volatile int dropped_severity;
 
 };
 
@@ -307,6 +353,10 @@ int libdax_msgs_refer(struct libdax_msgs **pt, struct libdax_msgs *o, int flag);
                     bit0= If direct output to stderr:
                           CarriageReturn rather than LineFeed
     @return 1 on success, 0 on rejection, <0 for severe errors
+            Since libburn-1.5.2 the queue is bounded. If it is full, then
+            a message below severity SORRY gets counted as lost and 0 is
+            returned. Messages of severity SORRY or above never get lost.
+            They wait in an unbounded list until they get obtained.
 */
 int libdax_msgs_submit(struct libdax_msgs *m, int origin, int error_code,
                        int severity, int priority, char *msg_text, 
@@ -350,6 +400,9 @@ int libdax_msgs_set_severities(struct libdax_msgs *m, int queue_severity,
     Usually all older messages of lower severity are discarded then. If no
     item of sufficient severity was found, all others are discarded from the
     queue.
+    If the queue was full so that submitted messages got lost, then their
+    number is reported by a message with error code 0x00000005 and the
+    highest severity of the lost messages. This severity is below SORRY.
     @param flag Bitfield for control purposes (unused yet, submit 0)
     @return 1 if a matching item was found, 0 if not, <0 for severe errors
 */
@@ -415,6 +468,7 @@ Range "libdax_msgs"        :  0x00000000 to 0x0000ffff
  0x00000002 (DEBUG,ZERO)   = Debugging message
  0x00000003 (FATAL,HIGH)   = Out of virtual memory
  0x00000004 (FATAL,HIGH)   = Generic fatal error
+ 0x00000005 (,HIGH)        = Messages lost due to full message queue
 
 
 ------------------------------------------------------------------------------
@@ -614,6 +668,25 @@ Range "scdbackup"          :  0x00020000 to 0x0002ffff
  0x000201a9 (FAILURE,HIGH) = Implausible length from GET CONFIGURATION
  0x000201aa (FAILURE,HIGH) = No CD-TEXT packs in file
  0x000201ab (WARN,HIGH)    = Leaving burn_source_fifo object undisposed
+ 0x000201ac (SORRY,HIGH)   = Cannot start binary SCSI trace
+ 0x000201ad (FAILURE,HIGH) = Cannot create pipe for drive events
+ 0x000201ae (FAILURE,HIGH) = Expected audio playlist source object as parameter
+ 0x000201af (WARNING,HIGH) = Premature end of audio playlist file
+ 0x000201b0 (FAILURE,HIGH) = Unsuitable audio playlist file
+ 0x000201b1 (SORRY,HIGH)   = Fifo is already under consumption when prefetching is desired
+ 0x000201b2 (SORRY,HIGH)   = Cannot equip fifo with spill file
+ 0x000201b3 (SORRY,HIGH)   = Cannot read or write fifo spill file
+ 0x000201b4 (NOTE,HIGH)    = Stopped waiting for blanking or formatting
+ 0x000201b5 (NOTE,HIGH)    = Write speed changed by autotuning
+ 0x000201b6 (FATAL,HIGH)   = Cannot start worker thread
+ 0x000201b7 (WARNING,HIGH) = Leaving drive object undisposed because it is
+                             still in use by a worker thread
+ 0x000201b8 (NOTE,HIGH)    = Drive was detached from the system
+ 0x000201b9 (FAILURE,HIGH) = Cannot listen to kernel events about drives
+ 0x000201ba (SORRY,HIGH)   = Drive was detached from the system
+ 0x000201bb (FAILURE,HIGH) = Cannot open audio playlist file
+ 0x000201bc (FAILURE,HIGH) = Cannot get payload size of audio playlist file
+ 0x000201bd (FAILURE,HIGH) = Audio playlist needs 1 to 99 files
 
 
  libdax_audioxtr:
@@ -753,11 +826,14 @@ static int libdax_msgs_unlock(struct libdax_msgs *m, int flag);
 
 /** Create new empty message item.
     @param link Previous item in queue
+    @param text_size If >0: reserve this many bytes for msg_text in the
+                     memory of the item.
     @param flag Bitfield for control purposes (unused yet, submit 0)
     @return >0 success, <=0 failure
 */
 static int libdax_msgs_item_new(struct libdax_msgs_item **item, 
-                                struct libdax_msgs_item *link, int flag);
+                                struct libdax_msgs_item *link, int text_size,
+                                int flag);
 
 /** Destroy a message item obtained by libdax_msgs_obtain(). The submitted
     pointer gets set to NULL.
@@ -767,6 +843,20 @@ static int libdax_msgs_item_new(struct libdax_msgs_item **item,
 static int libdax_msgs_item_destroy(struct libdax_msgs_item **item, int flag);
 
 
+/* ts C61019 */
+/** Put a message into the submission ring without taking the lock.
+    @return 1 success, 0 ring full (message counted as lost), <0 failure
+*/
+static int libdax_msgs_ring_put(struct libdax_msgs *m, int origin,
+                                int error_code, int severity, int priority,
+                                char *msg_text, int os_errno, int flag);
+
+/** Move the messages from the submission ring into the queue and report
+    lost messages. Call only while holding the lock.
+*/
+static int libdax_msgs_ring_drain(struct libdax_msgs *m, int flag);
+
+
 #endif /* LIBDAX_MSGS_H_INTERNAL */
 
 
@@ -103,6 +103,16 @@ extern struct libdax_msgs *libdax_messenger;
  # define Libisofs_simulate_old_mmc1_drivE 1
 */
 
+/* ts C61019 : Allocation length for the first execution of inquiry commands
+               which announce the length of their reply. The replies of
+               GET CONFIGURATION, READ TOC, READ FORMAT CAPACITIES fit into
+               it, so that no second execution with the announced length is
+               needed. Drives which refuse it with GET CONFIGURATION get the
+               classic sequence of a short first inquiry. See
+               d->big_alloc_len.
+*/
+#define Libburn_mmc_big_alloC 8192
+
 
 /* DVD/BD progress report:
    ts A61219 : It seems to work with a used (i.e. thoroughly formatted) DVD+RW.
@@ -1122,6 +1132,19 @@ int mmc_fake_toc_entry(struct burn_toc_entry *entry, int session_number,
 
 
 /* ts A71128 : for DVD-ROM drives which offer no reliable track information */
+/* ts C61019 : The allocation length for the first execution of a command
+   which announces its reply length.
+   @param classic  The length which only tells the reply length
+   @return         classic or Libburn_mmc_big_alloC
+*/
+static int mmc_first_alloc_len(struct burn_drive *d, int classic, int flag)
+{
+	if (d->big_alloc_len > 0)
+		return Libburn_mmc_big_alloC;
+	return classic;
+}
+
+
 static int mmc_read_toc_fmt0_al(struct burn_drive *d, int *alloc_len)
 {
 	struct burn_track *track;
@@ -1274,13 +1297,14 @@ ex:;
 /* ts A71128 : for DVD-ROM drives which offer no reliable track information */
 static int mmc_read_toc_fmt0(struct burn_drive *d)
 {
-	int alloc_len = 4, ret;
+	int alloc_len = 4, ret, first_alloc_len;
 
 	mmc_start_if_needed(d, 1);
 	if (mmc_function_spy(d, "mmc_read_toc_fmt0") <= 0)
 		return -1;
+	alloc_len = first_alloc_len = mmc_first_alloc_len(d, alloc_len, 0);
 	ret = mmc_read_toc_fmt0_al(d, &alloc_len);
-	if (alloc_len >= 12)
+	if (alloc_len >= 12 && alloc_len > first_alloc_len)
 		ret = mmc_read_toc_fmt0_al(d, &alloc_len);
 	return ret;
 }
@@ -1487,6 +1511,66 @@ ex:;
 }
 
 
+/* ts C61019 : Replacement of mmc_fake_toc() at media inquiry time.
+   Inquire only the last track, which tells the free space of appendable
+   media, and leave the TOC to mmc_complete_toc().
+*/
+static int mmc_fake_toc_tail(struct burn_drive *d, int flag)
+{
+	struct buffer *buf = NULL;
+	unsigned char *tdata;
+	int ret, session_number;
+
+	if (mmc_function_spy(d, "mmc_fake_toc_tail") <= 0)
+		{ret = -1; goto ex;}
+	BURN_ALLOC_MEM(buf, struct buffer, 1);
+
+	ret = mmc_read_track_info(d, d->last_track_no, buf, 34);
+	if (ret <= 0) {
+		/* Let the full run do the error handling */
+		ret = mmc_fake_toc(d);
+		goto ex;
+	}
+	tdata = buf->data;
+	session_number = (tdata[33] << 8) | tdata[3];
+	if (session_number > d->complete_sessions) {
+		/* Last track field Free Blocks, as in mmc_fake_toc() */
+		burn_drive_set_media_capacity_remaining(d,
+			((off_t) mmc_four_char_to_int(tdata + 16)) *
+			((off_t) 2048));
+		d->media_lba_limit = 0;
+	}
+	d->toc_pending = 1;
+	ret = 1;
+ex:;
+	BURN_FREE_MEM(buf);
+	return ret;
+}
+
+
+/* ts C61019 : Build the TOC which was deferred by mmc_fake_toc_tail().
+   @param flag bit0= the caller is the thread which operates the drive.
+                     Else only an idle drive gets inquired.
+   @return 1 = TOC is complete , 0 = drive not available , <0 = error
+*/
+int mmc_complete_toc(struct burn_drive *d, int flag)
+{
+	int ret;
+
+	if (!d->toc_pending)
+		return 1;
+	if (d->drive_role != 1 || d->released)
+		return 0;
+	if (!(flag & 1) && d->busy != BURN_DRIVE_IDLE)
+		return 0;
+	d->toc_pending = 0;
+	ret = mmc_fake_toc(d);
+	if (ret <= 0)
+		return ret;
+	return 1;
+}
+
+
 static int mmc_register_leadout(struct burn_drive *d, int *highest_leadout,
                              int toc_idx)
 {
@@ -1534,7 +1618,15 @@ static int mmc_read_toc_al(struct burn_drive *d, int *alloc_len)
 		   and the track records from 52h READ TRACK INFORMATION.
 		   mmc_read_toc_fmt0() is used as fallback for dull DVD-ROM.
 		*/
-		mmc_fake_toc(d);
+		/* ts C61019 :
+		   Media with many tracks would need many commands. Only
+		   the last track is inquired now. The TOC gets built when
+		   burn_drive_get_disc() is called.
+		*/
+		if (d->last_track_no > 1 && d->status != BURN_DISC_BLANK)
+			mmc_fake_toc_tail(d, 0);
+		else
+			mmc_fake_toc(d);
 
 		if (d->status == BURN_DISC_UNREADY)
 			d->status = BURN_DISC_FULL;
@@ -1748,25 +1840,70 @@ ex:;
 
 void mmc_read_toc(struct burn_drive *d)
 {
-	int alloc_len = 4, ret;
+	int alloc_len = 4, ret, first_alloc_len;
 
 	mmc_start_if_needed(d, 1);
 	if (mmc_function_spy(d, "mmc_read_toc") <= 0)
 		return;
 
+	alloc_len = first_alloc_len = mmc_first_alloc_len(d, alloc_len, 0);
 	ret = mmc_read_toc_al(d, &alloc_len);
 /*
 	fprintf(stderr,
 		"LIBBURN_DEBUG: 43h READ TOC alloc_len = %d , ret = %d\n",
 		alloc_len, ret);
 */
-	if (alloc_len >= 15)
+	if (alloc_len >= 15 && alloc_len > first_alloc_len)
 		ret = mmc_read_toc_al(d, &alloc_len);
 	if (ret <= 0)
 		return;
 }
 
 
+/* ts C61019 : Get the result of the TOC evaluation in
+   mmc_read_multi_session_c1() from track info while the TOC is not built.
+   It walks backwards from the last track through the last session which
+   would be recorded in the TOC.
+   @return 1 = found , 0 = no such track , <0 = error
+*/
+static int mmc_msc1_from_track_info(struct burn_drive *d, int *trackno,
+                                    int *start, int flag)
+{
+	struct buffer *buf = NULL;
+	unsigned char *tdata;
+	int ret, i, session_number, last_session = -1, max_session;
+
+	if (d->last_track_no > BURN_MMC_FAKE_TOC_MAX_SIZE)
+		{ret = -1; goto ex;}
+	BURN_ALLOC_MEM(buf, struct buffer, 1);
+
+#ifdef Libburn_disc_with_incomplete_sessioN
+	max_session = d->complete_sessions + d->incomplete_sessions;
+#else
+	max_session = d->complete_sessions;
+#endif
+
+	for (i = d->last_track_no; i > 0; i--) {
+		ret = mmc_read_track_info(d, i, buf, 34);
+		if (ret <= 0)
+			{ret = -1; goto ex;}
+		tdata = buf->data;
+		session_number = (tdata[33] << 8) | tdata[3];
+		if (session_number <= 0 || session_number > max_session)
+	continue;
+		if (last_session > 0 && session_number != last_session)
+	break;
+		last_session = session_number;
+		*trackno = i;
+		*start = mmc_four_char_to_int(tdata + 8);
+	}
+	ret = (last_session > 0);
+ex:;
+	BURN_FREE_MEM(buf);
+	return ret;
+}
+
+
 /* ts A70131 : This tries to get the start of the last complete session */
 /* man mkisofs , option -C :
    The first number is the sector number of the first sector in
@@ -1794,6 +1931,18 @@ int mmc_read_multi_session_c1(struct burn_drive *d, int *trackno, int *start)
 	   complete session which has a track.
 	*/
 	*trackno = 0;
+
+	/* ts C61019 : Avoid to build the TOC only for this purpose */
+	if (d->toc_pending) {
+		ret = mmc_msc1_from_track_info(d, trackno, start, 0);
+		if (ret > 0)
+			goto ex;
+		*trackno = 0;
+		if (ret == 0)
+			goto inquire_drive;
+	}
+	mmc_complete_toc(d, 1);
+
 	disc = burn_drive_get_disc(d);
 	if (disc == NULL)
 		goto inquire_drive;
@@ -1949,6 +2098,7 @@ static int mmc_read_disc_info_al(struct burn_drive *d, int *alloc_len)
 
 	/* ts A61202 */
 	d->toc_entries = 0;
+	d->toc_pending = 0; /* ts C61019 */
 	if (d->status == BURN_DISC_EMPTY)
 		{ret = 1; goto ex;}
 
@@ -2827,6 +2977,8 @@ int mmc_set_streaming(struct burn_drive *d,
 	else if (r_speed < 0)
 		r_speed = 177; /* 1x CD */
 	if (end_lba == 0) {
+		mmc_get_pending_performance(d, 1); /* ts C61019 */
+
 		/* Default computed from 4.7e9 */
 		eff_end_lba = 2294921 - 1;
 		if (d->mdata->max_end_lba > 0)
@@ -3331,6 +3483,21 @@ void mmc_get_configuration(struct burn_drive *d)
 	if (mmc_function_spy(d, "mmc_get_configuration") <= 0)
 		return;
 
+	/* ts C61019 : Try to get the whole reply by a single execution */
+	if (d->big_alloc_len >= 0) {
+		alloc_len = Libburn_mmc_big_alloC;
+		ret = mmc_get_configuration_al(d, &alloc_len);
+		if (ret > 0) {
+			d->big_alloc_len = 1;
+			return;
+		}
+		if (d->big_alloc_len > 0)
+			return;
+		/* Maybe the drive dislikes the allocation length */
+		d->big_alloc_len = -1;
+		alloc_len = 8;
+	}
+
 	/* first command execution to learn Allocation Length */
 	ret = mmc_get_configuration_al(d, &alloc_len);
 /*
@@ -3498,18 +3665,19 @@ ex:
 
 int mmc_read_format_capacities(struct burn_drive *d, int top_wanted)
 {
-	int alloc_len = 4, ret;
+	int alloc_len = 4, ret, first_alloc_len;
 
 	mmc_start_if_needed(d, 1);
 	if (mmc_function_spy(d, "mmc_read_format_capacities") <= 0)
 		return 0;
 
+	alloc_len = first_alloc_len = mmc_first_alloc_len(d, alloc_len, 0);
 	ret = mmc_read_format_capacities_al(d, &alloc_len, top_wanted);
 /*
 	fprintf(stderr,"LIBBURN_DEBUG: 23h alloc_len = %d , ret = %d\n",
 		 alloc_len, ret);
 */
-	if (alloc_len >= 12 && ret > 0)
+	if (alloc_len >= 12 && alloc_len > first_alloc_len && ret > 0)
 		ret = mmc_read_format_capacities_al(d, &alloc_len, top_wanted);
 
 	return ret;
@@ -4337,6 +4505,7 @@ static int new_burn_speed_descr(struct burn_drive *d, int sd_source,
 /* ts B40107 : Outsourced from mmc_get_performance_al()
                and extended for descr_type 0x00
    @param flag bit0= register speed descriptors
+               bit1= register only if the reply was not truncated
 */
 static int interpret_performance(struct burn_drive *d, struct command *c,
                                 int descr_type, int *alloc_len, int *max_descr, 
@@ -4363,6 +4532,10 @@ static int interpret_performance(struct burn_drive *d, struct command *c,
 		*max_descr = *num_descr;
 		{ret = 1; goto ex;}
 	}
+	if ((flag & 2) && *alloc_len > old_alloc_len) {
+		*num_descr = 0;
+		{ret = 1; goto ex;}
+	}
 	if (old_alloc_len < 16)
 		{ret = 1; goto ex;}
 	if (len < 12)
@@ -4472,6 +4645,7 @@ ex:;
 
 /* ts A61225 */
 /* @param flag bit0= register speed descriptors
+               bit1= register only if the reply was not truncated
 */
 static int mmc_get_performance_al(struct burn_drive *d, int descr_type,
 		 int *alloc_len, int *max_descr, int flag)
@@ -4544,6 +4718,21 @@ int mmc_get_performance(struct burn_drive *d, int descr_type, int flag)
 	if (mmc_function_spy(d, "mmc_get_write_performance") <= 0)
 		return 0;
 
+	/* ts C61019 : Try to get all descriptors by a single execution */
+	if (d->big_alloc_len > 0) {
+		alloc_len = Libburn_mmc_big_alloC;
+		max_descr = (alloc_len - 8) / 16;
+		ret = mmc_get_performance_al(d, descr_type,
+		                             &alloc_len, &max_descr, 1 | 2);
+		if (alloc_len <= Libburn_mmc_big_alloC)
+			return ret;
+		/* Too many descriptors. Nothing was registered. */
+		max_descr = (alloc_len - 8) / 16;
+		ret = mmc_get_performance_al(d, descr_type,
+		                             &alloc_len, &max_descr, 1);
+		return ret;
+	}
+
 	/* first command execution to learn number of descriptors and 
            dxfer_len
 	*/
@@ -4578,6 +4767,30 @@ int mmc_get_write_performance(struct burn_drive *d)
 }
 
 
+/* ts C61019 : Inquire the performance types which were deferred by
+               spc_try_get_performance().
+   @param flag bit0= the caller is the thread which operates the drive.
+                     Else only an idle drive gets inquired.
+   @return 1 = inquired , 0 = nothing to do or drive not available
+*/
+int mmc_get_pending_performance(struct burn_drive *d, int flag)
+{
+	int pending;
+
+	pending = d->mdata->perf_pending;
+	if (pending == 0 || d->drive_role != 1 || d->released)
+		return 0;
+	if (!(flag & 1) && d->busy != BURN_DRIVE_IDLE)
+		return 0;
+	d->mdata->perf_pending = 0;
+	if (pending & 1)
+		mmc_get_write_performance(d);
+	if (pending & 2)
+		mmc_get_performance(d, 0x00, 0);
+	return 1;
+}
+
+
 /* ts A61229 : outsourced from spc_select_write_params() */
 /* Note: Page data is not zeroed here in order not to overwrite preset
          defaults. Thus
@@ -5430,6 +5643,7 @@ int mmc_setup_drive(struct burn_drive *d)
 	d->pbf_altered = 0;
 	d->wait_for_buffer_free = Libburn_wait_for_buffer_freE;
 	d->nominal_write_speed = 0;
+	d->user_write_speed = 0;
 	d->pessimistic_writes = 0;
 	d->waited_writes = 0;
 	d->waited_tries = 0;
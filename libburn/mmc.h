@@ -130,6 +130,12 @@ int mmc_get_leadin_text(struct burn_drive *d,
 /* ts B40107 */
 int mmc_get_performance(struct burn_drive *d, int descr_type, int flag);
 
+/* ts C61019 */
+int mmc_get_pending_performance(struct burn_drive *d, int flag);
+
+/* ts C61019 */
+int mmc_complete_toc(struct burn_drive *d, int flag);
+
 
 #ifdef Libburn_develop_quality_scaN
 /* B21108 ts */
@@ -64,6 +64,10 @@ struct burn_write_opts *burn_write_opts_new(struct burn_drive *drive)
 	opts->text_packs = NULL;
 	opts->num_text_packs = 0;
 	opts->no_text_pack_crc_check = 0;
+	opts->iso_head = NULL;
+	opts->autotune = 0;
+	opts->autotune_min_speed = 0;
+	opts->autotune_interval = 0.0;
 	opts->has_mediacatalog = 0;
 	opts->format = BURN_CDROM;
 	opts->multi = 0;
@@ -77,6 +81,8 @@ void burn_write_opts_free(struct burn_write_opts *opts)
 		return;
 	if (opts->text_packs != NULL)
 		free(opts->text_packs);
+	if (opts->iso_head != NULL)
+		free(opts->iso_head);
 	free(opts);
 }
 
@@ -98,6 +104,7 @@ out_of_mem:;
 	memcpy(*to, from, sizeof(struct burn_write_opts));
 	(*to)->text_packs = NULL;
 	(*to)->num_text_packs = 0;
+	(*to)->iso_head = NULL;
 	if (from->text_packs != NULL && from->num_text_packs > 0) {
 		(*to)->text_packs = calloc(1, from->num_text_packs * 18);
 		if ((*to)->text_packs == NULL)
@@ -105,6 +112,12 @@ out_of_mem:;
 		memcpy((*to)->text_packs, from->text_packs,
 		       from->num_text_packs * 18);
 	}
+	if (from->iso_head != NULL) {
+		(*to)->iso_head = calloc(1, 16 * 2048);
+		if ((*to)->iso_head == NULL)
+			goto out_of_mem;
+		memcpy((*to)->iso_head, from->iso_head, 16 * 2048);
+	}
 	(*to)->refcount= 1;
 	return 1;
 }
@@ -298,6 +311,43 @@ ex:;
 }
 
 
+/* ts C61019 API */
+int burn_write_opts_set_iso_head(struct burn_write_opts *opts, char *head,
+                                 int flag)
+{
+	int ret;
+	char *head_buffer = NULL;
+
+	if (head != NULL)
+		BURN_ALLOC_MEM(head_buffer, char, 16 * 2048);
+	if (opts->iso_head != NULL) {
+		free(opts->iso_head);
+		opts->iso_head = NULL;
+	}
+	if (head != NULL) {
+		memcpy(head_buffer, head, 16 * 2048);
+		opts->iso_head = head_buffer;
+		head_buffer = NULL;
+	}
+	ret = 1;
+ex:;
+	BURN_FREE_MEM(head_buffer);
+	return ret;
+}
+
+
+/* ts C61019 API */
+int burn_write_opts_set_speed_autotune(struct burn_write_opts *opts,
+                                       int min_speed, double interval,
+                                       int flag)
+{
+	opts->autotune = flag & 1;
+	opts->autotune_min_speed = min_speed > 0 ? min_speed : 0;
+	opts->autotune_interval = interval;
+	return 1;
+}
+
+
 /* ts A61222 */
 void burn_write_opts_set_start_byte(struct burn_write_opts *opts, off_t value)
 {
@@ -94,6 +94,21 @@ struct burn_write_opts
 	   feature 21h Incremental Streaming Writable
 	*/
 	int feat21h_fail_sev;
+
+	/* ts C61019 */
+	/* New content for the blocks 16 to 31 of the medium, or NULL.
+	   See burn_write_opts_set_iso_head().
+	*/
+	char *iso_head;
+
+	/* ts C61019 */
+	/* Whether to adapt the write speed of DVD and BD to the pace which
+	   the track source and the drive buffer sustain.
+	   See burn_write_opts_set_speed_autotune().
+	*/
+	int autotune;
+	int autotune_min_speed;   /* kB/s, 0 = lowest speed of the drive */
+	double autotune_interval; /* seconds between decisions */
 };
 
 /* Default value for burn_write_opts.stdio_flush_size
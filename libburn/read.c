@@ -78,6 +78,7 @@ void burn_disc_read(struct burn_drive *d, const struct burn_read_opts *o)
 drive, or only store a subset of the _opts structs in drives */
 
 	/* set the speed on the drive */
+	mmc_get_pending_performance(d, 0); /* ts C61019 */
 	speed = o->speed > 0 ? o->speed : d->mdata->max_read_speed;
 	d->set_speed(d, speed, 0);
 
@@ -633,6 +634,49 @@ bad_read:;
 }
 
 
+/* ts C61019 API */
+int burn_disc_read_iso_head(struct burn_drive *d, char *head,
+                            off_t *image_blocks, int flag)
+{
+	int ret;
+	off_t data_count = 0;
+	unsigned char *pvd;
+
+	*image_blocks = 0;
+	if (d->iso_head_cache == NULL) {
+		BURN_ALLOC_MEM(d->iso_head_cache, char, Libburn_iso_head_sizE);
+		d->iso_head_valid = 0;
+	}
+	if (flag & 1)
+		d->iso_head_valid = 0;
+	if (!d->iso_head_valid) {
+		ret = burn_read_data(d, (off_t) 0, d->iso_head_cache,
+		                     (off_t) Libburn_iso_head_sizE, &data_count,
+		                     0);
+		if (ret <= 0)
+			{ret = 0; goto ex;}
+		d->iso_head_valid = 1;
+	} else {
+		libdax_msgs_submit(libdax_messenger, d->global_index,
+			0x00000002,
+			LIBDAX_MSGS_SEV_DEBUG, LIBDAX_MSGS_PRIO_ZERO,
+			"ISO 9660 head taken from cache", 0, 0);
+	}
+	if (head != NULL)
+		memcpy(head, d->iso_head_cache, Libburn_iso_head_sizE);
+
+	/* Primary Volume Descriptor at block 16 */
+	pvd = (unsigned char *) d->iso_head_cache + 16 * 2048;
+	if (pvd[0] != 1 || strncmp((char *) pvd + 1, "CD001", 5) != 0)
+		{ret = 2; goto ex;}
+	*image_blocks = ((off_t) pvd[80]) | (((off_t) pvd[81]) << 8) |
+	                (((off_t) pvd[82]) << 16) | (((off_t) pvd[83]) << 24);
+	ret = 1;
+ex:;
+	return ret;
+}
+
+
 /* ts B21119 : API function*/
 int burn_read_audio(struct burn_drive *d, int sector_no,
                     char data[], off_t data_size, off_t *data_count, int flag)
@@ -0,0 +1,786 @@
+/* -*- indent-tabs-mode: t; tab-width: 8; c-basic-offset: 8; -*- */
+
+/* Copyright (c) 2026 Thomas Schmitt <scdbackup@gmx.net>
+   Provided under GPL version 2 or later.
+*/
+
+/* ts C61019 : Binary SCSI command trace with background writer thread,
+               text decoder, and replay against an emulated drive buffer.
+*/
+
+#ifdef HAVE_CONFIG_H
+#include "../config.h"
+#endif
+
+#include <unistd.h>
+#include <stdio.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <pthread.h>
+
+#include "libburn.h"
+#include "transport.h"
+#include "spc.h"
+#include "mmc.h"
+#include "crc.h"
+#include "init.h"
+#include "util.h"
+#include "scsitrace.h"
+
+#include "libdax_msgs.h"
+extern struct libdax_msgs *libdax_messenger;
+
+extern int burn_sg_log_scsi;
+
+
+/* The producer fills the ring and then advances writepos. The writer thread
+   reads up to writepos and then advances readpos. Each index is changed by
+   only one thread. The barrier makes sure that the other thread sees the
+   bytes before it sees the index.
+*/
+#ifdef __GNUC__
+#define Libburn_scsi_trace_barrieR __sync_synchronize()
+#else
+#define Libburn_scsi_trace_barrieR
+#endif
+
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
+
+struct burn_scsi_trace_ring {
+	unsigned char *buf;
+	int size;
+	volatile int writepos;
+	volatile int readpos;
+
+	/* Only to be used by the producer */
+	unsigned int seq;
+	int dropped;
+};
+
+
+/* Index 255 is shared by all drives with global_index -1 or >= 255.
+   Its producers may run in several threads and take trace_shared_lock.
+*/
+static struct burn_scsi_trace_ring *volatile trace_rings[256];
+static pthread_mutex_t trace_shared_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static volatile int trace_running = 0;
+static volatile int trace_stop = 0;
+static int trace_fd = -1;
+static pthread_t trace_thread;
+
+
+static void scsi_trace_lsb(unsigned char *target, unsigned int val, int bytes)
+{
+	int i;
+
+	for (i = 0; i < bytes; i++)
+		target[i] = (val >> (8 * i)) & 0xff;
+}
+
+
+static unsigned int scsi_trace_from_lsb(unsigned char *data, int bytes)
+{
+	int i;
+	unsigned int val = 0;
+
+	for (i = bytes - 1; i >= 0; i--)
+		val = (val << 8) | data[i];
+	return val;
+}
+
+
+static void scsi_trace_time_to_lsb(unsigned char *target, double t)
+{
+	double us;
+	unsigned int hi;
+
+	us = (t - lib_start_time) * 1.0e6;
+	if (us < 0.0)
+		us = 0.0;
+	hi = us / 4294967296.0;
+	scsi_trace_lsb(target, (unsigned int) (us - hi * 4294967296.0), 4);
+	scsi_trace_lsb(target + 4, hi, 4);
+}
+
+
+static double scsi_trace_time_from_lsb(unsigned char *data)
+{
+	return (scsi_trace_from_lsb(data + 4, 4) * 4294967296.0 +
+	        scsi_trace_from_lsb(data, 4)) / 1.0e6;
+}
+
+
+/* Commands which transport large amounts of payload */
+static int scsi_trace_is_bulk(unsigned char opcode)
+{
+	return (opcode == 0x2A || opcode == 0xAA || opcode == 0x28 ||
+	        opcode == 0x3C || opcode == 0xA8 || opcode == 0xB9 ||
+	        opcode == 0xBE);
+}
+
+
+static struct burn_scsi_trace_ring *scsi_trace_get_ring(int idx, int flag)
+{
+	struct burn_scsi_trace_ring *ring;
+
+	if (trace_rings[idx] != NULL)
+		return trace_rings[idx];
+	ring = calloc(1, sizeof(struct burn_scsi_trace_ring));
+	if (ring == NULL)
+		return NULL;
+	ring->buf = calloc(1, Libburn_scsi_trace_ring_sizE);
+	if (ring->buf == NULL) {
+		free(ring);
+		return NULL;
+	}
+	ring->size = Libburn_scsi_trace_ring_sizE;
+	ring->writepos = ring->readpos = 0;
+	ring->seq = 0;
+	ring->dropped = 0;
+	Libburn_scsi_trace_barrieR;
+	trace_rings[idx] = ring;
+	return ring;
+}
+
+
+static int scsi_trace_free_space(struct burn_scsi_trace_ring *ring)
+{
+	int used;
+
+	used = ring->writepos - ring->readpos;
+	if (used < 0)
+		used += ring->size;
+	return ring->size - used - 1;
+}
+
+
+/* Copy bytes into the ring at a given position. Does not advance writepos.
+   @return the position after the bytes
+*/
+static int scsi_trace_put(struct burn_scsi_trace_ring *ring, int pos,
+                          unsigned char *data, int bytes)
+{
+	int part;
+
+	part = ring->size - pos;
+	if (part > bytes)
+		part = bytes;
+	if (data == NULL)
+		memset(ring->buf + pos, 0, part);
+	else
+		memcpy(ring->buf + pos, data, part);
+	if (part < bytes) {
+		if (data == NULL)
+			memset(ring->buf, 0, bytes - part);
+		else
+			memcpy(ring->buf, data + part, bytes - part);
+	}
+	pos += bytes;
+	if (pos >= ring->size)
+		pos -= ring->size;
+	return pos;
+}
+
+
+static int scsi_trace_commit(struct burn_scsi_trace_ring *ring, int pos)
+{
+	Libburn_scsi_trace_barrieR;
+	ring->writepos = pos;
+	return 1;
+}
+
+
+static int scsi_trace_put_dropped(struct burn_scsi_trace_ring *ring, int idx,
+                                  int flag)
+{
+	unsigned char head[Libburn_scsi_trace_record_heaD];
+	int pos;
+
+	if (scsi_trace_free_space(ring) < Libburn_scsi_trace_record_heaD)
+		return 0;
+	memset(head, 0, sizeof(head));
+	scsi_trace_lsb(head, Libburn_scsi_trace_record_heaD, 4);
+	scsi_trace_lsb(head + 4, ring->seq++, 4);
+	scsi_trace_lsb(head + 8, idx == 255 ? 0xffff : idx, 2);
+	head[10] = NO_TRANSFER;
+	scsi_trace_time_to_lsb(head + 28, burn_get_time(0));
+	memcpy(head + 36, head + 28, 8);
+	scsi_trace_lsb(head + 44, ring->dropped, 4);
+	head[59] = 'D';
+	pos = scsi_trace_put(ring, ring->writepos, head,
+	                     Libburn_scsi_trace_record_heaD);
+	scsi_trace_commit(ring, pos);
+	ring->dropped = 0;
+	return 1;
+}
+
+
+static int scsi_trace_record_ring(int idx, struct command *c,
+                                  unsigned char *sense, int sense_len,
+                                  int loop_count, int flag)
+{
+	struct burn_scsi_trace_ring *ring;
+	unsigned char head[Libburn_scsi_trace_record_heaD], *data = NULL;
+	int bytes = 0, rec_bytes, size, pos, flags = 0;
+	unsigned int digest = 0;
+	double start_time, end_time;
+
+	ring = scsi_trace_get_ring(idx, 0);
+	if (ring == NULL)
+		return -1;
+
+	if (c->page != NULL) {
+		data = c->page->data;
+		if (c->dir == TO_DRIVE)
+			bytes = c->page->bytes;
+		else if (c->dir == FROM_DRIVE)
+			bytes = c->dxfer_len;
+	}
+	if (bytes < 0 || data == NULL)
+		bytes = 0;
+	rec_bytes = bytes;
+	if (scsi_trace_is_bulk(c->opcode[0])) {
+		if (rec_bytes > Libburn_scsi_trace_prefiX)
+			rec_bytes = Libburn_scsi_trace_prefiX;
+	} else if (rec_bytes > Libburn_scsi_trace_payload_maX) {
+		rec_bytes = Libburn_scsi_trace_payload_maX;
+	}
+	if (rec_bytes < bytes)
+		flags |= 1;
+
+#ifndef Libburn_no_crc_C
+	if (bytes > 0)
+		digest = crc_32(data, bytes);
+#else
+	flags |= 2;
+#endif
+
+	if (flag & 2)
+		flags |= 4;
+	if (sense_len < 0 || sense == NULL)
+		sense_len = 0;
+	if (sense_len > 128)
+		sense_len = 128;
+	size = (Libburn_scsi_trace_record_heaD + sense_len + rec_bytes + 3) &
+	       ~3;
+
+	if (ring->dropped > 0)
+		if (scsi_trace_put_dropped(ring, idx, 0) <= 0)
+			{ring->dropped++; return 0;}
+	if (scsi_trace_free_space(ring) < size)
+		{ring->dropped++; return 0;}
+
+	start_time = c->start_time;
+	end_time = c->end_time;
+	if (end_time < start_time || start_time <= 0.0)
+		start_time = end_time = burn_get_time(0);
+
+	memset(head, 0, sizeof(head));
+	scsi_trace_lsb(head, size, 4);
+	scsi_trace_lsb(head + 4, ring->seq++, 4);
+	scsi_trace_lsb(head + 8, idx == 255 ? 0xffff : idx, 2);
+	head[10] = c->dir;
+	head[11] = c->oplen > 16 ? 16 : c->oplen;
+	memcpy(head + 12, c->opcode, 16);
+	scsi_trace_time_to_lsb(head + 28, start_time);
+	scsi_trace_time_to_lsb(head + 36, end_time);
+	scsi_trace_lsb(head + 44, bytes, 4);
+	scsi_trace_lsb(head + 48, digest, 4);
+	scsi_trace_lsb(head + 52, rec_bytes, 4);
+	head[56] = sense_len;
+	head[57] = loop_count > 255 ? 255 : loop_count;
+	head[58] = flags;
+	head[59] = 'C';
+
+	pos = scsi_trace_put(ring, ring->writepos, head,
+	                     Libburn_scsi_trace_record_heaD);
+	if (sense_len > 0)
+		pos = scsi_trace_put(ring, pos, sense, sense_len);
+	if (rec_bytes > 0)
+		pos = scsi_trace_put(ring, pos, data, rec_bytes);
+	size -= Libburn_scsi_trace_record_heaD + sense_len + rec_bytes;
+	if (size > 0)
+		pos = scsi_trace_put(ring, pos, NULL, size);
+	scsi_trace_commit(ring, pos);
+	return 1;
+}
+
+
+int burn_scsi_trace_record(struct burn_drive *d, struct command *c,
+                           unsigned char *sense, int sense_len,
+                           int loop_count, int flag)
+{
+	int idx, ret;
+
+	if (!trace_running)
+		return 0;
+	idx = d->global_index;
+	if (idx >= 0 && idx < 255)
+		return scsi_trace_record_ring(idx, c, sense, sense_len,
+		                              loop_count, flag);
+	pthread_mutex_lock(&trace_shared_lock);
+	ret = scsi_trace_record_ring(255, c, sense, sense_len, loop_count,
+	                             flag);
+	pthread_mutex_unlock(&trace_shared_lock);
+	return ret;
+}
+
+
+static int scsi_trace_write_all(int fd, unsigned char *data, int bytes)
+{
+	int ret, done = 0;
+
+	while (done < bytes) {
+		ret = write(fd, data + done, bytes - done);
+		if (ret <= 0)
+			return 0;
+		done += ret;
+	}
+	return 1;
+}
+
+
+/* @return number of bytes moved to the file
+*/
+static int scsi_trace_drain(int flag)
+{
+	struct burn_scsi_trace_ring *ring;
+	int i, w, r, moved = 0;
+
+	for (i = 0; i < 256; i++) {
+		ring = trace_rings[i];
+		if (ring == NULL)
+			continue;
+		w = ring->writepos;
+		Libburn_scsi_trace_barrieR;
+		r = ring->readpos;
+		if (w == r)
+			continue;
+		if (w > r) {
+			scsi_trace_write_all(trace_fd, ring->buf + r, w - r);
+			moved += w - r;
+		} else {
+			scsi_trace_write_all(trace_fd, ring->buf + r,
+			                     ring->size - r);
+			scsi_trace_write_all(trace_fd, ring->buf, w);
+			moved += ring->size - r + w;
+		}
+		Libburn_scsi_trace_barrieR;
+		ring->readpos = w;
+	}
+	return moved;
+}
+
+
+static void *scsi_trace_writer(void *arg)
+{
+	int stop, moved;
+
+	while (1) {
+		stop = trace_stop;
+		moved = scsi_trace_drain(0);
+		if (stop)
+	break;
+		if (moved == 0)
+			usleep(Libburn_scsi_trace_idle_usleeP);
+	}
+	return NULL;
+}
+
+
+/* burn_set_scsi_logging() may be called before burn_initialize() */
+static int scsi_trace_complain(char *msg, int os_errno, int flag)
+{
+	if (libdax_messenger == NULL) {
+		fprintf(stderr, "libburn : SORRY : %s\n", msg);
+		return 1;
+	}
+	libdax_msgs_submit(libdax_messenger, -1, 0x000201ac,
+		LIBDAX_MSGS_SEV_SORRY, LIBDAX_MSGS_PRIO_HIGH,
+		msg, os_errno, 0);
+	return 1;
+}
+
+
+static int scsi_trace_start(int flag)
+{
+	unsigned char head[Libburn_scsi_trace_header_sizE];
+	int ret;
+
+	if (trace_running)
+		return 2;
+	trace_fd = open(Libburn_scsi_trace_filE,
+	                O_WRONLY | O_CREAT | O_TRUNC | O_BINARY,
+	                S_IRUSR | S_IWUSR);
+	if (trace_fd == -1) {
+		scsi_trace_complain("Cannot open file for binary SCSI trace",
+		                    errno, 0);
+		return 0;
+	}
+	memset(head, 0, sizeof(head));
+	strcpy((char *) head, "libburn SCSI trace");
+	scsi_trace_lsb(head + 20, Libburn_scsi_trace_versioN, 4);
+	scsi_trace_write_all(trace_fd, head, Libburn_scsi_trace_header_sizE);
+
+	trace_stop = 0;
+	ret = pthread_create(&trace_thread, NULL, scsi_trace_writer, NULL);
+	if (ret != 0) {
+		scsi_trace_complain("Cannot start thread for binary SCSI trace",
+		                    ret, 0);
+		close(trace_fd);
+		trace_fd = -1;
+		return 0;
+	}
+	trace_running = 1;
+	return 1;
+}
+
+
+static int scsi_trace_stop(int flag)
+{
+	if (!trace_running)
+		return 2;
+	trace_running = 0;
+	trace_stop = 1;
+	pthread_join(trace_thread, NULL);
+	close(trace_fd);
+	trace_fd = -1;
+	return 1;
+}
+
+
+/* @param flag bit0= library shutdown: stop and free the rings
+*/
+int burn_scsi_trace_control(int flag)
+{
+	int i;
+	struct burn_scsi_trace_ring *ring;
+
+	if ((burn_sg_log_scsi & 8) && !(flag & 1))
+		return scsi_trace_start(0);
+	scsi_trace_stop(0);
+	if (flag & 1) {
+		for (i = 0; i < 256; i++) {
+			ring = trace_rings[i];
+			if (ring == NULL)
+				continue;
+			trace_rings[i] = NULL;
+			free(ring->buf);
+			free(ring);
+		}
+	}
+	return 1;
+}
+
+
+/* ------------------------ Offline evaluation ------------------------- */
+
+
+int burn_scsi_trace_read(FILE *fp, struct burn_scsi_trace_rec *rec,
+                         int flag)
+{
+	unsigned char head[Libburn_scsi_trace_record_heaD], *rest = NULL;
+	int ret, size;
+
+	ret = fread(head, Libburn_scsi_trace_record_heaD, 1, fp);
+	if (ret != 1)
+		return 0;
+	size = scsi_trace_from_lsb(head, 4);
+	if (size < Libburn_scsi_trace_record_heaD || size > 16 * 1024 * 1024)
+		return -1;
+	rec->seq = scsi_trace_from_lsb(head + 4, 4);
+	rec->drive_index = scsi_trace_from_lsb(head + 8, 2);
+	if (rec->drive_index == 0xffff)
+		rec->drive_index = -1;
+	rec->dir = head[10];
+	rec->oplen = head[11];
+	memcpy(rec->opcode, head + 12, 16);
+	rec->start_time = scsi_trace_time_from_lsb(head + 28);
+	rec->end_time = scsi_trace_time_from_lsb(head + 36);
+	rec->bytes = scsi_trace_from_lsb(head + 44, 4);
+	rec->digest = scsi_trace_from_lsb(head + 48, 4);
+	rec->data_len = scsi_trace_from_lsb(head + 52, 4);
+	rec->sense_len = head[56];
+	rec->loop_count = head[57];
+	rec->flags = head[58];
+	rec->type = head[59];
+	if (rec->sense_len > 128 ||
+	    Libburn_scsi_trace_record_heaD + rec->sense_len + rec->data_len >
+								size)
+		return -1;
+
+	size -= Libburn_scsi_trace_record_heaD;
+	if (size > 0) {
+		rest = calloc(1, size);
+		if (rest == NULL)
+			return -1;
+		ret = fread(rest, size, 1, fp);
+		if (ret != 1) {
+			free(rest);
+			return -1;
+		}
+	}
+	if (rec->sense_len > 0)
+		memcpy(rec->sense, rest, rec->sense_len);
+	if (rec->data != NULL)
+		free(rec->data);
+	rec->data = NULL;
+	if (rec->data_len > 0) {
+		rec->data = calloc(1, rec->data_len);
+		if (rec->data == NULL) {
+			free(rest);
+			return -1;
+		}
+		memcpy(rec->data, rest + rec->sense_len, rec->data_len);
+	}
+	if (rest != NULL)
+		free(rest);
+	return 1;
+}
+
+
+static int scsi_trace_read_header(FILE *in, int flag)
+{
+	unsigned char head[Libburn_scsi_trace_header_sizE];
+
+	if (fread(head, Libburn_scsi_trace_header_sizE, 1, in) != 1)
+		return 0;
+	if (strcmp((char *) head, "libburn SCSI trace") != 0)
+		return 0;
+	if (scsi_trace_from_lsb(head + 20, 4) != Libburn_scsi_trace_versioN)
+		return 0;
+	return 1;
+}
+
+
+int burn_scsi_trace_decode(FILE *in, FILE *out, int flag)
+{
+	struct burn_scsi_trace_rec rec;
+	int ret, key, asc, ascq, i, l;
+
+	memset(&rec, 0, sizeof(rec));
+	if (scsi_trace_read_header(in, 0) <= 0)
+		return -1;
+	while (1) {
+		ret = burn_scsi_trace_read(in, &rec, 0);
+		if (ret <= 0)
+	break;
+		if (rec.type == 'D') {
+			fprintf(out, "\n--- %d trace records dropped (drive %d)\n",
+			        rec.bytes, rec.drive_index);
+	continue;
+		}
+		if (rec.type != 'C')
+	continue;
+		if (rec.loop_count > 0)
+			fprintf(out, "\n+++ Repeating command (drive %d, try %d)",
+			        rec.drive_index, rec.loop_count + 1);
+		scsi_show_command(rec.opcode, rec.oplen, rec.dir,
+		                  rec.data, rec.data_len, out, 0);
+		if ((rec.flags & 1) && rec.dir == TO_DRIVE &&
+		    !scsi_trace_is_bulk(rec.opcode[0]))
+			fprintf(out, "... truncated from %db\n", rec.bytes);
+		if (rec.sense_len > 0) {
+			l = 18;
+			if ((rec.sense[0] & 0x7f) == 0x72 ||
+			    (rec.sense[0] & 0x7f) == 0x73)
+				l = rec.sense[7] + 7 + 1; /* SPC-3 4.5.2. */
+			if (l > rec.sense_len)
+				l = rec.sense_len;
+			fprintf(out, "+++ sense data =");
+			for (i = 0 ; i < l; i++)
+				fprintf(out, " %2.2X", rec.sense[i]);
+			fprintf(out, "\n");
+			spc_decode_sense(rec.sense, 0, &key, &asc, &ascq);
+			fprintf(out, "+++ key=%X  asc=%2.2Xh  ascq=%2.2Xh\n",
+				(unsigned int) key, (unsigned int) asc,
+				(unsigned int) ascq);
+		} else {
+			scsi_show_command_reply(rec.opcode, rec.dir, rec.data,
+			                        rec.data_len, out, 0);
+		}
+		if (!(rec.flags & 4))
+			fprintf(out, " %8.f us     [ %.f ]\n",
+			        (rec.end_time - rec.start_time) * 1.0e6,
+			        rec.end_time * 1.0e6);
+	}
+	if (rec.data != NULL)
+		free(rec.data);
+	if (ret < 0)
+		return -1;
+	return 1;
+}
+
+
+/* The emulated drive receives the recorded WRITE commands at their recorded
+   times and drains its buffer at the recorded or measured write speed.
+   It reports buffer underruns and discontinuities of the write addresses.
+*/
+struct scsi_trace_emul {
+	double buffer_size;
+	double fill;
+	double min_fill;
+	double rate;           /* bytes per second, 0 = not yet known */
+	double last_time;
+	double first_write;
+	double last_write;
+	double written;
+	int writing;
+	int next_lba;
+	int writes;
+	int underruns;
+	int jumps;
+};
+
+
+static void scsi_trace_emul_drain(struct scsi_trace_emul *e, double t,
+                                  FILE *out, int flag)
+{
+	double dt;
+
+	dt = t - e->last_time;
+	if (dt <= 0.0)
+		return;
+	e->last_time = t;
+	if (!e->writing || e->rate <= 0.0)
+		return;
+	e->fill -= dt * e->rate;
+	if (e->fill < 0.0) {
+		e->underruns++;
+		fprintf(out,
+		   "Underrun at %.6f s before LBA %d, starved for %.3f ms\n",
+		        t, e->next_lba, -e->fill / e->rate * 1000.0);
+		e->fill = 0.0;
+	}
+}
+
+
+int burn_scsi_trace_replay(FILE *in, FILE *out, double speed_factor,
+                           int flag)
+{
+	struct burn_scsi_trace_rec rec;
+	struct scsi_trace_emul e;
+	int ret, lba, blocks, commands = 0, errors = 0;
+	int fixed_rate = 0;
+	unsigned char *op;
+	double measured;
+
+	memset(&rec, 0, sizeof(rec));
+	memset(&e, 0, sizeof(e));
+	e.min_fill = -1.0;
+	e.next_lba = -1;
+	e.first_write = -1.0;
+	if (speed_factor <= 0.0)
+		speed_factor = 1.0;
+
+	if (scsi_trace_read_header(in, 0) <= 0)
+		return -1;
+	while (1) {
+		ret = burn_scsi_trace_read(in, &rec, 0);
+		if (ret <= 0)
+	break;
+		if (rec.type == 'D') {
+			fprintf(out,
+			      "Warning: %d records missing after %.6f s\n",
+			      rec.bytes, rec.start_time);
+	continue;
+		}
+		if (rec.type != 'C')
+	continue;
+		commands++;
+		if (rec.sense_len > 0)
+			errors++;
+		op = rec.opcode;
+		scsi_trace_emul_drain(&e, rec.start_time, out, 0);
+
+		if (op[0] == 0x5C && rec.data_len >= 12) {
+			/* READ BUFFER CAPACITY : buffer length */
+			e.buffer_size = mmc_four_char_to_int(rec.data + 4);
+
+		} else if (op[0] == 0xBB) {
+			/* SET CD SPEED : kB/s with 1000 bytes */
+			if (((op[4] << 8) | op[5]) != 0xffff) {
+				e.rate = ((op[4] << 8) | op[5]) * 1000.0 *
+				         speed_factor;
+				fixed_rate = 1;
+			}
+
+		} else if (op[0] == 0xB6 && rec.data_len >= 28) {
+			/* SET STREAMING : Write Size in kB / Write Time in ms */
+			if (mmc_four_char_to_int(rec.data + 24) > 0) {
+				e.rate = mmc_four_char_to_int(rec.data + 20) *
+				     1000000.0 /
+				     mmc_four_char_to_int(rec.data + 24) *
+				     speed_factor;
+				fixed_rate = 1;
+			}
+
+		} else if ((op[0] == 0x2A || op[0] == 0xAA) &&
+		           rec.sense_len == 0) {
+			/* WRITE(10) , WRITE(12) */
+			lba = mmc_four_char_to_int(op + 2);
+			if (op[0] == 0x2A)
+				blocks = (op[7] << 8) | op[8];
+			else
+				blocks = mmc_four_char_to_int(op + 6);
+			if (e.next_lba >= 0 && lba != e.next_lba) {
+				e.jumps++;
+				fprintf(out,
+				      "Write address jump at %.6f s: %d -> %d\n",
+				        rec.start_time, e.next_lba, lba);
+			}
+			e.next_lba = lba + blocks;
+			if (e.first_write < 0.0)
+				e.first_write = rec.start_time;
+			e.last_write = rec.end_time;
+			e.writing = 1;
+			e.writes++;
+			e.written += rec.bytes;
+			scsi_trace_emul_drain(&e, rec.end_time, out, 0);
+			e.fill += rec.bytes;
+			if (e.buffer_size > 0 && e.fill > e.buffer_size)
+				e.fill = e.buffer_size;
+			if (!fixed_rate && e.last_write > e.first_write &&
+			    e.writes > 4) {
+				/* Without speed settings the drive has
+				   obviously consumed at the average rate */
+				e.rate = e.written /
+				         (e.last_write - e.first_write) *
+				         speed_factor;
+			}
+			if (e.min_fill < 0.0 || e.fill < e.min_fill)
+				e.min_fill = e.fill;
+
+		} else if (op[0] == 0x35 || op[0] == 0x5B) {
+			/* SYNCHRONIZE CACHE , CLOSE TRACK/SESSION */
+			e.writing = 0;
+			e.fill = 0.0;
+		}
+	}
+	if (rec.data != NULL)
+		free(rec.data);
+
+	measured = 0.0;
+	if (e.last_write > e.first_write)
+		measured = e.written / (e.last_write - e.first_write);
+	fprintf(out, "Commands       : %d (%d with sense data)\n",
+	        commands, errors);
+	fprintf(out, "WRITE commands : %d , %.f bytes\n", e.writes, e.written);
+	fprintf(out, "Write rate     : %.1f kB/s measured , %.1f kB/s emulated\n",
+	        measured / 1000.0, e.rate / 1000.0);
+	fprintf(out, "Drive buffer   : %.f bytes , min fill %.f bytes\n",
+	        e.buffer_size, e.min_fill < 0.0 ? 0.0 : e.min_fill);
+	fprintf(out, "Underruns      : %d\n", e.underruns);
+	fprintf(out, "Address jumps  : %d\n", e.jumps);
+	if (ret < 0)
+		return -1;
+	return (e.underruns == 0);
+}
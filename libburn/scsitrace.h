@@ -0,0 +1,121 @@
+/* -*- indent-tabs-mode: t; tab-width: 8; c-basic-offset: 8; -*- */
+
+/* Copyright (c) 2026 Thomas Schmitt <scdbackup@gmx.net>
+   Provided under GPL version 2 or later.
+*/
+
+/* ts C61019 : Binary SCSI command trace, enabled by burn_set_scsi_logging()
+               bit3. The commands get recorded into a ring per drive.
+               A background thread moves the rings into the trace file.
+               So the burning thread does neither format text nor wait for
+               file i/o.
+*/
+
+#ifndef BURN__SCSITRACE_H
+#define BURN__SCSITRACE_H
+
+#include <stdio.h>
+
+struct burn_drive;
+struct command;
+
+
+/* The file which receives the binary trace */
+#define Libburn_scsi_trace_filE "/tmp/libburn_sg_command_trace"
+
+/* Size of each per-drive ring. If a ring is full, then new records get
+   dropped and later accounted by a record of type 'D'.
+*/
+#define Libburn_scsi_trace_ring_sizE (1024 * 1024)
+
+/* Number of payload bytes which get recorded from bulk READ and WRITE.
+   Their full payload is represented by a digest.
+*/
+#define Libburn_scsi_trace_prefiX 32
+
+/* Maximum payload bytes which get recorded from other commands */
+#define Libburn_scsi_trace_payload_maX 65536
+
+/* Number of microseconds the writer thread sleeps if all rings are empty */
+#define Libburn_scsi_trace_idle_usleeP 20000
+
+
+/* Binary trace file format. All numbers are stored LSB first.
+
+   File header of Libburn_scsi_trace_header_sizE bytes:
+     0 - 19 : magic text "libburn SCSI trace" padded by 0-bytes
+    20 - 23 : format version (1)
+    24 - 31 : reserved, 0
+
+   Records of variable size, padded to a multiple of 4 bytes:
+     0 -  3 : total record size including padding
+     4 -  7 : sequence number within the drive's records
+     8 -  9 : drive global index, 0xffff for unregistered drives
+        10  : data direction (0= TO_DRIVE, 1= FROM_DRIVE, 2= NO_TRANSFER)
+        11  : command length
+    12 - 27 : command descriptor block
+    28 - 35 : start time in microseconds since burn_initialize()
+    36 - 43 : end time in microseconds since burn_initialize()
+    44 - 47 : number of payload bytes of the transfer
+    48 - 51 : CRC-32 of the full payload
+    52 - 55 : number of payload bytes recorded after the sense data
+        56  : number of sense bytes recorded
+        57  : retry loop count, 255 for all higher counts
+        58  : bit0= payload is truncated
+              bit1= no digest available
+              bit2= text log would have suppressed the time line
+        59  : record type: 'C' = command
+                           'D' = dropped records. Bytes 44 - 47 tell
+                                 their number.
+    60 - .. : sense bytes, then payload bytes
+*/
+#define Libburn_scsi_trace_header_sizE 32
+#define Libburn_scsi_trace_record_heaD 60
+#define Libburn_scsi_trace_versioN 1
+
+
+/* The trace record as decoded from the file */
+struct burn_scsi_trace_rec {
+	int type;
+	unsigned int seq;
+	int drive_index;
+	int dir;
+	int oplen;
+	unsigned char opcode[16];
+	double start_time;
+	double end_time;
+	int bytes;
+	unsigned int digest;
+	int flags;
+	int loop_count;
+	unsigned char sense[128];
+	int sense_len;
+	unsigned char *data;
+	int data_len;
+};
+
+
+/* Start or stop the trace according to burn_sg_log_scsi bit3 */
+int burn_scsi_trace_control(int flag);
+
+/* Put a command into the ring of its drive. To be called only by the thread
+   which issues the command.
+*/
+int burn_scsi_trace_record(struct burn_drive *d, struct command *c,
+                           unsigned char *sense, int sense_len,
+                           int loop_count, int flag);
+
+/* Read the next record from a trace file.
+   @return 1= record read, 0= end of file, -1= damaged file
+*/
+int burn_scsi_trace_read(FILE *fp, struct burn_scsi_trace_rec *rec,
+                         int flag);
+
+/* Write the trace in the text format of burn_set_scsi_logging() bit0 */
+int burn_scsi_trace_decode(FILE *in, FILE *out, int flag);
+
+/* Replay the trace against an emulated drive buffer */
+int burn_scsi_trace_replay(FILE *in, FILE *out, double speed_factor,
+                           int flag);
+
+#endif /* BURN__SCSITRACE_H */
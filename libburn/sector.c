@@ -16,6 +16,7 @@
 
 #include <unistd.h>
 #include <string.h>
+#include <pthread.h>
 #include "error.h"
 #include "options.h"
 #include "transport.h"
@@ -26,6 +27,7 @@
 #include "debug.h"
 #include "toc.h"
 #include "write.h"
+#include "event.h"
 
 #include "libdax_msgs.h"
 extern struct libdax_msgs *libdax_messenger;
@@ -104,7 +106,13 @@ static int get_outmode(struct burn_write_opts *o)
 }
 
 
-static void get_bytes(struct burn_track *track, int count, unsigned char *data)
+/* ts C61019 : Added parameter unit and return value.
+   @param unit  The size of the portions which get handed out as sectors.
+                The track data are done if a whole unit could not be filled.
+   @return      The number of bytes which were not padded by zeros
+*/
+static int get_bytes(struct burn_track *track, int count, unsigned char *data,
+		     int unit)
 {
 	int valid, shortage, curr, i, tr;
 
@@ -121,7 +129,7 @@ static void get_bytes(struct burn_track *track, int count, unsigned char *data)
 /* no track pointer means we're just generating 0s */
 	if (!track) {
 		memset(data, 0, count);
-		return;
+		return count;
 	}
 
 /* first we use up any offset */
@@ -185,9 +193,9 @@ static void get_bytes(struct burn_track *track, int count, unsigned char *data)
 		goto ex;
 
 	/* ts A61031 - B10103 */
-	if (shortage >= count)
+	if (shortage >= unit)
 		track->track_data_done = 1;
-	if (track->end_on_premature_eoi && shortage >= count &&
+	if (track->end_on_premature_eoi && shortage >= unit &&
 	    !track->open_ended) {
 		char msg[80];
 		off_t missing, inp_block_size, track_blocks;
@@ -231,6 +239,7 @@ ex:;
 			data[i-1] = tr;
 		}
 	}
+	return count - shortage;
 }
 
 
@@ -266,6 +275,10 @@ int sector_write_buffer(struct burn_drive *d,
 	d->nwa += out->sectors;
 	out->bytes = 0;
 	out->sectors = 0;
+
+	/* ts C61019 */
+	burn_drive_events_check(d, 0);
+
 	return 1;
 }
 
@@ -363,7 +376,7 @@ static int convert_data(struct burn_write_opts *o, struct burn_track *track,
 			if (track->cdxa_conversion == 1)
 				inlen += 8;
 
-		get_bytes(track, inlen, data);
+		get_bytes(track, inlen, data, inlen);
 
 		if (track != NULL)
 			if (track->cdxa_conversion == 1)
@@ -388,10 +401,197 @@ static int convert_data(struct burn_write_opts *o, struct burn_track *track,
 	if (offset == -1)
 		return 0;
 
-	get_bytes(track, inlen, data + offset);
+	get_bytes(track, inlen, data + offset, inlen);
+	return 1;
+}
+
+/* ts C61019 : Whether convert_subs() puts subchannel data into the output.
+   If not, then there is no need to compute them.
+*/
+static int sector_has_subs(struct burn_write_opts *o)
+{
+	return (o->block_type == BURN_BLOCK_RAW96R ||
+	        o->block_type == BURN_BLOCK_RAW16);
+}
+
+
+/* ts C61019 : burn_lba_to_msf() for the lba sequences of subchannel Q and
+   raw sector headers. If lba is the neighbor of the previous lba, then the
+   MSF address gets ticked rather than computed by divisions.
+*/
+static void sector_lba_to_msf(struct burn_msf_tick *t, int lba,
+			      int *m, int *s, int *f)
+{
+	/* -150 and -151 are the boundary between the two MSF ranges */
+	if (t->valid && lba == t->lba) {
+		;
+	} else if (t->valid && lba == t->lba + 1 && lba != -150) {
+		if (++(t->f) >= 75) {
+			t->f = 0;
+			if (++(t->s) >= 60) {
+				t->s = 0;
+				t->m++;
+			}
+		}
+	} else if (t->valid && lba == t->lba - 1 && lba != -151 &&
+		   (t->m > 0 || t->s > 0 || t->f > 0)) {
+		if (--(t->f) < 0) {
+			t->f = 74;
+			if (--(t->s) < 0) {
+				t->s = 59;
+				t->m--;
+			}
+		}
+	} else {
+		burn_lba_to_msf(lba, &(t->m), &(t->s), &(t->f));
+	}
+	t->lba = lba;
+	t->valid = 1;
+	*m = t->m;
+	*s = t->s;
+	*f = t->f;
+}
+
+
+#ifdef Libburn_ecma130ab_includeD
+
+/* ts C61019 : Outsourced from sector_headers().
+   Compute EDC, the zero bytes, P parity and Q parity of a raw MODE1 sector.
+*/
+static void sector_mode1_edc_ecc(unsigned char *out)
+{
+	unsigned int crc;
+
+#ifdef Libburn_no_crc_C
+	crc = 0; /* dummy */
+#else
+	crc = crc_32(out, 2064);
+#endif
+
+	out[2064] = crc & 0xFF;
+	crc >>= 8;
+	out[2065] = crc & 0xFF;
+	crc >>= 8;
+	out[2066] = crc & 0xFF;
+	crc >>= 8;
+	out[2067] = crc & 0xFF;
+	memset(out + 2068, 0, 8);
+	burn_rspc_parity_p(out);
+	burn_rspc_parity_q(out);
+}
+
+
+/* ts C61019 : Raw MODE1 sectors with zero user data, as written for pregap,
+   postgap, lead-out and the lead-in TOC, differ only in their address bytes.
+   EDC and RSPC parity are linear functions of the sector bytes and the
+   scrambler is an exclusive or with a constant sequence. So such a sector
+   is the encoded sector with address 00:00:00, changed by the encoded
+   sectors which have only one of the set address bits.
+   The changes are stored as lists of byte positions and exor values.
+*/
+#define Libburn_zero_delta_maX 64
+
+static unsigned char zero_sector_template[2352];
+static unsigned short zero_sector_delta_pos[24][Libburn_zero_delta_maX];
+static unsigned char zero_sector_delta_val[24][Libburn_zero_delta_maX];
+static int zero_sector_delta_count[24];
+
+/* 0= not yet initialized, 1= ready, -1= not usable */
+static int zero_sector_state = 0;
+
+/* Several drives may write in parallel */
+static pthread_once_t zero_sector_once = PTHREAD_ONCE_INIT;
+
+
+static void sector_zero_template_make(void)
+{
+	unsigned char sec[2352];
+	int bit, i, n;
+
+	for (bit = 0; bit < 24; bit++) {
+		memset(sec, 0, 2352);
+		sec[12 + bit / 8] = 1 << (bit % 8);
+		sector_mode1_edc_ecc(sec);
+		n = 0;
+		for (i = 0; i < 2352; i++) {
+			if (sec[i] == 0)
+		continue;
+			if (n >= Libburn_zero_delta_maX) {
+				zero_sector_state = -1;
+				return;
+			}
+			zero_sector_delta_pos[bit][n] = i;
+			zero_sector_delta_val[bit][n] = sec[i];
+			n++;
+		}
+		zero_sector_delta_count[bit] = n;
+	}
+
+	memset(zero_sector_template, 0, 2352);
+	memset(zero_sector_template + 1, 0xFF, 10);	/* sync */
+	zero_sector_template[15] = 1;			/* mode byte */
+	sector_mode1_edc_ecc(zero_sector_template);
+	burn_ecma130_scramble(zero_sector_template);
+
+	zero_sector_state = 1;
+}
+
+
+static int sector_zero_template_init(void)
+{
+	pthread_once(&zero_sector_once, sector_zero_template_make);
+	return zero_sector_state;
+}
+
+#endif /* Libburn_ecma130ab_includeD */
+
+
+/* ts C61019 : sector_headers() for sectors with zero user data.
+   Raw MODE1 sectors get copied from the template and patched.
+*/
+static int sector_headers_zero(struct burn_write_opts *o, unsigned char *out,
+			       int mode, int leadin)
+{
+
+#ifdef Libburn_ecma130ab_includeD
+
+	struct burn_drive *d = o->drive;
+	int min, sec, frame, bit, i;
+	unsigned int addr;
+
+	if (sector_headers_is_ok(o, mode) != 2 || !(mode & BURN_MODE1))
+		return sector_headers(o, out, mode, leadin);
+	if (sector_zero_template_init() != 1)
+		return sector_headers(o, out, mode, leadin);
+
+	if (leadin) {
+		sector_lba_to_msf(&(d->rel_msf), d->rlba, &min, &sec, &frame);
+		addr = (dec_to_bcd(min) + 0xA0) & 0xFF;
+	} else {
+		sector_lba_to_msf(&(d->abs_msf), d->alba, &min, &sec, &frame);
+		addr = dec_to_bcd(min);
+	}
+	addr |= (dec_to_bcd(sec) << 8) | (dec_to_bcd(frame) << 16);
+
+	memcpy(out, zero_sector_template, 2352);
+	for (bit = 0; bit < 24; bit++) {
+		if (!(addr & (1 << bit)))
+	continue;
+		for (i = 0; i < zero_sector_delta_count[bit]; i++)
+			out[zero_sector_delta_pos[bit][i]] ^=
+						zero_sector_delta_val[bit][i];
+	}
 	return 1;
+
+#else /* Libburn_ecma130ab_includeD */
+
+	return sector_headers(o, out, mode, leadin);
+
+#endif /* ! Libburn_ecma130ab_includeD */
+
 }
 
+
 static void convert_subs(struct burn_write_opts *o, int inmode,
 			 unsigned char *subs, unsigned char *sector)
 {
@@ -441,7 +641,7 @@ static void subcode_toc(struct burn_drive *d, int mode, unsigned char *data)
 	memset(data, 0, 96);
 	q = data + 12;
 
-	burn_lba_to_msf(d->rlba, &min, &sec, &frame);
+	sector_lba_to_msf(&(d->rel_msf), d->rlba, &min, &sec, &frame);
 /*XXX track numbers are BCD
 a0 - 1st track ctrl
 a1 - last track ctrl
@@ -487,7 +687,7 @@ int sector_toc(struct burn_write_opts *o, int mode)
 		return 0;
 	subcode_toc(d, mode, subs);
 	convert_subs(o, mode, subs, data);
-	if (sector_headers(o, data, mode, 1) <= 0)
+	if (sector_headers_zero(o, data, mode, 1) <= 0)
 		return 0;
 	sector_common(++)
 	return 1;
@@ -506,9 +706,11 @@ int sector_pregap(struct burn_write_opts *o,
 	/* ts A61010 */
 	if (convert_data(o, NULL, mode, data) <= 0)
 		return 0;
-	subcode_user(o, subs, tno, control, 0, NULL, 1);
-	convert_subs(o, mode, subs, data);
-	if (sector_headers(o, data, mode, 0) <= 0)
+	if (sector_has_subs(o)) {
+		subcode_user(o, subs, tno, control, 0, NULL, 1);
+		convert_subs(o, mode, subs, data);
+	}
+	if (sector_headers_zero(o, data, mode, 0) <= 0)
 		return 0;
 	sector_common(--)
 	return 1;
@@ -527,10 +729,12 @@ int sector_postgap(struct burn_write_opts *o,
 	/* ts A61010 */
 	if (convert_data(o, NULL, mode, data) <= 0)
 		return 0;
-/* use last index in track */
-	subcode_user(o, subs, tno, control, 1, NULL, 1);
-	convert_subs(o, mode, subs, data);
-	if (sector_headers(o, data, mode, 0) <= 0)
+	if (sector_has_subs(o)) {
+		/* use last index in track */
+		subcode_user(o, subs, tno, control, 1, NULL, 1);
+		convert_subs(o, mode, subs, data);
+	}
+	if (sector_headers_zero(o, data, mode, 0) <= 0)
 		return 0;
 	sector_common(++)
 	return 1;
@@ -547,8 +751,8 @@ static void subcode_lout(struct burn_write_opts *o, unsigned char control,
 	memset(data, 0, 96);
 	q = data + 12;
 
-	burn_lba_to_msf(d->alba, &min, &sec, &frame);
-	burn_lba_to_msf(d->rlba, &rmin, &rsec, &rframe);
+	sector_lba_to_msf(&(d->abs_msf), d->alba, &min, &sec, &frame);
+	sector_lba_to_msf(&(d->rel_msf), d->rlba, &rmin, &rsec, &rframe);
 
 	if (((rmin == 0) && (rsec == 0) && (rframe == 0)) ||
 	    ((rsec >= 2) && !((rframe / 19) % 2)))
@@ -628,12 +832,12 @@ void subcode_user(struct burn_write_opts *o, unsigned char *subcodes,
 		q[1] = dec_to_bcd(tno);	/* track number */
 		q[2] = dec_to_bcd(indx);	/* index XXX read this shit
 						   from the track array */
-		burn_lba_to_msf(d->rlba, &m, &s, &f);
+		sector_lba_to_msf(&(d->rel_msf), d->rlba, &m, &s, &f);
 		q[3] = dec_to_bcd(m);	/* rel min */
 		q[4] = dec_to_bcd(s);	/* rel sec */
 		q[5] = dec_to_bcd(f);	/* rel frame */
 		q[6] = 0;	/* zero */
-		burn_lba_to_msf(d->alba, &m, &s, &f);
+		sector_lba_to_msf(&(d->abs_msf), d->alba, &m, &s, &f);
 		q[7] = dec_to_bcd(m);	/* abs min */
 		q[8] = dec_to_bcd(s);	/* abs sec */
 		q[9] = dec_to_bcd(f);	/* abs frame */
@@ -649,7 +853,7 @@ void subcode_user(struct burn_write_opts *o, unsigned char *subcodes,
 		q[7] = o->mediacatalog[12] << 4;
 
 		q[8] = 0;
-		burn_lba_to_msf(d->alba, &m, &s, &f);
+		sector_lba_to_msf(&(d->abs_msf), d->alba, &m, &s, &f);
 		q[9] = dec_to_bcd(f);	/* abs frame */
 		break;
 	case 3:
@@ -683,7 +887,7 @@ void subcode_user(struct burn_write_opts *o, unsigned char *subcodes,
 		/* the top 4 bits of [8] is the last serial digit, the rest is 
 		   zeros */
 		q[8] = dec_to_bcd((isrc->serial / 10000) % 10) << 4;
-		burn_lba_to_msf(d->alba, &m, &s, &f);
+		sector_lba_to_msf(&(d->abs_msf), d->alba, &m, &s, &f);
 		q[9] = dec_to_bcd(f);	/* abs frame */
 		break;
 	}
@@ -712,9 +916,11 @@ int sector_lout(struct burn_write_opts *o, unsigned char control, int mode)
 	/* ts A61010 */
 	if (convert_data(o, NULL, mode, data) <= 0)
 		return 0;
-	subcode_lout(o, control, subs);
-	convert_subs(o, mode, subs, data);
-	if (sector_headers(o, data, mode, 0) <= 0)
+	if (sector_has_subs(o)) {
+		subcode_lout(o, control, subs);
+		convert_subs(o, mode, subs, data);
+	}
+	if (sector_headers_zero(o, data, mode, 0) <= 0)
 		return 0;
 	sector_common(++)
 	return 1;
@@ -739,16 +945,21 @@ int sector_data(struct burn_write_opts *o, struct burn_track *t, int psub)
 		return 2;
 	}
 
-	/* ts A61219 : allow track without .entry */
-	if (t->entry == NULL)
-		;
-	else if (!t->source->read_sub)
-		subcode_user(o, subs, t->entry->point,
-			     t->entry->control, 1, &t->isrc, psub);
-	else if (!t->source->read_sub(t->source, subs, 96))
-		subcode_user(o, subs, t->entry->point,
-			     t->entry->control, 1, &t->isrc, psub);
-	convert_subs(o, t->mode, subs, data);
+	/* ts C61019 : SAO, TAO and raw modes without subchannel in their
+	   block type would throw away the subchannel data anyway.
+	*/
+	if (sector_has_subs(o)) {
+		/* ts A61219 : allow track without .entry */
+		if (t->entry == NULL)
+			;
+		else if (!t->source->read_sub)
+			subcode_user(o, subs, t->entry->point,
+				     t->entry->control, 1, &t->isrc, psub);
+		else if (!t->source->read_sub(t->source, subs, 96))
+			subcode_user(o, subs, t->entry->point,
+				     t->entry->control, 1, &t->isrc, psub);
+		convert_subs(o, t->mode, subs, data);
+	}
 
 	if (sector_headers(o, data, t->mode, 0) <= 0)
 		return 0;
@@ -756,6 +967,133 @@ int sector_data(struct burn_write_opts *o, struct burn_track *t, int psub)
 	return 1;
 }
 
+
+/* ts C61019 : Batched equivalent of sector_data(o, t, 0).
+   The sector layout gets determined once per call. Then the source gets
+   read by a single call for all sectors which fit into the free part of
+   d->buffer. Headers and subchannel get added in a loop over the sectors.
+   @param max_sectors  The maximum number of sectors to produce
+   @param produced     Returns the number of sectors put into d->buffer
+   @return 1= ok, 2= end of track data, 0= failure
+*/
+int sector_data_batch(struct burn_write_opts *o, struct burn_track *t,
+		      int max_sectors, int *produced, int flag)
+{
+	struct burn_drive *d = o->drive;
+	struct buffer *out = d->buffer;
+	unsigned char subs[96], *data, *sec;
+	int outmode, inlen, seclen, offset = -1, limit, n, k, filled, ret;
+	int has_subs, headers;
+	off_t src_size, avail;
+
+	*produced = 0;
+	if (max_sectors <= 0)
+		return 1;
+
+	outmode = get_outmode(o);
+	if (outmode == 0)
+		outmode = t->mode;
+	inlen = burn_sector_length(t->mode);
+	seclen = burn_sector_length(outmode);
+	if (seclen < inlen || seclen < 0 || inlen <= 0)
+		return 0;
+	if ((outmode & BURN_MODE_BITS) == (t->mode & BURN_MODE_BITS)) {
+		if (t->cdxa_conversion == 1) {
+			/* Input sectors are larger than output sectors */
+			ret = sector_data(o, t, 0);
+			if (ret == 1)
+				*produced = 1;
+			return ret;
+		}
+		offset = 0;
+	} else {
+		if (!(outmode & BURN_MODE_RAW))
+			return 0;
+		if (t->mode & BURN_MODE1)
+			offset = 16;
+		if (t->mode & (BURN_MODE_RAW | BURN_AUDIO))
+			offset = 0;
+		if (offset == -1)
+			return 0;
+	}
+	seclen += burn_subcode_length(outmode);
+
+	/* Same flush rule as in get_sector() */
+	limit = BUFFER_SIZE;
+	if (o->obs > 0 && o->obs < limit)
+		limit = o->obs;
+	n = (limit - out->bytes) / seclen;
+	if (n <= 0) {
+		ret = sector_write_buffer(d, t, 0);
+		if (ret <= 0)
+			return 0;
+		n = limit / seclen;
+		if (n <= 0)
+			n = 1;
+	}
+	if (n > max_sectors)
+		n = max_sectors;
+
+	/* A source may deliver EOF rather than an incomplete buffer, like
+	   offst_read() does. So a batch must not reach beyond the announced
+	   end of the source. Near that end, sectors get read one by one like
+	   by sector_data().
+	*/
+	if (n > 1 && !t->eos) {
+		src_size = t->source->get_size(t->source);
+		avail = t->offset - t->offsetcount + src_size - t->sourcecount;
+		if (src_size > 0 && avail >= 0 && avail < (off_t) n * inlen) {
+			n = avail / inlen;
+			if (n < 1)
+				n = 1;
+		}
+	}
+
+	data = out->data + out->bytes;
+	filled = get_bytes(t, n * inlen, data, inlen);
+	ret = 1;
+	if ((t->open_ended || t->end_on_premature_eoi) && t->track_data_done) {
+		/* Only sectors with some track data count */
+		n = (filled + inlen - 1) / inlen;
+		ret = 2;
+	}
+	if (seclen != inlen || offset != 0)
+		for (k = n - 1; k >= 0; k--)
+			memmove(data + k * seclen + offset, data + k * inlen,
+				inlen);
+
+	has_subs = sector_has_subs(o);
+	headers = (sector_headers_is_ok(o, t->mode) != 1);
+	if (has_subs || headers) {
+		for (k = 0; k < n; k++) {
+			sec = data + k * seclen;
+			if (has_subs) {
+				if (t->entry == NULL)
+					;
+				else if (!t->source->read_sub)
+					subcode_user(o, subs, t->entry->point,
+					     t->entry->control, 1, &t->isrc, 0);
+				else if (!t->source->read_sub(t->source,
+								subs, 96))
+					subcode_user(o, subs, t->entry->point,
+					     t->entry->control, 1, &t->isrc, 0);
+				convert_subs(o, t->mode, subs, sec);
+			}
+			if (headers)
+				if (sector_headers(o, sec, t->mode, 0) <= 0)
+					return 0;
+			sector_common(++)
+		}
+	} else {
+		d->alba += n;
+		d->rlba += n;
+	}
+	out->bytes += n * seclen;
+	out->sectors += n;
+	*produced = n;
+	return ret;
+}
+
 int burn_msf_to_lba(int m, int s, int f)
 {
 	if (m < 90)
@@ -813,7 +1151,6 @@ int sector_headers(struct burn_write_opts *o, unsigned char *out,
 #ifdef Libburn_ecma130ab_includeD
 
 	struct burn_drive *d = o->drive;
-	unsigned int crc;
 	int min, sec, frame;
 	int modebyte = -1;
 	int ret;
@@ -828,39 +1165,20 @@ int sector_headers(struct burn_write_opts *o, unsigned char *out,
 	out[11] = 0;
 
 	if (leadin) {
-		burn_lba_to_msf(d->rlba, &min, &sec, &frame);
+		sector_lba_to_msf(&(d->rel_msf), d->rlba, &min, &sec, &frame);
 		out[12] = dec_to_bcd(min) + 0xA0;
 		out[13] = dec_to_bcd(sec);
 		out[14] = dec_to_bcd(frame);
 		out[15] = modebyte;
 	} else {
-		burn_lba_to_msf(d->alba, &min, &sec, &frame);
+		sector_lba_to_msf(&(d->abs_msf), d->alba, &min, &sec, &frame);
 		out[12] = dec_to_bcd(min);
 		out[13] = dec_to_bcd(sec);
 		out[14] = dec_to_bcd(frame);
 		out[15] = modebyte;
 	}
-	if (mode & BURN_MODE1) {
-
-#ifdef Libburn_no_crc_C
-		crc = 0; /* dummy */
-#else
-		crc = crc_32(out, 2064);
-#endif
-
-		out[2064] = crc & 0xFF;
-		crc >>= 8;
-		out[2065] = crc & 0xFF;
-		crc >>= 8;
-		out[2066] = crc & 0xFF;
-		crc >>= 8;
-		out[2067] = crc & 0xFF;
-	}
-	if (mode & BURN_MODE1) {
-		memset(out + 2068, 0, 8);
-		burn_rspc_parity_p(out);
-		burn_rspc_parity_q(out);
-	}
+	if (mode & BURN_MODE1)
+		sector_mode1_edc_ecc(out);
 	burn_ecma130_scramble(out);
 	return 1;
 
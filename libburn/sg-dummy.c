@@ -108,6 +108,28 @@ int sg_dispose_drive(struct burn_drive *d, int flag)
 }
 
 
+/* ts C61019 */
+/** Hotplug events are not supported by this adapter. See sg.h.
+*/
+int sg_hotplug_open(int *fd, int flag)
+{
+	*fd = -1;
+	return 0;
+}
+
+
+int sg_hotplug_close(int flag)
+{
+	return 0;
+}
+
+
+int sg_hotplug_read(int *action, char adr[], int adr_size, int flag)
+{
+	return 0;
+}
+
+
 /** Returns the next index number and the next enumerated drive address.
     The enumeration has to cover all available and accessible drives. It is
     allowed to return addresses of drives which are not available but under
@@ -342,9 +364,25 @@ int burn_os_open_track_src(char *path, int open_flags, int flag)
 
 void *burn_os_alloc_buffer(size_t amount, int flag)
 {
-	void *buf = NULL;
+	return burn_os_alloc_buffer_v2(amount, flag, NULL);
+}
+
 
-	buf = calloc(1, amount);
+/* ts C61019 */
+void *burn_os_alloc_buffer_v2(size_t amount, int flag, int *obtained)
+{
+	void *buf = NULL;
+	int dummy;
+
+	if (obtained == NULL)
+		obtained = &dummy;
+	if (flag & 1) {
+		buf = malloc(amount);
+		*obtained = 0;
+	} else {
+		buf = calloc(1, amount);
+		*obtained = 8;
+	}
 	return buf;
 }
 
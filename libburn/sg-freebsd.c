@@ -153,6 +153,28 @@ int sg_dispose_drive(struct burn_drive *d, int flag)
 }
 
 
+/* ts C61019 */
+/** Hotplug events are not supported by this adapter. See sg.h.
+*/
+int sg_hotplug_open(int *fd, int flag)
+{
+	*fd = -1;
+	return 0;
+}
+
+
+int sg_hotplug_close(int flag)
+{
+	return 0;
+}
+
+
+int sg_hotplug_read(int *action, char adr[], int adr_size, int flag)
+{
+	return 0;
+}
+
+
 /* ts A61021 : Moved most code from scsi_enumerate_drives under
                sg_give_next_adr() */
 /* Some helper functions for scsi_give_next_adr() */
@@ -518,6 +540,8 @@ could_not_allocate:;
 	out.mdata->p2a_valid = 0;
 	memset(&out.params, 0, sizeof(struct params));
 	t = burn_drive_register(&out);
+	if (t == NULL)
+		goto could_not_allocate;
 
 /* ts A60821
    <<< debug: for tracing calls which might use open drive fds */
@@ -1158,10 +1182,26 @@ int burn_os_open_track_src(char *path, int open_flags, int flag)
 
 
 void *burn_os_alloc_buffer(size_t amount, int flag)
+{
+	return burn_os_alloc_buffer_v2(amount, flag, NULL);
+}
+
+
+/* ts C61019 */
+void *burn_os_alloc_buffer_v2(size_t amount, int flag, int *obtained)
 {
 	void *buf = NULL;
+	int dummy;
 
-	buf = calloc(1, amount);
+	if (obtained == NULL)
+		obtained = &dummy;
+	if (flag & 1) {
+		buf = malloc(amount);
+		*obtained = 0;
+	} else {
+		buf = calloc(1, amount);
+		*obtained = 8;
+	}
 	return buf;
 }
 
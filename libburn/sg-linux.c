@@ -63,6 +63,13 @@ sg_dispose_drive()      finalizes adapter specifics of struct burn_drive
                         on destruction. Releases resources which were acquired
                         underneath scsi_enumerate_drives().
 
+sg_hotplug_open()       starts watching for attached and detached drives.
+
+sg_hotplug_close()      ends watching for attached and detached drives.
+
+sg_hotplug_read()       obtains the next pending event about an attached or
+                        detached drive.
+
 sg_drive_is_open()      tells wether libburn has the given drive in use.
 
 sg_grab()               opens the drive for SCSI commands and ensures
@@ -93,6 +100,9 @@ burn_os_alloc_buffer()  allocates a memory area that is suitable for file
                         The buffer size may be rounded up for alignment
                         reasons.
 
+burn_os_alloc_buffer_v2()  allocates such a memory area with optional huge
+                        pages and tells which properties were obtained.
+
 burn_os_free_buffer()   delete a buffer obtained by burn_os_alloc_buffer().
 
 
@@ -152,6 +162,10 @@ Hint: You should also look into sg-freebsd-port.c, which is a younger and
 #include <limits.h>
 #include <linux/cdrom.h>
 
+/* ts C61019 : for the uevents of hotplugged drives */
+#include <sys/socket.h>
+#include <linux/netlink.h>
+
 
 /** Indication of the Linux kernel this software is running on */
 /* -1 = not evaluated , 0 = unrecognizable , 1 = 2.4 , 2 = 2.6 */
@@ -219,6 +233,13 @@ static char linux_ata_device_family[80] = {"/dev/hd%c"};
 static int linux_ata_enumerate_verbous = 0;
 
 
+/* ts C61019 : Socket which receives the kernel uevents, or -1 */
+static int linux_hotplug_fd = -1;
+
+/* Size of the receive buffer for a single uevent */
+#define Libburn_linux_ueventS 4096
+
+
 /** PORTING : ------ libburn portable headers and definitions ----- */
 
 #include "libburn.h"
@@ -1518,6 +1539,7 @@ int sg_initialize(char msg[1024], int flag)
 */  
 int sg_shutdown(int flag)
 {
+	sg_hotplug_close(0); /* ts C61019 */
 	return 1;
 }
 
@@ -1537,6 +1559,186 @@ int sg_dispose_drive(struct burn_drive *d, int flag)
 }
 
 
+/* ts C61019 */
+/** Starts watching for attached and detached drives.
+    This implementation listens to the kernel uevents via a netlink socket.
+    See sg.h for the parameters.
+*/
+int sg_hotplug_open(int *fd, int flag)
+{
+	struct sockaddr_nl nls;
+	int sock, ret;
+
+	if (linux_hotplug_fd != -1) {
+		*fd = linux_hotplug_fd;
+		return 1;
+	}
+	*fd = -1;
+	sock = socket(PF_NETLINK, SOCK_DGRAM, NETLINK_KOBJECT_UEVENT);
+	if (sock == -1)
+		goto failed;
+	memset(&nls, 0, sizeof(nls));
+	nls.nl_family = AF_NETLINK;
+	nls.nl_pid = 0;      /* let the kernel assign a unique address */
+	nls.nl_groups = 1;   /* the kernel uevent multicast group */
+	ret = bind(sock, (struct sockaddr *) &nls, sizeof(nls));
+	if (ret == -1)
+		goto failed;
+	fcntl(sock, F_SETFL, fcntl(sock, F_GETFL) | O_NONBLOCK);
+	fcntl(sock, F_SETFD, fcntl(sock, F_GETFD) | FD_CLOEXEC);
+	linux_hotplug_fd = *fd = sock;
+	return 1;
+
+failed:;
+	libdax_msgs_submit(libdax_messenger, -1, 0x000201b9,
+		LIBDAX_MSGS_SEV_FAILURE, LIBDAX_MSGS_PRIO_HIGH,
+		"Cannot listen to kernel events about drives", errno, 0);
+	if (sock != -1)
+		close(sock);
+	return -1;
+}
+
+
+/* ts C61019 */
+/** Ends watching for attached and detached drives. See sg.h.
+*/
+int sg_hotplug_close(int flag)
+{
+	if (linux_hotplug_fd == -1)
+		return 0;
+	close(linux_hotplug_fd);
+	linux_hotplug_fd = -1;
+	return 1;
+}
+
+
+/* ts C61019 */
+/* Derive the device address from the kernel name of the device.
+   It is accepted only if it belongs to the device family which is used for
+   enumeration. E.g. "sr0" gets "/dev/sr0" if the family is "/dev/sr%d".
+   @return 1= adr is valid, 0= not a device of the family
+*/
+static int sg_hotplug_adr(char *subsystem, char *devname,
+                          char adr[], int adr_size)
+{
+	char *npt, *family;
+	int prefix_len;
+
+	sg_select_device_family();
+	family = linux_sg_device_family;
+	npt = strstr(family, "%d");
+	if (npt == NULL)
+		return 0;
+	prefix_len = npt - family;
+
+	if (strcmp(subsystem, "block") == 0 && strncmp(devname, "sr", 2) == 0) {
+		npt = devname + 2;
+		if (strcmp(family, "/dev/scd%d") == 0) {
+			/* The kernel names are sr*, the old links are scd* */
+			if (strlen(npt) + 9 > (size_t) adr_size)
+				return 0;
+			sprintf(adr, "/dev/scd%s", npt);
+		} else {
+			if (strlen(devname) + 6 > (size_t) adr_size)
+				return 0;
+			sprintf(adr, "/dev/%s", devname);
+		}
+	} else if (strcmp(subsystem, "scsi_generic") == 0 &&
+	           strncmp(devname, "sg", 2) == 0) {
+		npt = devname + 2;
+		if (strlen(devname) + 6 > (size_t) adr_size)
+			return 0;
+		sprintf(adr, "/dev/%s", devname);
+	} else
+		return 0;
+	if (*npt == 0)
+		return 0;
+	for (; *npt != 0; npt++)
+		if (*npt < '0' || *npt > '9')
+			return 0;
+	if (strncmp(adr, family, prefix_len) != 0)
+		return 0;
+	if (adr[prefix_len] < '0' || adr[prefix_len] > '9')
+		return 0;
+	return 1;
+}
+
+
+/* ts C61019 */
+/** Obtains the next pending event about an attached or detached drive.
+    Events about other devices get skipped. See sg.h for the parameters.
+*/
+int sg_hotplug_read(int *action, char adr[], int adr_size, int flag)
+{
+	char *buf = NULL, *cpt, *action_text, *subsystem, *devname;
+	ssize_t count;
+	int ret;
+	struct sockaddr_nl sender;
+	socklen_t sender_len;
+
+	*action = 0;
+	if (linux_hotplug_fd == -1)
+		return 0;
+	BURN_ALLOC_MEM(buf, char, Libburn_linux_ueventS + 1);
+	while (1) {
+		sender_len = sizeof(sender);
+		memset(&sender, 0, sizeof(sender));
+		count = recvfrom(linux_hotplug_fd, buf, Libburn_linux_ueventS,
+		                 0, (struct sockaddr *) &sender, &sender_len);
+		if (count == -1) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+				{ret = 0; goto ex;}
+			if (errno == EINTR || errno == ENOBUFS)
+	continue; /* ENOBUFS: events were lost. Go on with the rest. */
+			libdax_msgs_submit(libdax_messenger, -1, 0x000201b9,
+				LIBDAX_MSGS_SEV_FAILURE, LIBDAX_MSGS_PRIO_HIGH,
+				"Cannot read kernel events about drives",
+				errno, 0);
+			{ret = -1; goto ex;}
+		}
+		if (count <= 0)
+			{ret = 0; goto ex;}
+		if (sender.nl_pid != 0)
+	continue; /* only the kernel is trusted */
+		buf[count] = 0;
+
+		/* The message consists of "action@devpath" and a sequence of
+		   "KEY=value", all separated by 0-bytes.
+		*/
+		action_text = subsystem = devname = NULL;
+		for (cpt = buf; cpt < buf + count; cpt += strlen(cpt) + 1) {
+			if (strncmp(cpt, "ACTION=", 7) == 0)
+				action_text = cpt + 7;
+			else if (strncmp(cpt, "SUBSYSTEM=", 10) == 0)
+				subsystem = cpt + 10;
+			else if (strncmp(cpt, "DEVNAME=", 8) == 0)
+				devname = cpt + 8;
+		}
+		if (action_text == NULL || subsystem == NULL ||
+		    devname == NULL)
+	continue;
+		if (strcmp(action_text, "add") == 0)
+			*action = 1;
+		else if (strcmp(action_text, "remove") == 0)
+			*action = 2;
+		else
+	continue;
+		/* Some kernels hand out the path relative to /dev */
+		if (strncmp(devname, "/dev/", 5) == 0)
+			devname += 5;
+		if (sg_hotplug_adr(subsystem, devname, adr, adr_size) <= 0) {
+			*action = 0;
+	continue;
+		}
+		break;
+	}
+	ret = 1;
+ex:;
+	BURN_FREE_MEM(buf);
+	return ret;
+}
+
+
 /** PORTING:
     In this GNU/Linux implementation, this function mirrors the enumeration
     done in sg_enumerate and ata_enumerate(). It would be better to base those
@@ -2473,8 +2675,57 @@ int burn_os_open_track_src(char *path, int open_flags, int flag)
 
 
 void *burn_os_alloc_buffer(size_t amount, int flag)
+{
+	return burn_os_alloc_buffer_v2(amount, flag, NULL);
+}
+
+
+#ifdef Libburn_linux_do_mmaP
+
+/* ts C61019 : The size of the default huge pages of the system */
+static size_t linux_huge_page_size(void)
+{
+	static size_t page_size = 0;
+	size_t size;
+	unsigned long kb;
+	FILE *fp;
+	char line[160];
+
+	if (page_size > 0)
+		return page_size;
+	size = 2 * 1024 * 1024;
+	fp = fopen("/proc/meminfo", "r");
+	if (fp != NULL) {
+		while (fgets(line, sizeof(line), fp) != NULL) {
+			if (sscanf(line, "Hugepagesize: %lu kB", &kb) == 1) {
+				if (kb > 0)
+					size = ((size_t) kb) * 1024;
+		break;
+			}
+		}
+		fclose(fp);
+	}
+	page_size = size;
+	return page_size;
+}
+
+#endif /* Libburn_linux_do_mmaP */
+
+
+/* ts C61019 */
+void *burn_os_alloc_buffer_v2(size_t amount, int flag, int *obtained)
 {
 	void *buf = NULL;
+	int dummy;
+
+#ifdef Libburn_linux_do_mmaP
+	size_t huge, map_size, page, tail;
+	char *base, *start, *end;
+#endif
+
+	if (obtained == NULL)
+		obtained = &dummy;
+	*obtained = 0;
 
 #ifdef Libburn_linux_do_mmaP
 
@@ -2483,14 +2734,82 @@ void *burn_os_alloc_buffer(size_t amount, int flag)
 	libdax_msgs_submit(libdax_messenger, -1, 0x00000002,
 		LIBDAX_MSGS_SEV_DEBUG, LIBDAX_MSGS_PRIO_HIGH,
 		"Allocating buffer via mmap()" , 0, 0);
+	huge = linux_huge_page_size();
+
+#ifdef MAP_HUGETLB
+	if (flag & 4) {
+		/* Only as many huge pages as reserved in
+		   /proc/sys/vm/nr_hugepages are available
+		*/
+		map_size = ((amount + huge - 1) / huge) * huge;
+		buf = mmap(NULL, map_size, PROT_READ | PROT_WRITE,
+			   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+			   -1, (off_t) 0);
+		if (buf != MAP_FAILED) {
+			/* The kernel hands out zeroed huge pages */
+			*obtained = 1 | 4;
+			return buf;
+		}
+		buf = NULL;
+		libdax_msgs_submit(libdax_messenger, -1, 0x00000002,
+			LIBDAX_MSGS_SEV_DEBUG, LIBDAX_MSGS_PRIO_HIGH,
+			"No explicit huge pages available for buffer",
+			errno, 0);
+	}
+#endif /* MAP_HUGETLB */
+
+#ifdef MADV_HUGEPAGE
+	if ((flag & (2 | 4)) && amount >= huge) {
+		/* Transparent huge pages need a private mapping which is
+		   aligned to the huge page size. So map more than needed
+		   and give back the unaligned head and tail.
+		*/
+		page = sysconf(_SC_PAGESIZE);
+		map_size = amount + huge;
+		base = mmap(NULL, map_size, PROT_READ | PROT_WRITE,
+			    MAP_PRIVATE | MAP_ANONYMOUS, -1, (off_t) 0);
+		if (base != MAP_FAILED) {
+			start = base + (huge - ((size_t) base) % huge) % huge;
+			end = start + ((amount + page - 1) / page) * page;
+			tail = (base + map_size) - end;
+			if (start > base)
+				munmap(base, start - base);
+			if (tail > 0)
+				munmap(end, tail);
+			buf = start;
+			*obtained = 1;
+			if (madvise(buf, amount, MADV_HUGEPAGE) == 0)
+				*obtained |= 2;
+			goto zero_fill;
+		}
+	}
+#endif /* MADV_HUGEPAGE */
+
 	buf = mmap(NULL, amount, PROT_READ | PROT_WRITE,
 			 	MAP_SHARED | MAP_ANONYMOUS, -1, (off_t) 0);
 	if (buf == MAP_FAILED)
-		buf = NULL;
-	else
+		return NULL;
+	*obtained = 1;
+
+zero_fill:;
+	/* The kernel delivers zeros anyway. But memset() maps the pages
+	   right now, on the memory node of the calling thread. Without it,
+	   the pages get mapped by the thread which first writes to them.
+	*/
+	if (!(flag & 1)) {
 		memset(buf, 0, amount);
-#else
-	buf = calloc(1, amount);
+		*obtained |= 8;
+	}
+
+#else /* Libburn_linux_do_mmaP */
+
+	if (flag & 1) {
+		buf = malloc(amount);
+	} else {
+		buf = calloc(1, amount);
+		*obtained = 8;
+	}
+
 #endif /* ! Libburn_linux_do_mmaP */
 
 	return buf;
@@ -2501,10 +2820,19 @@ int burn_os_free_buffer(void *buffer, size_t amount, int flag)
 {
 	int ret = 0;
 
+#ifdef Libburn_linux_do_mmaP
+	size_t huge;
+#endif
+
 	if (buffer == NULL)
 		return 0;
 #ifdef Libburn_linux_do_mmaP
 	ret = munmap(buffer, amount);
+	if (ret == -1 && errno == EINVAL) {
+		/* Explicit huge pages can only be unmapped as a whole */
+		huge = linux_huge_page_size();
+		ret = munmap(buffer, ((amount + huge - 1) / huge) * huge);
+	}
 #else
 	free(buffer);
 #endif
@@ -64,6 +64,14 @@ sg_dispose_drive()      finalizes adapter specifics of struct burn_drive
                         on destruction. Releases resources which were acquired
                         underneath scsi_enumerate_drives().
  
+sg_hotplug_open()       starts watching for attached and detached drives.
+                        (Not supported by this adapter yet.)
+ 
+sg_hotplug_close()      ends watching for attached and detached drives.
+ 
+sg_hotplug_read()       obtains the next pending event about an attached or
+                        detached drive.
+ 
 sg_drive_is_open()      tells wether libburn has the given drive in use.
 
 sg_grab()               opens the drive for SCSI commands and ensures
@@ -94,6 +102,9 @@ burn_os_alloc_buffer()  allocates a memory area that is suitable for file
                         The buffer size may be rounded up for alignment
                         reasons.
 
+burn_os_alloc_buffer_v2()  allocates such a memory area and tells which
+                        properties were obtained.
+
 burn_os_free_buffer()   delete a buffer obtained by burn_os_alloc_buffer().
 
 Porting hints are marked by the text "PORTING:".
@@ -362,6 +373,28 @@ int sg_dispose_drive(struct burn_drive *d, int flag)
 }
 
 
+/* ts C61019 */
+/** Hotplug events are not supported by this adapter. See sg.h.
+*/
+int sg_hotplug_open(int *fd, int flag)
+{
+	*fd = -1;
+	return 0;
+}
+
+
+int sg_hotplug_close(int flag)
+{
+	return 0;
+}
+
+
+int sg_hotplug_read(int *action, char adr[], int adr_size, int flag)
+{
+	return 0;
+}
+
+
 /** Returns the next index number and the next enumerated drive address.
     The enumeration has to cover all available and accessible drives. It is
     allowed to return addresses of drives which are not available but under
@@ -893,10 +926,26 @@ int burn_os_open_track_src(char *path, int open_flags, int flag)
 
 
 void *burn_os_alloc_buffer(size_t amount, int flag)
+{
+	return burn_os_alloc_buffer_v2(amount, flag, NULL);
+}
+
+
+/* ts C61019 */
+void *burn_os_alloc_buffer_v2(size_t amount, int flag, int *obtained)
 {
 	void *buf = NULL;
+	int dummy;
 
-	buf = calloc(1, amount);
+	if (obtained == NULL)
+		obtained = &dummy;
+	if (flag & 1) {
+		buf = malloc(amount);
+		*obtained = 0;
+	} else {
+		buf = calloc(1, amount);
+		*obtained = 8;
+	}
 	return buf;
 }
 
@@ -81,4 +81,35 @@ int sg_shutdown(int flag);
 int sg_dispose_drive(struct burn_drive *d, int flag);
 
 
+/* ts C61019 */
+/** Starts watching for drives which get attached to or detached from the
+    system.
+    @param fd    returns a file descriptor which becomes readable when events
+                 are pending, or -1 if there is no such descriptor
+    @param flag  unused yet, submit 0
+    @return      1 = success, 0 = not supported by this adapter,
+                 <0 = failure
+*/
+int sg_hotplug_open(int *fd, int flag);
+
+/* ts C61019 */
+/** Ends watching for attached and detached drives.
+    @param flag  unused yet, submit 0
+    @return      1 = watching was ended, 0 = was not watching
+*/
+int sg_hotplug_close(int flag);
+
+/* ts C61019 */
+/** Obtains the next pending event about an attached or detached drive.
+    Does not wait for events.
+    @param action    returns 1 = drive attached, 2 = drive detached
+    @param adr       returns the device address as used by sg_give_next_adr()
+    @param adr_size  size of adr
+    @param flag      unused yet, submit 0
+    @return          1 = event obtained, 0 = no event pending,
+                     <0 = failure
+*/
+int sg_hotplug_read(int *action, char adr[], int adr_size, int flag);
+
+
 #endif /* __SG */
@@ -34,6 +34,7 @@
 #include "options.h"
 #include "init.h"
 #include "util.h"
+#include "scsitrace.h"
 
 #include "libdax_msgs.h"
 extern struct libdax_msgs *libdax_messenger;
@@ -43,6 +44,7 @@ extern struct libdax_msgs *libdax_messenger;
    bit0= log in /tmp/libburn_sg_command_log
    bit1= log to stderr
    bit2= flush every line
+   bit3= record binary trace in /tmp/libburn_sg_command_trace
 */
 extern int burn_sg_log_scsi;
 
@@ -428,10 +430,20 @@ static int spc_try_get_performance(struct burn_drive *d, int flag)
 		return ret;
 	if (feature_descr->data_lenght <= 0)
 		return 1;
-	if (feature_descr->data[0] & 2)             /* WSPD */
-		ret = mmc_get_write_performance(d);
-	/* Get read performance */
-	mmc_get_performance(d, 0x00, 0);
+	if (feature_descr->data[0] & 2) {           /* WSPD */
+		/* ts C61019 : Write speeds are of no use with pressed media.
+		               Inquire them only if somebody asks.
+		*/
+		if (d->current_profile == 0x08 || d->current_profile == 0x10 ||
+		    d->current_profile == 0x40)
+			d->mdata->perf_pending |= 1;
+		else
+			ret = mmc_get_write_performance(d);
+	}
+	/* ts C61019 : Read performance is rarely of interest. It gets inquired
+	               by mmc_get_pending_performance() when needed.
+	*/
+	d->mdata->perf_pending |= 2;
 	return 1;
 }
 
@@ -1004,7 +1016,11 @@ void spc_getcaps(struct burn_drive *d)
 		return;
 
 	burn_speed_descriptor_destroy(&(d->mdata->speed_descriptors), 1);
-	spc_inquiry(d);
+	d->mdata->perf_pending = 0;
+
+	/* ts C61019 : The INQUIRY reply does not change with the media */
+	if (d->idata->valid <= 0)
+		spc_inquiry(d);
 	spc_sense_caps(d);
 	spc_sense_error_params(d);
 }
@@ -1209,6 +1225,7 @@ int burn_scsi_setup_drive(struct burn_drive *d, int bus_no, int host_no,
 	d->mdata->max_write_speed = 0;
 	d->mdata->cur_write_speed = 0;
 	d->mdata->speed_descriptors = NULL;
+	d->mdata->perf_pending = 0;
 	d->mdata->write_page_length = 0x32;
 	d->mdata->write_page_valid = 0;
 	if (!(flag & 1)) {
@@ -1982,6 +1999,10 @@ int scsi_eval_cmd_outcome(struct burn_drive *d, struct command *c, void *fp,
 	if (burn_sg_log_scsi & 3)
 		scsi_log_err(d, c, fp, sense, sense_len,
 				 (sense_len > 0) | (flag & 2));
+	/* ts C61019 */
+	if (burn_sg_log_scsi & 8)
+		burn_scsi_trace_record(d, c, sense, sense_len, loop_count,
+		                       flag & 2);
 	if (sense_len <= 0)
 		{done = 1; goto ex;}
 		
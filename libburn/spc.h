@@ -75,6 +75,14 @@ int scsi_init_command(struct command *c, unsigned char *opcode, int oplen);
 /* ts A91106 */
 int scsi_show_cmd_text(struct command *c, void *fp, int flag);
 
+/* ts C61019 : now public for the binary trace decoder in scsitrace.c */
+int scsi_show_command(unsigned char *opcode, int oplen, int dir,
+                      unsigned char *data, int bytes,
+                      void *fp_in, int flag);
+int scsi_show_command_reply(unsigned char *opcode, int data_dir,
+                            unsigned char *data, int dxfer_len,
+                            void *fp_in, int flag);
+
 /* ts B11110 */
 /** Logs command (before execution). */
 int scsi_log_command(unsigned char *opcode, int oplen, int data_dir,
@@ -1471,19 +1471,22 @@ ex:
 }
 
 
-/* @param flag    bit0-7: desired type : 0=any , 1=.wav
+/* @param given_fd  An fd which is already open on path, or -1
+   @param flag    bit0-7: desired type : 0=any , 1=.wav
                   bit8= open by libdax_audioxtr functions
                 
 */
-static int cue_create_file_source(char *path, struct burn_cue_file_cursor *crs,
-								int flag)
+static int cue_create_file_source(char *path, int given_fd,
+				struct burn_cue_file_cursor *crs, int flag)
 {
 	int fd, ret;
 	char *msg = NULL;
 
 	BURN_ALLOC_MEM(msg, char, 4096);
 
-	if (flag & 256) {
+	if (given_fd != -1) {
+		fd = given_fd;
+	} else if (flag & 256) {
 		ret = cue_open_audioxtr(path, crs, &fd, flag & 255);
 		if (ret <= 0)
 			goto ex;
@@ -1575,11 +1578,79 @@ ex:;
 }
 
 	
+/* ts C61019 : Dispatch of cue sheet commands by a sorted keyword table
+               rather than by a chain of strcmp() calls.
+*/
+enum cue_command {
+	CUE_CMD_UNKNOWN = 0,
+	CUE_CMD_ARRANGER,
+	CUE_CMD_CATALOG,
+	CUE_CMD_CDTEXTFILE,
+	CUE_CMD_COMPOSER,
+	CUE_CMD_FILE,
+	CUE_CMD_FLAGS,
+	CUE_CMD_INDEX,
+	CUE_CMD_ISRC,
+	CUE_CMD_MESSAGE,
+	CUE_CMD_PERFORMER,
+	CUE_CMD_POSTGAP,
+	CUE_CMD_PREGAP,
+	CUE_CMD_REM,
+	CUE_CMD_SONGWRITER,
+	CUE_CMD_TITLE,
+	CUE_CMD_TRACK,
+};
+
+struct cue_keyword {
+	char *name;
+	enum cue_command id;
+};
+
+/* Must be sorted by strcmp() */
+static struct cue_keyword cue_keywords[] = {
+	{"ARRANGER", CUE_CMD_ARRANGER},
+	{"CATALOG", CUE_CMD_CATALOG},
+	{"CDTEXTFILE", CUE_CMD_CDTEXTFILE},
+	{"COMPOSER", CUE_CMD_COMPOSER},
+	{"FILE", CUE_CMD_FILE},
+	{"FLAGS", CUE_CMD_FLAGS},
+	{"INDEX", CUE_CMD_INDEX},
+	{"ISRC", CUE_CMD_ISRC},
+	{"MESSAGE", CUE_CMD_MESSAGE},
+	{"PERFORMER", CUE_CMD_PERFORMER},
+	{"POSTGAP", CUE_CMD_POSTGAP},
+	{"PREGAP", CUE_CMD_PREGAP},
+	{"REM", CUE_CMD_REM},
+	{"SONGWRITER", CUE_CMD_SONGWRITER},
+	{"TITLE", CUE_CMD_TITLE},
+	{"TRACK", CUE_CMD_TRACK},
+};
+
+
+static int cue_keyword_cmp(const void *key, const void *member)
+{
+	return strcmp((char *) key, ((struct cue_keyword *) member)->name);
+}
+
+
+static enum cue_command cue_command_id(char *cmd)
+{
+	struct cue_keyword *kw;
+
+	kw = bsearch(cmd, cue_keywords,
+		     sizeof(cue_keywords) / sizeof(struct cue_keyword),
+		     sizeof(struct cue_keyword), cue_keyword_cmp);
+	if (kw == NULL)
+		return CUE_CMD_UNKNOWN;
+	return kw->id;
+}
+
+
 static int cue_interpret_line(struct burn_session *session, char *line,
 				struct burn_cue_file_cursor *crs, int flag)
 {
 	int ret, mode, index_no, file_ba, chunks;
-	int block_size, step, audio_xtr = 0;
+	int block_size, step, audio_xtr = 0, fd = -1;
 	off_t size;
 	char *cmd, *apt, *msg = NULL, *cpt, *filetype;
 	struct burn_source *src, *inp_src;
@@ -1599,12 +1670,15 @@ static int cue_interpret_line(struct burn_session *session, char *line,
 		for (apt++; *apt == 32 || *apt == 9; apt++);
 	}
 
-	if (strcmp(cmd, "ARRANGER") == 0) {
+	switch (cue_command_id(cmd)) {
+
+	case CUE_CMD_ARRANGER:
 		ret = cue_set_cdtext(session, crs->track, 0x84, apt, crs, 2);
 		if (ret <= 0)
 			goto ex;
+		break;
 
-	} else if (strcmp(cmd, "CATALOG") == 0) {
+	case CUE_CMD_CATALOG:
 		for (cpt = apt; (cpt - apt) < 13 && *cpt == (*cpt & 0x7f);
 		     cpt++);
 		if ((cpt - apt) < 13) {
@@ -1621,8 +1695,9 @@ static int cue_interpret_line(struct burn_session *session, char *line,
 			memcpy(session->mediacatalog, apt, 13);
 			session->mediacatalog[13] = 0;
 		}
+		break;
 
-	} else if (strcmp(cmd, "CDTEXTFILE") == 0) {
+	case CUE_CMD_CDTEXTFILE:
 		if (crs->no_cdtext) {
 			ret = 1; goto ex;
 		}
@@ -1637,13 +1712,15 @@ out_of_mem:;
 				"Out of virtual memory", 0, 0);
 			ret = -1; goto ex;
 		}
+		break;
 
-	} else if (strcmp(cmd, "COMPOSER") == 0) {
+	case CUE_CMD_COMPOSER:
 		ret = cue_set_cdtext(session, crs->track, 0x83, apt, crs, 2);
 		if (ret <= 0)
 			goto ex;
+		break;
 
-	} else if (strcmp(cmd, "FILE") == 0) {
+	case CUE_CMD_FILE:
 		if (crs->file_source != NULL) {
 			libdax_msgs_submit(libdax_messenger, -1, 0x00020192,
 				LIBDAX_MSGS_SEV_FAILURE, LIBDAX_MSGS_PRIO_HIGH,
@@ -1682,12 +1759,25 @@ out_of_mem:;
 		}
 
 		apt = cue_unquote_text(apt, 0);
-		if (*apt == 0)
-			ret = -1;
-		else
+		ret = -1;
+		if (*apt != 0 && !audio_xtr) {
+			/* ts C61019 : Open once and inquire the open file.
+			   O_NONBLOCK keeps a FIFO from blocking the open.
+			   The fd gets handed to cue_create_file_source().
+			*/
+			fd = open(apt, O_RDONLY | O_BINARY | O_NONBLOCK);
+			if (fd != -1)
+				ret = fstat(fd, &stbuf);
+		}
+		if (fd == -1 && *apt != 0)
+			/* cue_create_file_source() will report a failed open
+			   of a regular file
+			*/
 			ret = stat(apt, &stbuf);
 		if (ret == -1) {
 not_usable_file:;
+			if (fd != -1)
+				close(fd);
 			sprintf(msg,
 				"In cue sheet file: Unusable FILE '%.4000s'",
 				apt);
@@ -1702,13 +1792,18 @@ not_usable_file:;
 		if (crs->source_file != NULL)
 			free(crs->source_file);
 		crs->source_file = strdup(apt);
-		if (crs->source_file == NULL)
+		if (crs->source_file == NULL) {
+			if (fd != -1)
+				close(fd);
 			goto out_of_mem;
-		ret = cue_create_file_source(apt, crs, audio_xtr);
+		}
+		ret = cue_create_file_source(apt, fd, crs, audio_xtr);
+		fd = -1;
 		if (ret <= 0)
 			goto ex;
+		break;
 
-	} else if (strcmp(cmd, "FLAGS") == 0) {
+	case CUE_CMD_FLAGS:
 		ret = cue_check_for_track(crs, cmd, 0);
 		if (ret <= 0)
 			goto ex;
@@ -1748,8 +1843,9 @@ bad_flags:;
 			for (apt += step; *apt == 32 || *apt == 9; apt++);
 		}
 		burn_track_define_data(crs->track, 0, 0, 1, crs->track_mode);
+		break;
 
-	} else if (strcmp(cmd, "INDEX") == 0) {
+	case CUE_CMD_INDEX:
 		ret = cue_check_for_track(crs, cmd, 0);
 		if (ret <= 0)
 			goto ex;
@@ -1842,8 +1938,9 @@ overlapping_ba:;
 			burn_source_free(crs->offst_source);
 		crs->offst_source = src;
 		crs->track_has_source = 1;
+		break;
 
-	} else if (strcmp(cmd, "ISRC") == 0) {
+	case CUE_CMD_ISRC:
 		ret = cue_check_for_track(crs, cmd, 0);
 		if (ret <= 0)
 			goto ex;
@@ -1856,18 +1953,21 @@ overlapping_ba:;
 			if (ret <= 0)
 				goto ex;
 		}
+		break;
 
-	} else if (strcmp(cmd, "MESSAGE") == 0) {
+	case CUE_CMD_MESSAGE:
 		ret = cue_set_cdtext(session, crs->track, 0x85, apt, crs, 2);
 		if (ret <= 0)
 			goto ex;
+		break;
 
-	} else if (strcmp(cmd, "PERFORMER") == 0) {
+	case CUE_CMD_PERFORMER:
 		ret = cue_set_cdtext(session, crs->track, 0x81, apt, crs, 2);
 		if (ret <= 0)
 			goto ex;
+		break;
 
-	} else if (strcmp(cmd, "POSTGAP") == 0) {
+	case CUE_CMD_POSTGAP:
 		ret = cue_check_for_track(crs, cmd, 0);
 		if (ret <= 0)
 			goto ex;
@@ -1878,8 +1978,9 @@ overlapping_ba:;
 		ret = burn_track_set_postgap_size(crs->track, file_ba, 0);
 		if (ret <= 0)
 			goto ex;
+		break;
 
-	} else if (strcmp(cmd, "PREGAP") == 0) {
+	case CUE_CMD_PREGAP:
 		ret = cue_check_for_track(crs, cmd, 0);
 		if (ret <= 0)
 			goto ex;
@@ -1890,21 +1991,25 @@ overlapping_ba:;
 		ret = burn_track_set_pregap_size(crs->track, file_ba, 0);
 		if (ret <= 0)
 			goto ex;
+		break;
 
-	} else if (strcmp(cmd, "REM") == 0) {
+	case CUE_CMD_REM:
 		;
+		break;
 
-	} else if (strcmp(cmd, "SONGWRITER") == 0) {
+	case CUE_CMD_SONGWRITER:
 		ret = cue_set_cdtext(session, crs->track, 0x82, apt, crs, 2);
 		if (ret <= 0)
 			goto ex;
+		break;
 
-	} else if (strcmp(cmd, "TITLE") == 0) {
+	case CUE_CMD_TITLE:
 		ret = cue_set_cdtext(session, crs->track, 0x80, apt, crs, 2);
 		if (ret <= 0)
 			goto ex;
+		break;
 
-	} else if (strcmp(cmd, "TRACK") == 0) {
+	case CUE_CMD_TRACK:
 		if (crs->file_source == NULL) {
 			libdax_msgs_submit(libdax_messenger, -1, 0x00020192,
 				LIBDAX_MSGS_SEV_FAILURE, LIBDAX_MSGS_PRIO_HIGH,
@@ -1963,8 +2068,9 @@ overlapping_ba:;
 		if (mode & BURN_AUDIO)
 			burn_track_set_byte_swap(crs->track,
 						!!crs->swap_audio_bytes);
+		break;
 
-	} else {
+	default:
 		sprintf(msg, "Unknown cue sheet file command '%.4000s'", line);
 		libdax_msgs_submit(libdax_messenger, -1, 0x00020191,
 				LIBDAX_MSGS_SEV_FAILURE, LIBDAX_MSGS_PRIO_HIGH,
@@ -2166,3 +2272,89 @@ ex:
 	return ret;
 }
 
+
+/* ts C61019 */
+/* API */
+int burn_session_by_audio_files(struct burn_session *session,
+			char **paths, int num_paths, int fifo_size,
+			struct burn_source **fifo, int flag)
+{
+	int ret, i, num_tracks, chunks;
+	off_t *starts = NULL;
+	struct burn_source *playlist = NULL, *inp_src, *fifo_src = NULL;
+	struct burn_source *src, *prev_src = NULL;
+	struct burn_track *track, **tracks;
+
+	if (fifo != NULL)
+		*fifo = NULL;
+	burn_session_get_tracks(session, &num_tracks);
+	if (num_tracks > 0) {
+		libdax_msgs_submit(libdax_messenger, -1, 0x000201b0,
+				LIBDAX_MSGS_SEV_FAILURE, LIBDAX_MSGS_PRIO_HIGH,
+		 "Audio playlist given to session with already defined tracks",
+				0, 0);
+		return 0;
+	}
+	BURN_ALLOC_MEM(starts, off_t, num_paths + 1);
+	playlist = burn_audio_playlist_source_new(paths, num_paths, -1,
+						starts, flag & 1);
+	if (playlist == NULL) {
+		ret = 0; goto ex;
+	}
+	inp_src = playlist;
+	if (fifo_size > 0) {
+		chunks = fifo_size / 2352 + !!(fifo_size % 2352);
+		if (chunks < 4)
+			chunks = 4;
+		fifo_src = burn_fifo_source_new(playlist, 2352, chunks, 0);
+		if (fifo_src == NULL) {
+			ret = -1; goto ex;
+		}
+		inp_src = fifo_src;
+	}
+	for (i = 0; i < num_paths; i++) {
+		track = burn_track_create();
+		if (track == NULL) {
+			ret = -1; goto ex;
+		}
+		burn_track_define_data(track, 0, 0, 1, BURN_AUDIO);
+		src = burn_offst_source_new(inp_src, prev_src, starts[i],
+					starts[i + 1] - starts[i], 1);
+		if (src == NULL) {
+			burn_track_free(track);
+			ret = -1; goto ex;
+		}
+		if (prev_src != NULL)
+			burn_source_free(prev_src);
+		prev_src = src;
+		if (burn_track_set_source(track, src) != BURN_SOURCE_OK) {
+			burn_track_free(track);
+			ret = -1; goto ex;
+		}
+		ret = burn_session_add_track(session, track, BURN_POS_END);
+		burn_track_free(track); /* release reference */
+		if (ret <= 0) {
+			ret = -1; goto ex;
+		}
+	}
+	if (fifo != NULL) {
+		*fifo = fifo_src;
+		fifo_src = NULL;
+	}
+	ret = 1;
+ex:;
+	if (ret <= 0) {
+		tracks = burn_session_get_tracks(session, &num_tracks);
+		for (i = num_tracks - 1; i >= 0; i--)
+			burn_session_remove_track(session, tracks[i]);
+	}
+	if (prev_src != NULL)
+		burn_source_free(prev_src);
+	if (fifo_src != NULL)
+		burn_source_free(fifo_src);
+	if (playlist != NULL)
+		burn_source_free(playlist);
+	BURN_FREE_MEM(starts);
+	return ret;
+}
+
@@ -20,6 +20,11 @@
 /* see os.h for name of particular os-*.h where this is defined */
 #define BUFFER_SIZE BURN_OS_TRANSPORT_BUFFER_SIZE
 
+/* ts C61019 : System Area and Volume Descriptor area of ISO 9660, i.e. the
+               blocks 0 to 31 which get read by burn_disc_read_iso_head()
+*/
+#define Libburn_iso_head_sizE (32 * 2048)
+
 
 enum transfer_direction
 { TO_DRIVE, FROM_DRIVE, NO_TRANSFER };
@@ -118,6 +123,12 @@ struct scsi_mode_data
 	int max_end_lba;
 	struct burn_speed_descriptor *speed_descriptors;
 
+	/* ts C61019 : GET PERFORMANCE types which were not inquired yet.
+	               bit0= Type 03h write speed , bit1= Type 00h read speed
+	               See mmc_get_pending_performance().
+	*/
+	int perf_pending;
+
 	int retry_page_length;
 	int retry_page_valid;
 	int write_page_length;
@@ -159,6 +170,16 @@ struct burn_feature_descr {
 };
 
 
+/* ts C61019 : An lba and its MSF address, to be ticked forward or backward
+   to the neighboring lba. See sector.c.
+*/
+struct burn_msf_tick {
+	int valid;
+	int lba;
+	int m, s, f;
+};
+
+
 /** Gets initialized in enumerate_common() and burn_drive_register() */
 struct burn_drive
 {
@@ -404,6 +425,10 @@ struct burn_drive
 	int pbf_altered;
 	int wait_for_buffer_free;
 	int nominal_write_speed;
+	/* ts C61019 : The write speed as set by burn_drive_set_speed().
+	               Autotuning never raises the speed above it.
+	*/
+	int user_write_speed;
 	unsigned int wfb_min_usec;
 	unsigned int wfb_max_usec;
 	unsigned int wfb_timeout_sec;
@@ -414,6 +439,11 @@ struct burn_drive
 	unsigned int waited_tries;
 	unsigned int waited_usec;
 
+	/* ts C61019 : Counts calls of burn_drive_get_status(). Write loops
+	               inquire the drive buffer sooner if it changed.
+	*/
+	volatile unsigned int status_inquiries;
+
 	volatile int cancel;
 	volatile enum burn_drive_status busy;
 
@@ -424,6 +454,51 @@ struct burn_drive
 	*/
 	struct burn_write_opts *write_opts;
 
+	/* ts C61019 : see burn_drive_set_event_handler() */
+	struct burn_drive_events *events;
+
+	/* ts C61019 : Persistent thread which executes the operations on
+	               this drive. See async.c.
+	*/
+	struct burn_drive_worker *worker;
+
+	/* ts C61019 : Number of worker jobs which use this drive object and
+	               whether burn_drive_free() has to be performed when the
+	               last of them ends. Protected by a lock in drive.c.
+	*/
+	int users;
+	int free_pending;
+
+	/* ts C61019 : The device has been removed according to a hotplug
+	               event. See burn_drive_hotplug_check().
+	*/
+	int hotplug_detached;
+
+	/* ts C61019 : Timing of blanking and formatting.
+	               See burn_drive_get_bg_op_times().
+	*/
+	double bg_op_start;
+	volatile double bg_op_poll;
+	volatile double bg_op_end;
+	volatile double bg_op_next;
+
+	/* ts C61019 : Whether the drive accepts a large allocation length
+	               with the first execution of inquiry commands.
+	               0 = not known yet , 1 = yes , -1 = no
+	*/
+	int big_alloc_len;
+
+	/* ts C61019 : Copy of the first Libburn_iso_head_sizE bytes of the
+	               medium. Valid only as long as nobody else wrote there.
+	               See burn_disc_read_iso_head().
+	*/
+	char *iso_head_cache;
+	int iso_head_valid;
+
+	/* ts C61019 : MSF of alba and rlba as last used for raw CD sectors */
+	struct burn_msf_tick abs_msf;
+	struct burn_msf_tick rel_msf;
+
 	/* ts A70929 */
 	pid_t thread_pid;
 	int thread_pid_valid;
@@ -506,6 +581,11 @@ struct burn_drive
 	int toc_entries;
 	struct burn_toc_entry *toc_entry;
 
+	/* ts C61019 : 1 = the TOC of DVD or BD media was not built yet.
+	               See mmc_complete_toc().
+	*/
+	int toc_pending;
+
 	/* ts A61023 : get size and free space of drive buffer */
 	int (*read_buffer_capacity) (struct burn_drive *d);
 
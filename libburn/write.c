@@ -59,6 +59,8 @@
 #include "source.h"
 #include "mmc.h"
 #include "spc.h"
+#include "event.h"
+#include "file.h"
 
 #include "libdax_msgs.h"
 extern struct libdax_msgs *libdax_messenger;
@@ -95,6 +97,12 @@ extern struct libdax_msgs *libdax_messenger;
 */
 #define Libburn_stdio_write_retrieS 16
 
+/* ts C61019 : The size of the pieces which burn_random_access_write() hands
+   to write(2) when writing to a stdio pseudo-drive. They come directly from
+   the caller's memory.
+*/
+#define Libburn_stdio_ra_chunK (4 * 1024 * 1024)
+
 
 static int type_to_ctrl(int mode)
 {
@@ -205,6 +213,71 @@ int burn_write_flush(struct burn_write_opts *o, struct burn_track *track)
 }
 
 
+/* ts C61019 */
+/* Write the ISO 9660 head of burn_write_opts_set_iso_head() to blocks 16
+   to 31. Only the range of blocks which differ from the cached head gets
+   transmitted. To be called after the data of the last track were flushed
+   out of d->buffer and before the drive cache gets synchronized, so that
+   one sync covers both.
+*/
+static int burn_write_iso_head(struct burn_write_opts *o, int flag)
+{
+	struct burn_drive *d = o->drive;
+	struct buffer *out = d->buffer;
+	int first = 0, last = 15, nwa_mem, err;
+	char *cached, msg[80];
+
+	if (o->iso_head == NULL || o->simulate || d->cancel)
+		return 2;
+	if (d->iso_head_valid && d->iso_head_cache != NULL) {
+		cached = d->iso_head_cache + 16 * 2048;
+		for (; first < 16; first++)
+			if (memcmp(o->iso_head + first * 2048,
+			           cached + first * 2048, 2048))
+		break;
+		if (first >= 16) {
+			libdax_msgs_submit(libdax_messenger, d->global_index,
+				0x00000002,
+				LIBDAX_MSGS_SEV_DEBUG, LIBDAX_MSGS_PRIO_ZERO,
+				"ISO 9660 head is unchanged", 0, 0);
+			return 1;
+		}
+		for (; last > first; last--)
+			if (memcmp(o->iso_head + last * 2048,
+			           cached + last * 2048, 2048))
+		break;
+	}
+	if (d->current_profile == 0x13) {
+		/* DVD-RW Restricted Overwrite needs 32 KiB alignment */
+		first = 0;
+		last = 15;
+	}
+	sprintf(msg, "Updating ISO 9660 head: blocks %d to %d",
+	        16 + first, 16 + last);
+	libdax_msgs_submit(libdax_messenger, d->global_index, 0x00000002,
+		LIBDAX_MSGS_SEV_DEBUG, LIBDAX_MSGS_PRIO_ZERO, msg, 0, 0);
+
+	/* d->buffer got emptied by burn_write_flush_buffer() */
+	memcpy(out->data, o->iso_head + first * 2048,
+	       (last - first + 1) * 2048);
+	out->bytes = (last - first + 1) * 2048;
+	out->sectors = last - first + 1;
+	nwa_mem = d->nwa;
+	err = d->write(d, 16 + first, out);
+	d->nwa = nwa_mem;
+	out->bytes = 0;
+	out->sectors = 0;
+	if (err == BE_CANCELLED) {
+		d->iso_head_valid = 0;
+		d->cancel = 1;
+		return 0;
+	}
+	if (d->iso_head_valid)
+		memcpy(d->iso_head_cache + 16 * 2048, o->iso_head, 16 * 2048);
+	return 1;
+}
+
+
 /* ts A71002 : outsourced from burn_write_close_track() */
 int burn_write_track_minsize(struct burn_write_opts *o, struct burn_session *s,
 				int tnum)
@@ -264,6 +337,7 @@ int burn_write_close_track(struct burn_write_opts *o, struct burn_session *s,
 	d = o->drive;
 
 	d->busy = BURN_DRIVE_CLOSING_TRACK;
+	burn_drive_events_check(d, 0); /* ts C61019 */
 
 	sprintf(msg, "Closing track %2.2d", tnum+1);
 	libdax_msgs_submit(libdax_messenger, o->drive->global_index,0x00020119,
@@ -298,6 +372,7 @@ int burn_write_close_session(struct burn_write_opts *o)
 
 	/* ts A61102 */
 	o->drive->busy = BURN_DRIVE_CLOSING_SESSION;
+	burn_drive_events_check(o->drive, 0); /* ts C61019 */
 
 	o->drive->close_track_session(o->drive, 1, 0);
 
@@ -930,13 +1005,15 @@ static int burn_create_text_packs(struct burn_write_opts *o,
 static int burn_write_leadin_cdtext(struct burn_write_opts *o,
 					 struct burn_session *s, int flag)
 {
-	int ret, i, j, si, lba, sub_cursor = 0, err, write_lba, sectors = 0;
-	int self_made_text_packs = 0;
+	int ret, i, si, lba, sub_cursor = 0, err, sectors = 0;
+	int self_made_text_packs = 0, period, per_write, image_size;
+	unsigned int word;
 	unsigned char *subdata = NULL;
 	struct burn_drive *d = o->drive;
 	struct buffer *buf = NULL;
 	enum burn_drive_status was_busy = o->drive->busy;
 #ifdef Libburn_debug_cd_texT
+	int j;
 	unsigned char *packs;
 #endif
 
@@ -984,53 +1061,54 @@ static int burn_write_leadin_cdtext(struct burn_write_opts *o,
 	}
 #endif /* Libburn_debug_cd_texT */
 
-	/* Chop from 8 bit text pack to 6 bit subchannel */
-	BURN_ALLOC_MEM(subdata, unsigned char, o->num_text_packs * 24);
+	/* ts C61019 :
+	   Chop from 8 bit text pack to 6 bit subchannel. Each 24 bit word of
+	   the packs yields four 6 bit subchannel bytes.
+	   The image repeats the cycle of packs often enough for copying the
+	   payload of each WRITE by a single memcpy().
+	*/
+	period = o->num_text_packs * 24;
+	per_write = 32768 / 96;
+	image_size = period + per_write * 96;
+	BURN_ALLOC_MEM(subdata, unsigned char, image_size);
 	for (i = 0; i < 18 * o->num_text_packs; i += 3) {
 		si = i / 3 * 4;
-		subdata[si + 0] =  (o->text_packs[i + 0] >> 2) & 0x3f;
-		subdata[si + 1] =  (o->text_packs[i + 0] << 4) & 0x30;
-		subdata[si + 1] |= (o->text_packs[i + 1] >> 4) & 0x0f;
-		subdata[si + 2] =  (o->text_packs[i + 1] << 2) & 0x3c;
-		subdata[si + 2] |= (o->text_packs[i + 2] >> 6) & 0x03;
-		subdata[si + 3] =  (o->text_packs[i + 2] >> 0) & 0x3f;
+		word = (o->text_packs[i] << 16) | (o->text_packs[i + 1] << 8) |
+		       o->text_packs[i + 2];
+		subdata[si + 0] = (word >> 18) & 0x3f;
+		subdata[si + 1] = (word >> 12) & 0x3f;
+		subdata[si + 2] = (word >>  6) & 0x3f;
+		subdata[si + 3] =  word        & 0x3f;
 	}
+	for (i = period; i < image_size; i += period)
+		memcpy(subdata + i, subdata,
+		       i + period <= image_size ? period : image_size - i);
 
 	/* Start at Lead-in address of ATIP and write blocks up to -150 */
 	BURN_ALLOC_MEM(buf, struct buffer, 1);
-	write_lba = d->start_lba;
-	for (lba = d->start_lba; lba < -150; lba++) {
-		/* Collect subdata in buf */
-		for (j = 0; j < 4; j++) {
-			memcpy(buf->data + buf->bytes,
-				subdata + sub_cursor * 24, 24);
-			sub_cursor = (sub_cursor + 1) % o->num_text_packs;
-			buf->bytes += 24;
-		}
-		buf->sectors++;
-		sectors++;
-
-		/* When full or last sector : perform WRITE */
-		if (buf->bytes + 96 >= 32768 || lba == -151) {
+	for (lba = d->start_lba; lba < -150; lba += sectors) {
+		sectors = -150 - lba;
+		if (sectors > per_write)
+			sectors = per_write;
+		memcpy(buf->data, subdata + sub_cursor, sectors * 96);
+		buf->bytes = sectors * 96;
+		buf->sectors = sectors;
+		sub_cursor = (sub_cursor + sectors * 96) % period;
 
 #ifdef Libburn_debug_cd_texT
-			fprintf(stderr,
-			    "libburn_DEBUG: 6 bit data to be transmitted:\n"); 
-			for (i = 0; i < buf->bytes; i += 24) {
-				fprintf(stderr, "%4d :", i / 24);
-				for (j = 0; j < 24; j++)
-					fprintf(stderr, " %2.2X",
-						buf->data[i + j]);
-				fprintf(stderr, "\n");
-			}
-#endif /* Libburn_debug_cd_texT */
-	
-			err = d->write(d, write_lba, buf);
-			if (err == BE_CANCELLED)
-				{ ret = 0; goto ex; }
-			write_lba += sectors;
-			sectors = buf->sectors = buf->bytes = 0;
+		fprintf(stderr,
+			"libburn_DEBUG: 6 bit data to be transmitted:\n"); 
+		for (i = 0; i < buf->bytes; i += 24) {
+			fprintf(stderr, "%4d :", i / 24);
+			for (j = 0; j < 24; j++)
+				fprintf(stderr, " %2.2X", buf->data[i + j]);
+			fprintf(stderr, "\n");
 		}
+#endif /* Libburn_debug_cd_texT */
+
+		err = d->write(d, lba, buf);
+		if (err == BE_CANCELLED)
+			{ ret = 0; goto ex; }
 	}
 	ret = 1;
 ex:;
@@ -1100,6 +1178,309 @@ int burn_disc_init_track_status(struct burn_write_opts *o,
 	/* ts A61102 */
 	d->busy = BURN_DRIVE_WRITING;
 
+	/* ts C61019 */
+	burn_drive_events_set_source(d, t->source, 0);
+	burn_fifo_set_drive(t->source, d, 0);
+	burn_drive_events_check(d, 2);
+
+	return 1;
+}
+
+
+/* ts C61019 : Decision when to inquire the drive buffer fill during the
+   transmission of track data.
+   The distance between inquiries grows while the drive buffer stays
+   nearly full. It shrinks to a minimum when the fill drops low or
+   decreases. An application which inquires burn_drive_get_status() gets
+   a fresh report after the minimum distance.
+*/
+struct burn_buf_poll {
+	off_t step;          /* current distance in bytes */
+	off_t def_step;      /* distance while the fill is neither low nor
+	                        comfortably high */
+	off_t min_step;
+	off_t max_step;
+	off_t last_bytes;    /* d->progress.buffered_bytes at last inquiry */
+	off_t hold_until;    /* no inquiry before this byte count */
+	int quirks;          /* bit0= no inquiry before drive buffer is full */
+	int inquiries;       /* number of inquiries made */
+	double last_fill;    /* fill ratio at last inquiry, -1 = unknown */
+	unsigned int last_demand; /* d->status_inquiries at last inquiry */
+};
+
+/* Minimum and maximum fill ratio for the distance to change */
+#define Libburn_buf_poll_low_filL  0.5
+#define Libburn_buf_poll_high_filL 0.9
+
+
+/* @param def_step  Distance in bytes if no fill trend is known
+   @param flag      bit0= drive must not be inquired again before its
+                          buffer is full (Pioneer DVR-216D with DVD-R)
+*/
+static void burn_buf_poll_init(struct burn_buf_poll *p, struct burn_drive *d,
+				off_t def_step, int flag)
+{
+	p->def_step = p->step = def_step;
+	p->min_step = def_step / 4;
+	p->max_step = def_step * 16;
+	p->last_bytes = d->progress.buffered_bytes;
+	p->hold_until = 0;
+	p->quirks = flag & 1;
+	p->inquiries = 0;
+	p->last_fill = -1.0;
+	p->last_demand = d->status_inquiries;
+}
+
+
+/* Adapt the distance to the drive buffer fill after an inquiry */
+static void burn_buf_poll_learn(struct burn_buf_poll *p,
+				struct burn_drive *d)
+{
+	off_t cap, avail, max_step;
+	double fill;
+
+	cap = d->progress.buffer_capacity;
+	avail = d->progress.buffer_available;
+	if (cap <= 0 || avail < 0 || avail > cap) {
+		p->step = p->def_step;
+		p->last_fill = -1.0;
+		return;
+	}
+	fill = ((double) (cap - avail)) / (double) cap;
+
+	/* Before the drive buffer could have been filled, the fill
+	   tells nothing about the risk of underrun */
+	if (d->progress.buffered_bytes < cap) {
+		p->step = p->def_step;
+	} else if (fill < Libburn_buf_poll_low_filL ||
+		   (p->last_fill >= 0.0 && fill < p->last_fill - 0.1)) {
+		p->step = p->min_step;
+	} else if (fill >= Libburn_buf_poll_high_filL &&
+		   (p->last_fill < 0.0 || fill >= p->last_fill - 0.02)) {
+		p->step *= 2;
+		/* Inquire at least twice per buffer content */
+		max_step = p->max_step;
+		if (max_step > cap / 2 && cap / 2 >= p->def_step)
+			max_step = cap / 2;
+		if (p->step > max_step)
+			p->step = max_step;
+	} else if (p->step < p->def_step) {
+		p->step *= 2;
+		if (p->step > p->def_step)
+			p->step = p->def_step;
+	}
+	p->last_fill = fill;
+}
+
+
+/* Inquire the drive buffer if it is due.
+   @return 1= inquiry was made, 0= not due
+*/
+static int burn_buf_poll(struct burn_buf_poll *p, struct burn_drive *d,
+			 int flag)
+{
+	off_t bytes, dist;
+
+	bytes = d->progress.buffered_bytes;
+	dist = bytes - p->last_bytes;
+	if (p->inquiries > 0) {
+		if (bytes < p->hold_until)
+			return 0;
+		if (dist < p->step &&
+		    (dist < p->min_step ||
+		     d->status_inquiries == p->last_demand))
+			return 0;
+	}
+	d->read_buffer_capacity(d);
+	p->inquiries++;
+	p->last_bytes = bytes;
+	p->last_demand = d->status_inquiries;
+	if (p->quirks & 1) {
+		/* Wait until the drive buffer is surely full */
+		p->quirks &= ~1;
+		p->hold_until = bytes + d->progress.buffer_capacity +
+				128 * 2048;
+		return 1;
+	}
+	burn_buf_poll_learn(p, d);
+	return 1;
+}
+
+
+/* Maximum number of distinct speeds on the ladder */
+#define Libburn_autotune_speedS   32
+
+/* Default number of seconds between decisions */
+#define Libburn_autotune_intervaL 4.0
+
+/* Number of intervals to wait after a speed change */
+#define Libburn_autotune_settlE   2
+
+/* Fifo fill ratios below which the speed gets lowered and above which it
+   gets raised
+*/
+#define Libburn_autotune_low_filL  0.25
+#define Libburn_autotune_high_filL 0.75
+
+
+/* ts C61019 : Adaption of the DVD or BD write speed to the pace which the
+   track source and the drive buffer actually sustain.
+   See burn_write_opts_set_speed_autotune().
+   The write speeds of the speed descriptors from GET PERFORMANCE form a
+   ladder. Decisions are made after a fresh inquiry of the drive buffer,
+   i.e. between two WRITE commands, and not more often than once per
+   interval. After a change the next decision waits for a few intervals,
+   so that fifo and drive buffer can settle at the new speed.
+*/
+struct burn_speed_tune {
+	int active;
+	int speeds[Libburn_autotune_speedS]; /* ascending, in kB/s */
+	int num_speeds;
+	int current;             /* index in speeds */
+	double interval;
+	double next_time;        /* no decision before this time */
+	unsigned int last_waited_usec; /* d->waited_usec at last decision */
+	struct burn_source *fifo;
+};
+
+
+static int burn_speed_tune_init(struct burn_speed_tune *p,
+				struct burn_write_opts *o,
+				struct burn_track *t, int flag)
+{
+	struct burn_drive *d = o->drive;
+	struct burn_speed_descriptor *sd;
+	int i, j, speed, max_speed;
+
+	p->active = 0;
+	p->num_speeds = 0;
+	p->current = -1;
+	p->interval = 0.0;
+	p->next_time = 0.0;
+	p->last_waited_usec = 0;
+	p->fifo = NULL;
+	if (!o->autotune || d->drive_role != 1 || d->current_is_cd_profile)
+		return 0;
+
+	mmc_get_pending_performance(d, 1);
+	max_speed = d->user_write_speed;
+	for (sd = d->mdata->speed_descriptors; sd != NULL; sd = sd->next) {
+		speed = sd->write_speed;
+		if (sd->source != 2 || speed <= 0 ||
+		    speed < o->autotune_min_speed ||
+		    (max_speed > 0 && speed > max_speed))
+	continue;
+		for (i = 0; i < p->num_speeds; i++)
+			if (p->speeds[i] >= speed)
+		break;
+		if ((i < p->num_speeds && p->speeds[i] == speed) ||
+		    p->num_speeds >= Libburn_autotune_speedS)
+	continue;
+		for (j = p->num_speeds; j > i; j--)
+			p->speeds[j] = p->speeds[j - 1];
+		p->speeds[i] = speed;
+		p->num_speeds++;
+	}
+	if (p->num_speeds < 2)
+		return 0;
+	/* A previous track may have left the drive at a lower speed */
+	for (i = p->num_speeds - 1; i > 0; i--)
+		if (d->nominal_write_speed <= 0 ||
+		    p->speeds[i] <= d->nominal_write_speed)
+	break;
+	p->current = i;
+	p->interval = o->autotune_interval;
+	if (p->interval <= 0.0)
+		p->interval = Libburn_autotune_intervaL;
+	/* Let fifo and drive buffer fill before the first decision */
+	p->next_time = burn_get_time(0) +
+		       Libburn_autotune_settlE * p->interval;
+	p->last_waited_usec = d->waited_usec;
+	p->fifo = burn_source_get_fifo(t->source, 0);
+	p->active = 1;
+	return 1;
+}
+
+
+/* Decide whether to change the write speed and eventually do it.
+   @return 1= speed was changed, 0= not
+*/
+static int burn_speed_tune_check(struct burn_speed_tune *p,
+				 struct burn_drive *d, int flag)
+{
+	struct burn_fifo_pressure pressure;
+	double now, fifo_fill = -1.0, drive_fill = -1.0, rate = -1.0;
+	off_t cap, avail;
+	unsigned int waited;
+	int target, i, ret, sose_mem;
+	char msg[160];
+
+	if (!p->active)
+		return 0;
+	now = burn_get_time(0);
+	if (now < p->next_time)
+		return 0;
+	p->next_time = now + p->interval;
+	waited = d->waited_usec - p->last_waited_usec;
+	p->last_waited_usec = d->waited_usec;
+
+	cap = d->progress.buffer_capacity;
+	avail = d->progress.buffer_available;
+	if (cap > 0 && avail >= 0 && avail <= cap &&
+	    d->progress.buffered_bytes >= cap)
+		drive_fill = ((double) (cap - avail)) / (double) cap;
+	if (p->fifo != NULL) {
+		ret = burn_fifo_inquire_pressure(p->fifo, &pressure, 0);
+		if (ret > 0 && pressure.size > 0) {
+			fifo_fill = ((double) pressure.fill) /
+				    (double) pressure.size;
+			rate = pressure.producer_rate;
+		}
+	}
+
+	target = p->current;
+	if ((fifo_fill >= 0.0 && fifo_fill < Libburn_autotune_low_filL &&
+	     drive_fill >= 0.0 && drive_fill < Libburn_buf_poll_low_filL) ||
+	    (fifo_fill < 0.0 && drive_fill >= 0.0 &&
+	     drive_fill < Libburn_autotune_low_filL)) {
+		/* The input does not keep up. Go to the largest speed which
+		   the measured input rate can sustain with some reserve.
+		*/
+		target = p->current - 1;
+		if (rate > 0.0) {
+			for (i = target; i > 0; i--)
+				if (p->speeds[i] * 1000.0 <= 0.9 * rate)
+			break;
+			target = i;
+		}
+		if (target < 0)
+			target = 0;
+	} else if ((fifo_fill >= 0.0 &&
+		    fifo_fill > Libburn_autotune_high_filL) ||
+		   (fifo_fill < 0.0 && waited > 0)) {
+		/* The drive is the bottleneck */
+		target = p->current + 1;
+		if (target >= p->num_speeds)
+			target = p->num_speeds - 1;
+	}
+	if (target == p->current)
+		return 0;
+
+	sprintf(msg,
+	     "Write speed changed by autotuning from %dk to %dk (fifo %.f%% , drive buffer %.f%%)",
+		p->speeds[p->current], p->speeds[target],
+		fifo_fill >= 0.0 ? fifo_fill * 100.0 : -1.0,
+		drive_fill >= 0.0 ? drive_fill * 100.0 : -1.0);
+	sose_mem = d->silent_on_scsi_error;
+	d->silent_on_scsi_error = 3;
+	d->set_speed(d, 0, p->speeds[target]);
+	d->silent_on_scsi_error = sose_mem;
+	libdax_msgs_submit(libdax_messenger, d->global_index, 0x000201b5,
+			   LIBDAX_MSGS_SEV_NOTE, LIBDAX_MSGS_PRIO_HIGH,
+			   msg, 0, 0);
+	p->current = target;
+	p->last_waited_usec = d->waited_usec;
+	p->next_time = now + Libburn_autotune_settlE * p->interval;
 	return 1;
 }
 
@@ -1110,8 +1491,9 @@ int burn_write_track(struct burn_write_opts *o, struct burn_session *s,
 	struct burn_track *t = s->track[tnum];
 	struct burn_drive *d = o->drive;
 	int i, tmp = 0, open_ended = 0, ret= 0, nwa, lba;
-	int sectors;
+	int sectors, batch, produced;
 	char msg[160];
+	struct burn_buf_poll buf_poll;
 
 	d->rlba = -150;
 
@@ -1211,25 +1593,33 @@ int burn_write_track(struct burn_write_opts *o, struct burn_session *s,
 	if (tnum == s->tracks)
 		tmp = sectors > 150 ? 150 : sectors;
 
-	for (i = 0; open_ended || i < sectors - tmp; i++) {
+	/* ts C61019 : 64 sectors was the fixed inquiry distance before */
+	burn_buf_poll_init(&buf_poll, d,
+			   (off_t) 64 * burn_sector_length(t->mode), 0);
+
+	for (i = 0; open_ended || i < sectors - tmp; ) {
 
 		/* ts A61023 : http://libburn.pykix.org/ticket/14
                                From time to time inquire drive buffer */
-		if ((i%64)==0)
-			d->read_buffer_capacity(d);
+		burn_buf_poll(&buf_poll, d, 0);
 
-		if (!sector_data(o, t, 0))
+		/* ts C61019 : Produce as many sectors as fit into the buffer */
+		batch = 64;
+		if (!open_ended && batch > sectors - tmp - i)
+			batch = sectors - tmp - i;
+		ret = sector_data_batch(o, t, batch, &produced, 0);
+		if (ret <= 0)
 			{ ret = 0; goto ex; }
+		i += produced;
+
+		/* update current progress */
+		d->progress.sector += produced;
 
 		/* ts A61031 */
-		if (open_ended) {
+		if (open_ended)
 			d->progress.sectors = sectors = i;
-                        if (burn_track_is_data_done(t)) 
+		if (ret == 2)
 	break;
-		}
-
-		/* update current progress */
-		d->progress.sector++;
 	}
 	for (; i < sectors; i++) {
 
@@ -1238,8 +1628,7 @@ int burn_write_track(struct burn_write_opts *o, struct burn_session *s,
 			tnum, s->tracks, tmp);
 
 		/* ts A61023 */
-		if ((i%64)==0)
-			d->read_buffer_capacity(d);
+		burn_buf_poll(&buf_poll, d, 0);
 
 		if (!sector_data(o, t, 1))
 			{ ret = 0; goto ex; }
@@ -1422,7 +1811,8 @@ int burn_precheck_write(struct burn_write_opts *o, struct burn_disc *disc,
 	enum burn_write_types wt;
 	struct burn_drive *d = o->drive;
 	char *msg = NULL, *reason_pt;
-	int no_media = 0, ret, has_cdtext, is_bd_pow = 0;
+	int no_media = 0, ret, has_cdtext, is_bd_pow = 0, overwritable = 0;
+	off_t start_byte;
 
 	reason_pt= reasons;
 	reasons[0] = 0;
@@ -1472,12 +1862,15 @@ int burn_precheck_write(struct burn_write_opts *o, struct burn_disc *disc,
 		if (o->start_byte >= 0 && (o->start_byte % 2048))
 			strcat(reasons,
 			 "write start address not properly aligned to 2048, ");
+		overwritable = 1;
 	} else if (d->current_profile == 0x09 || d->current_profile == 0x0a) {
 		/* CD-R , CD-RW */
 		if (!burn_disc_write_is_ok(o, disc, (!!silent) << 1))
 			strcat(reasons, "unsuitable track mode found, ");
 		if (o->start_byte >= 0)
 			strcat(reasons, "write start address not supported, ");
+		if (o->iso_head != NULL)
+			strcat(reasons, "ISO 9660 head update not supported, ");
 		if (o->num_text_packs > 0) {
 			if (o->write_type != BURN_WRITE_SAO)
 				strcat(reasons,
@@ -1491,6 +1884,7 @@ int burn_precheck_write(struct burn_write_opts *o, struct burn_disc *disc,
 		if (o->start_byte >= 0 && (o->start_byte % 32768))
 			strcat(reasons,
 			  "write start address not properly aligned to 32k, ");
+		overwritable = 1;
 	} else if (d->drive_role == 3 ||
 		   d->current_profile == 0x11 || d->current_profile == 0x14 ||
 	           d->current_profile == 0x15 ||
@@ -1500,6 +1894,8 @@ int burn_precheck_write(struct burn_write_opts *o, struct burn_disc *disc,
 		   sequential stdio "drive" */
 		if (o->start_byte >= 0)
 			strcat(reasons, "write start address not supported, ");
+		if (o->iso_head != NULL)
+			strcat(reasons, "ISO 9660 head update not supported, ");
 
 		is_bd_pow = burn_drive_get_bd_r_pow(d);
 		if (is_bd_pow && !silent) 
@@ -1531,6 +1927,16 @@ unsuitable_profile:;
 		strcat(reasons, "no suitable media profile detected, ");
 		return 0;
 	}
+	if (overwritable) {
+		/* ts C61019 */
+		start_byte = o->start_byte;
+		if (start_byte < 0 && d->drive_role == 5 &&
+		    d->status == BURN_DISC_APPENDABLE)
+			start_byte = d->role_5_nwa * 2048;
+		if (o->iso_head != NULL && start_byte < Libburn_iso_head_sizE)
+			strcat(reasons,
+			    "ISO 9660 head would overlap the written data, ");
+	}
 ex:;
 	if (reason_pt[0]) {
 		if (no_media) {
@@ -1693,6 +2099,7 @@ int burn_disc_close_track_dvd_minus_r(struct burn_write_opts *o, int tnum)
 			LIBDAX_MSGS_SEV_DEBUG, LIBDAX_MSGS_PRIO_HIGH, msg,0,0);
 
 	d->busy = BURN_DRIVE_CLOSING_SESSION;
+	burn_drive_events_check(d, 0); /* ts C61019 */
 	/* Ignoring tnum here and hoping that d->last_track_no is correct */
 	d->close_track_session(d, 0, d->last_track_no); /* CLOSE TRACK, 001b */
 	d->busy = BURN_DRIVE_WRITING;
@@ -1747,6 +2154,7 @@ int burn_disc_close_track_dvd_plus_r(struct burn_write_opts *o,
 			LIBDAX_MSGS_SEV_DEBUG, LIBDAX_MSGS_PRIO_HIGH, msg,0,0);
 
 	d->busy = BURN_DRIVE_CLOSING_SESSION;
+	burn_drive_events_check(d, 0); /* ts C61019 */
 	d->close_track_session(d, 0, d->last_track_no); /* CLOSE TRACK, 001b */
 
 	/* Each session becomes a single logical track. So to distinguish them,
@@ -1882,6 +2290,7 @@ static int transact_dvd_chunk(struct burn_write_opts *opts,
 	d->nwa += out->sectors;
 	out->bytes = 0;
 	out->sectors = 0;
+	burn_drive_events_check(d, 0); /* ts C61019 */
 
 	return 1;
 }
@@ -1898,7 +2307,9 @@ int burn_dvd_write_track(struct burn_write_opts *o,
 	struct buffer *out = d->buffer;
 	int sectors;
 	int i, open_ended = 0, ret= 0, is_flushed = 0, track_open = 0;
-	int first_buf_cap = 0, further_cap = 0, buf_cap_step = 1024;
+	int buf_poll_quirks = 0;
+	struct burn_buf_poll buf_poll;
+	struct burn_speed_tune speed_tune;
 
 	/* ts A70213 : eventually expand size of track to max */
 	burn_track_apply_fillup(t, d->media_capacity_remaining, 0);
@@ -1912,8 +2323,7 @@ int burn_dvd_write_track(struct burn_write_opts *o,
 		/* Pioneer DVR-216D rev 1.09 hates multiple buffer inquiries
 		   before the drive buffer is full.
 		*/
-		first_buf_cap = 0;
-		further_cap = -1;
+		buf_poll_quirks = 1;
 	} else if (d->current_profile == 0x1b || d->current_profile == 0x2b) {
 		/* DVD+R , DVD+R/DL */
 		ret = burn_disc_open_track_dvd_plus_r(o, s, tnum);
@@ -1933,20 +2343,18 @@ int burn_dvd_write_track(struct burn_write_opts *o,
 	/* (offset padding is done within sector_data()) */
 
 	burn_disc_init_track_status(o, s, t, tnum, sectors);
+	burn_buf_poll_init(&buf_poll, d, (off_t) 1024 * 2048,
+			   buf_poll_quirks);
+	burn_speed_tune_init(&speed_tune, o, t, 0);
 	for (i = 0; open_ended || i < sectors; i++) {
 
 		/* From time to time inquire drive buffer */
 		/* ts A91110: Eventually avoid to do this more than once
 		              before the drive buffer is full. See above DVD-
 		*/
-		if (i == first_buf_cap ||
-		   ((i % buf_cap_step) == 0 &&
-		    (i >= further_cap || further_cap < 0))) {
-			d->read_buffer_capacity(d);
-			if (further_cap < 0)
-				further_cap =
-			 	    d->progress.buffer_capacity / 2048 + 128;
-		}
+		/* ts C61019 : the fresh fill may change the write speed */
+		if (burn_buf_poll(&buf_poll, d, 0) > 0)
+			burn_speed_tune_check(&speed_tune, d, 0);
 
 #ifdef Libburn_simplified_dvd_chunk_transactioN
 
@@ -1979,9 +2387,20 @@ int burn_dvd_write_track(struct burn_write_opts *o,
 		out->sectors += (o->obs - out->bytes) / 2048;
 		out->bytes = o->obs;
 	}
-	ret = burn_write_flush(o, t);
-	if (ret <= 0)
-		goto ex;
+	if (is_last_track && o->iso_head != NULL) {
+		/* ts C61019 : one sync for the track and the ISO head */
+		ret = burn_write_flush_buffer(o, t);
+		if (ret <= 0)
+			goto ex;
+		ret = burn_write_iso_head(o, 0);
+		if (ret <= 0)
+			goto ex;
+		d->sync_cache(d);
+	} else {
+		ret = burn_write_flush(o, t);
+		if (ret <= 0)
+			goto ex;
+	}
 	is_flushed = 1;
 
 	/* Eventually finalize track */
@@ -2021,6 +2440,7 @@ int burn_disc_close_session_dvd_plus_rw(struct burn_write_opts *o,
 	struct burn_drive *d = o->drive;
 
 	d->busy = BURN_DRIVE_CLOSING_SESSION;
+	burn_drive_events_check(d, 0); /* ts C61019 */
 	/* This seems to be a quick end : "if (!dvd_compat)" */
 	/* >>> Stop de-icing (ongoing background format) quickly
 	       by mmc_close() (but with opcode[2]=0).
@@ -2041,6 +2461,7 @@ int burn_disc_close_session_dvd_minus_rw(struct burn_write_opts *o,
 	struct burn_drive *d = o->drive;
 
 	d->busy = BURN_DRIVE_CLOSING_SESSION;
+	burn_drive_events_check(d, 0); /* ts C61019 */
 	if (d->current_profile == 0x13) {
 		d->close_track_session(d, 1, 0); /* CLOSE SESSION, 010b */
 
@@ -2072,6 +2493,7 @@ int burn_disc_close_session_dvd_minus_r(struct burn_write_opts *o)
 			"Closing session", 0, 0);
 
 	d->busy = BURN_DRIVE_CLOSING_SESSION;
+	burn_drive_events_check(d, 0); /* ts C61019 */
 	d->close_track_session(d, 1, 0); /* CLOSE SESSION, 010b */
 	d->busy = BURN_DRIVE_WRITING;
 	return 1;
@@ -2596,18 +3018,25 @@ int burn_stdio_read_source(struct burn_source *source, char *buf, int bufsize,
 }
 
 
-/* ts A70904 */
-int burn_stdio_write(int fd, char *buf, int count, struct burn_drive *d, 
-			 int flag)
+/* ts A70904 , C61019 : Also tells how many bytes were written even if the
+                        write run failed.
+*/
+static int burn_stdio_write_done(int fd, char *buf, int count,
+				 struct burn_drive *d, int *done_count,
+				 int flag)
 {
 	int ret = 0;
 	char *msg = NULL;
 	int todo, done, retries;
 
+	*done_count = 0;
+
 	if (d->cancel || count <= 0)
 		return 0;
-	if(d->do_simulate)
+	if(d->do_simulate) {
+		*done_count = count;
 		return 1;
+	}
 
 	todo = count;
 	done = 0;
@@ -2623,6 +3052,7 @@ fprintf(stderr, "libburn_DEBUG: write(%d, %lX, %d)\n",
 		done += ret;
 		todo -= ret;
 	}
+	*done_count = done;
 	if (done != count) {
 		BURN_ALLOC_MEM(msg, char, 160);
 
@@ -2645,6 +3075,16 @@ ex:;
 }
 
 
+/* ts A70904 */
+int burn_stdio_write(int fd, char *buf, int count, struct burn_drive *d, 
+			 int flag)
+{
+	int done;
+
+	return burn_stdio_write_done(fd, buf, count, d, &done, flag);
+}
+
+
 /* ts A70910 : to be used as burn_drive.write(), emulating mmc_write() */
 int burn_stdio_mmc_write(struct burn_drive *d, int start, struct buffer *buf)
 {
@@ -2797,7 +3237,7 @@ int burn_stdio_write_track(struct burn_write_opts *o, struct burn_session *s,
 	struct burn_track *t = s->track[tnum];
 	struct burn_drive *d = o->drive;
 	char *buf = NULL;
-	int i, prev_sync_sector = 0;
+	int i, prev_sync_sector = 0, batch, produced;
 	struct buffer *out = d->buffer;
 	struct timeval prev_time;
 
@@ -2818,17 +3258,21 @@ int burn_stdio_write_track(struct burn_write_opts *o, struct burn_session *s,
 	d->sync_cache = burn_stdio_mmc_sync_cache;
 
 	burn_stdio_slowdown(d, &prev_time, 0, 1); /* initialize */
-	for (i = 0; open_ended || i < sectors; i++) {
-		/* transact a (CD sized) sector */
-		if (!sector_data(o, t, 0))
+	for (i = 0; open_ended || i < sectors; ) {
+		/* transact a batch of (CD sized) sectors which ends at the
+		   next 512 sector step of burn_stdio_slowdown() */
+		batch = 512 - (d->progress.sector % 512);
+		if (!open_ended && batch > sectors - i)
+			batch = sectors - i;
+		ret = sector_data_batch(o, t, batch, &produced, 0);
+		if (ret <= 0)
 			{ret= 0; goto ex;}
+		i += produced;
+		d->progress.sector += produced;
 		if (open_ended)
 			d->progress.sectors = sectors = d->progress.sector;
-		if (open_ended || t->end_on_premature_eoi) {
-			if (burn_track_is_data_done(t))
+		if (ret == 2)
 	break;
-		}
-		d->progress.sector++;
 		/* Flush to disk from time to time */
 		if (d->progress.sector - prev_sync_sector >=
 		    o->stdio_fsync_size && o->stdio_fsync_size > 0) {
@@ -2838,6 +3282,7 @@ int burn_stdio_write_track(struct burn_write_opts *o, struct burn_session *s,
 		}
 		if ((d->progress.sector % 512) == 0) 
 			burn_stdio_slowdown(d, &prev_time, 512 * 2, 0);
+		burn_drive_events_check(d, 0); /* ts C61019 */
 	}
 
 	/* Pad up buffer to next full o->obs (usually 32 kB) */
@@ -2846,7 +3291,22 @@ int burn_stdio_write_track(struct burn_write_opts *o, struct burn_session *s,
 		out->sectors += (o->obs - out->bytes) / 2048;
 		out->bytes = o->obs;
 	}
-	ret = burn_write_flush(o, t);
+	if (o->iso_head != NULL) {
+		/* ts C61019 : one sync for the track and the ISO head.
+		   No head after a failed flush or a premature end of input,
+		   because then the track counts as cancelled.
+		*/
+		ret = burn_write_flush_buffer(o, t);
+		if (ret > 0 && t->end_on_premature_eoi != 2)
+			ret = burn_write_iso_head(o, 0);
+		else
+			ret = 1;
+		d->sync_cache(d);
+		if (ret <= 0)
+			goto ex;
+	} else {
+		ret = burn_write_flush(o, t);
+	}
 	ret= 1;
 ex:;
 	if (d->cancel)
@@ -2926,7 +3386,7 @@ void burn_disc_write_sync(struct burn_write_opts *o, struct burn_disc *disc)
 	struct burn_session *s;
 	struct burn_track *lt, *t;
 	int first = 1, i, ret, lba, nwa = 0, multi_mem;
-	off_t default_size;
+	off_t default_size, start_byte;
 	char msg[80];
 
 
@@ -2983,6 +3443,16 @@ calloc() seems not to have the desired effect. valgrind warns:
 			0, 0);
 		goto fail_wo_sync;
 	}
+	/* ts C61019 : The cached ISO 9660 head might get overwritten.
+	               Appending to a role 5 drive leaves it alone.
+	*/
+	start_byte = o->start_byte;
+	if (start_byte < 0 && d->drive_role == 5 &&
+	    d->status == BURN_DISC_APPENDABLE)
+		start_byte = d->role_5_nwa * 2048;
+	if (start_byte < Libburn_iso_head_sizE)
+		d->iso_head_valid = 0;
+
 	/* ts A70904 */
 	if (d->drive_role != 1) {
 		ret = burn_stdio_write_sync(o, disc);
@@ -3184,6 +3654,8 @@ fail_wo_sync:;
 	d->cancel = 1;
 	/* <<< d->busy = BURN_DRIVE_IDLE; */
 ex:;
+	if (d->cancel)
+		d->iso_head_valid = 0; /* ts C61019 : head state is unknown */
 	d->do_stream_recording = 0;
 	if (d->buffer != NULL)
 		burn_os_free_buffer((char *) d->buffer,
@@ -3201,7 +3673,8 @@ int burn_random_access_write(struct burn_drive *d, off_t byte_address,
 				char *data, off_t data_count, int flag)
 {
 	int alignment = 0, start, upto, chunksize, err, fd = -1, ret;
-	int do_close = 0, getfl_ret;
+	int do_close = 0, getfl_ret, max_chunk, piece, piece_done;
+	off_t done;
 	char msg[81], *rpt;
 	struct buffer *buf = NULL, *buffer_mem = d->buffer;
 
@@ -3274,6 +3747,9 @@ int burn_random_access_write(struct burn_drive *d, off_t byte_address,
 			"Drive is busy on attempt to write random access",0,0);
 		{ret = 0; goto ex;}
 	}
+	/* ts C61019 */
+	if (byte_address < Libburn_iso_head_sizE && data_count > 0)
+		d->iso_head_valid = 0;
 	if (d->drive_role != 1) {
 		if (d->stdio_fd >= 0) {
 			/* Avoid to have a read-only fd open */
@@ -3298,13 +3774,54 @@ int burn_random_access_write(struct burn_drive *d, off_t byte_address,
 	d->busy = BURN_DRIVE_WRITING_SYNC;
 	d->buffer = buf;
 
+	if (d->drive_role != 1) {
+		/* ts C61019 : Large write(2) calls directly from caller
+		   memory. Completion is counted exactly down to alignment.
+		*/
+		if (!do_close && !d->do_simulate) {
+			/* A reused fd is not necessarily at byte_address */
+			if (lseek(fd, byte_address, SEEK_SET) == -1) {
+				sprintf(msg, "Cannot address start byte %.f",
+					(double) byte_address);
+				libdax_msgs_submit(libdax_messenger,
+					d->global_index, 0x00020147,
+					LIBDAX_MSGS_SEV_SORRY,
+					LIBDAX_MSGS_PRIO_HIGH, msg, errno, 0);
+				d->busy = BURN_DRIVE_IDLE;
+				{ret = 0; goto ex;}
+			}
+		}
+		for (done = 0; done < data_count; done += piece) {
+			piece = Libburn_stdio_ra_chunK;
+			if (piece > data_count - done)
+				piece = data_count - done;
+			d->nwa = (byte_address + done) / 2048;
+			ret = burn_stdio_write_done(fd, data + done, piece, d,
+							&piece_done, 0);
+			if (ret <= 0) {
+				done += piece_done - (piece_done % alignment);
+				d->busy = BURN_DRIVE_IDLE;
+				if(fd >= 0 && do_close)
+					close(fd);
+				{ret = -done; goto ex;}
+			}
+		}
+		goto write_done;
+	}
+
+	/* The largest transaction which the transport allows and which is
+	   a multiple of the alignment demanded by the profile
+	*/
+	max_chunk = (BUFFER_SIZE / alignment) * alignment / 2048;
+	if (max_chunk < 16)
+		max_chunk = 16;
 	start = byte_address / 2048;
 	upto = start + data_count / 2048;
 	rpt = data;
-	for (; start < upto; start += 16) {
+	for (; start < upto; start += chunksize) {
 		chunksize = upto - start;
-		if (chunksize > 16)
-			chunksize = 16;
+		if (chunksize > max_chunk)
+			chunksize = max_chunk;
 		d->buffer->bytes = chunksize * 2048;
 		memcpy(d->buffer->data, rpt, d->buffer->bytes);
 		rpt += d->buffer->bytes;
@@ -3329,6 +3846,7 @@ int burn_random_access_write(struct burn_drive *d, off_t byte_address,
 		}
 	}
 
+write_done:;
 	if(d->drive_role == 1)
 		d->needs_sync_cache = 1;
 	if(flag & 1) {
@@ -3343,10 +3861,11 @@ int burn_random_access_write(struct burn_drive *d, off_t byte_address,
 		
 	if(fd >= 0 && do_close)
 		close(fd);
-	d->buffer = buffer_mem;
 	d->busy = BURN_DRIVE_IDLE;
 	ret = 1;
 ex:
+	/* ts C61019 : buf is freed now. So d->buffer may not point to it. */
+	d->buffer = buffer_mem;
 	BURN_FREE_MEM(buf);
 	return ret;
 }
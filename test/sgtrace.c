@@ -0,0 +1,78 @@
+/* -*- indent-tabs-mode: t; tab-width: 8; c-basic-offset: 8; -*- */
+
+/* Copyright (c) 2026 Thomas Schmitt <scdbackup@gmx.net>
+   Provided under GPL version 2 or later.
+
+   Evaluation of the binary SCSI trace which libburn records if
+   burn_set_scsi_logging() is called with bit3 set.
+
+     test/sgtrace -text  [trace_file]
+       prints the trace in the text format of burn_set_scsi_logging() bit0.
+
+     test/sgtrace -replay [-speed factor] [trace_file]
+       replays the recorded WRITE commands against an emulated drive buffer
+       which drains at the recorded write speed, multiplied by factor.
+       It reports buffer underruns and discontinuities of write addresses.
+
+   The default trace_file is /tmp/libburn_sg_command_trace .
+*/
+
+#include "libburn/libburn.h"
+#include "libburn/scsitrace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+static void usage(char *progname)
+{
+	fprintf(stderr,
+	  "usage: %s -text|-replay [-speed factor] [trace_file]\n", progname);
+}
+
+
+int main(int argc, char **argv)
+{
+	int i, ret, do_replay = -1;
+	char *path = Libburn_scsi_trace_filE;
+	double speed_factor = 1.0;
+	FILE *fp;
+
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-text") == 0) {
+			do_replay = 0;
+		} else if (strcmp(argv[i], "-replay") == 0) {
+			do_replay = 1;
+		} else if (strcmp(argv[i], "-speed") == 0 && i + 1 < argc) {
+			speed_factor = atof(argv[++i]);
+		} else if (argv[i][0] != '-') {
+			path = argv[i];
+		} else {
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	if (do_replay < 0) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	fp = fopen(path, "rb");
+	if (fp == NULL) {
+		fprintf(stderr, "Cannot open trace file '%s'\n", path);
+		return 2;
+	}
+	if (do_replay)
+		ret = burn_scsi_trace_replay(fp, stdout, speed_factor, 0);
+	else
+		ret = burn_scsi_trace_decode(fp, stdout, 0);
+	fclose(fp);
+	if (ret < 0) {
+		fprintf(stderr, "Damaged or unsuitable trace file '%s'\n", path);
+		return 3;
+	}
+	if (do_replay && ret == 0)
+		return 4;
+	return 0;
+}